@@ -0,0 +1,114 @@
+// Measures the throughput of ConcurrentBPlusTree against a BPlusTree behind a reader-writer lock, for growing thread counts.
+//
+// Build with optimizations, e.g.
+//     g++ -std=c++20 -O2 -march=native -pthread bench/ConcurrentBench.cpp -o concurrent_bench
+// and run as
+//     ./concurrent_bench [number of keys] [percentage of lookups] [operations per thread]
+//
+// Every thread runs the same mix of lookups, inserts and erases over uniformly random keys, on a tree preloaded with
+// half of them. The locked tree lets readers in together, so the gap on read-only mixes comes from the lock word every
+// reader writes to, while optimistic readers write to nothing.
+
+#include "../src/BPlusTree.hpp"
+#include "../src/ConcurrentBPlusTree.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+namespace{
+    constexpr std::size_t N = 32;
+
+    struct LockedTree{
+        csaur::BPlusTree<std::uint64_t, std::uint64_t, N> tree;
+        mutable std::shared_mutex mutex;
+
+        bool get(std::uint64_t key) const{
+            std::shared_lock lock(mutex);
+            return tree.contains(key);
+        }
+        void insert(std::uint64_t key){
+            std::unique_lock lock(mutex);
+            tree.insert(std::uint64_t(key), std::uint64_t(key));
+        }
+        void erase(std::uint64_t key){
+            std::unique_lock lock(mutex);
+            tree.erase(key);
+        }
+    };
+
+    struct OptimisticTree{
+        csaur::ConcurrentBPlusTree<std::uint64_t, std::uint64_t, N> tree;
+
+        bool get(std::uint64_t key) const{
+            return tree.get(key).has_value();
+        }
+        void insert(std::uint64_t key){
+            tree.insert(std::uint64_t(key), std::uint64_t(key));
+        }
+        void erase(std::uint64_t key){
+            tree.erase(key);
+        }
+    };
+
+    template<class Tree>
+    double mops(unsigned threads, std::uint64_t count, unsigned lookups, std::uint64_t operations){
+        // preloaded in a shuffled order, since BPlusTree packs leaves full when keys come in ascending order
+        std::vector<std::uint64_t> preload(count / 2);
+        std::iota(preload.begin(), preload.end(), 0);
+        std::shuffle(preload.begin(), preload.end(), std::mt19937_64(42));
+        Tree tree;
+        for (std::uint64_t half : preload){
+            tree.insert(2 * half);
+        }
+        std::vector<std::thread> pool;
+        std::vector<std::uint64_t> found(threads);
+        auto begin = std::chrono::steady_clock::now();
+        for (unsigned t = 0; t < threads; ++t){
+            pool.emplace_back([&, t](){
+                std::mt19937_64 rng(t + 1);
+                std::uint64_t hits = 0;
+                for (std::uint64_t i = 0; i < operations; ++i){
+                    std::uint64_t key = rng() % count;
+                    unsigned dice = rng() % 100;
+                    if (dice < lookups){
+                        hits += tree.get(key);
+                    }
+                    else if (dice % 2 == 0){
+                        tree.insert(key);
+                    }
+                    else{
+                        tree.erase(key);
+                    }
+                }
+                found[t] = hits;
+            });
+        }
+        for (auto& thread : pool){
+            thread.join();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        return double(threads) * double(operations) / seconds / 1e6;
+    }
+}
+
+int main(int argc, char** argv){
+    std::uint64_t count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    unsigned lookups = (argc > 2) ? (unsigned)std::strtoul(argv[2], nullptr, 10) : 90;
+    std::uint64_t operations = (argc > 3) ? std::strtoull(argv[3], nullptr, 10) : 1'000'000;
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("%llu keys, %u%% lookups, %llu operations per thread, %u hardware threads\n",
+                (unsigned long long)count, lookups, (unsigned long long)operations, hardware);
+    for (unsigned threads = 1; threads <= 2 * hardware; threads *= 2){
+        double locked = mops<LockedTree>(threads, count, lookups, operations);
+        double optimistic = mops<OptimisticTree>(threads, count, lookups, operations);
+        std::printf("%3u threads: locked %8.2f Mops/s, optimistic %8.2f Mops/s, speedup %.2fx\n", threads, locked, optimistic, optimistic / locked);
+    }
+    return 0;
+}
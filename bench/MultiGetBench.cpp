@@ -0,0 +1,84 @@
+// Measures the throughput of BPlusTree::multi_get against looking the same keys up one at a time.
+//
+// Build with optimizations, e.g.
+//     g++ -std=c++20 -O2 -march=native bench/MultiGetBench.cpp -o multi_get_bench
+// and run as
+//     ./multi_get_bench [number of keys] [keys per batch]
+//
+// The gain comes from overlapping the cache misses of independent descents, so it only shows on trees that do not
+// fit in the last level cache. Keys are inserted in a shuffled order, so nodes are scattered over the heap.
+
+#include "../src/BPlusTree.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace{
+    template<std::size_t N>
+    using Tree = csaur::BPlusTree<std::uint64_t, std::uint64_t, N>;
+
+    template<std::size_t N>
+    double single_seconds(const Tree<N>& tree, const std::vector<std::uint64_t>& keys, std::uint64_t batch, std::uint64_t& checksum){
+        auto begin = std::chrono::steady_clock::now();
+        for (std::uint64_t first = 0; first + batch <= keys.size(); first += batch){
+            for (std::uint64_t i = first; i < first + batch; ++i){
+                auto found = tree.find(keys[i]);
+                checksum += (found != tree.end()) ? *found : 0;
+            }
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    template<std::size_t N>
+    double batched_seconds(const Tree<N>& tree, const std::vector<std::uint64_t>& keys, std::uint64_t batch, std::uint64_t& checksum){
+        std::vector<const std::uint64_t*> results(batch);
+        auto begin = std::chrono::steady_clock::now();
+        for (std::uint64_t first = 0; first + batch <= keys.size(); first += batch){
+            tree.multi_get(std::span(keys).subspan(first, batch), results);
+            for (const std::uint64_t* result : results){
+                checksum += (result != nullptr) ? *result : 0;
+            }
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    template<std::size_t N>
+    void run(std::uint64_t count, std::uint64_t batch){
+        std::vector<std::uint64_t> keys(count);
+        std::iota(keys.begin(), keys.end(), 0);
+        std::mt19937_64 rng(42);
+        std::shuffle(keys.begin(), keys.end(), rng);
+
+        Tree<N> tree;
+        for (std::uint64_t key : keys){
+            tree.insert(2 * key, key);          // half of the looked up keys are missing
+        }
+
+        std::vector<std::uint64_t> lookups(std::max<std::uint64_t>(batch, 2'000'000 / batch * batch));
+        for (auto& key : lookups){
+            key = rng() % (2 * count);
+        }
+
+        std::uint64_t checksum = 0;
+        batched_seconds<N>(tree, lookups, batch, checksum);      // warm-up
+        double single = single_seconds<N>(tree, lookups, batch, checksum);
+        double batched = batched_seconds<N>(tree, lookups, batch, checksum);
+        std::printf("N = %3zu: one at a time %7.2f Mlookups/s, multi_get %7.2f Mlookups/s, speedup %.2fx (checksum %llu)\n",
+                    N, lookups.size() / single / 1e6, lookups.size() / batched / 1e6, single / batched, (unsigned long long)checksum);
+    }
+}
+
+int main(int argc, char** argv){
+    std::uint64_t count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 8'000'000;
+    std::uint64_t batch = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 256;
+    std::printf("%llu keys, %llu keys per batch\n", (unsigned long long)count, (unsigned long long)batch);
+    run<8>(count, batch);
+    run<16>(count, batch);
+    run<32>(count, batch);
+    run<64>(count, batch);
+    return 0;
+}
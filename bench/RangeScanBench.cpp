@@ -0,0 +1,80 @@
+// Measures the throughput of BPlusTree::for_each_in_range with and without leaf look-ahead prefetching.
+//
+// Build with optimizations, e.g.
+//     g++ -std=c++20 -O2 -march=native bench/RangeScanBench.cpp -o range_scan_bench
+// and run as
+//     ./range_scan_bench [number of keys] [keys per scan]
+//
+// Keys are inserted in a shuffled order, so leaves (and the values they point to) are scattered over the heap
+// the way they are after a real workload, and each hop along the leaf chain is likely a cache miss.
+
+#include "../src/BPlusTree.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace{
+    template<std::size_t size>
+    struct Record{             // records of more than 32 bytes are not stored inline, so leaves hold pointers to them
+        std::uint64_t fields[size / sizeof(std::uint64_t)];
+    };
+
+    template<class Value, std::size_t N>
+    using Tree = csaur::BPlusTree<std::uint64_t, Value, N>;
+
+    template<bool Prefetch, class Value, std::size_t N>
+    double scan_seconds(const Tree<Value, N>& tree, const std::vector<std::uint64_t>& starts, std::uint64_t length, std::uint64_t& checksum){
+        auto begin = std::chrono::steady_clock::now();
+        for (std::uint64_t start : starts){
+            tree.template for_each_in_range<Prefetch>(start, start + length, [&](const std::uint64_t& key, const Value& record){
+                checksum += key + record.fields[0];
+            });
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+    template<class Value, std::size_t N>
+    void run(std::uint64_t count, std::uint64_t length){
+        std::vector<std::uint64_t> keys(count);
+        std::iota(keys.begin(), keys.end(), 0);
+        std::mt19937_64 rng(42);
+        std::shuffle(keys.begin(), keys.end(), rng);
+
+        Tree<Value, N> tree;
+        for (std::uint64_t key : keys){
+            Value record{};
+            record.fields[0] = key;
+            tree.insert(key, record);
+        }
+
+        std::vector<std::uint64_t> starts(std::max<std::uint64_t>(1, 4 * count / length));
+        for (auto& start : starts){
+            start = rng() % count;
+        }
+
+        std::uint64_t checksum = 0;
+        scan_seconds<true, Value, N>(tree, starts, length, checksum);      // warm-up
+        double without = scan_seconds<false, Value, N>(tree, starts, length, checksum);
+        double with = scan_seconds<true, Value, N>(tree, starts, length, checksum);
+        double visited = double(starts.size()) * double(length);
+        std::printf("%2zu byte values%s, N = %3zu: no prefetch %8.2f Mkeys/s, prefetch %8.2f Mkeys/s, speedup %.2fx (checksum %llu)\n",
+                    sizeof(Value), Tree<Value, N>::leaf_type::stores_inline ? " (inline)" : "", N, visited / without / 1e6, visited / with / 1e6, without / with, (unsigned long long)checksum);
+    }
+}
+
+int main(int argc, char** argv){
+    std::uint64_t count = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 4'000'000;
+    std::uint64_t length = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 10'000;
+    std::printf("%llu keys, %llu keys per scan\n", (unsigned long long)count, (unsigned long long)length);
+    run<Record<16>, 8>(count, length);
+    run<Record<16>, 16>(count, length);
+    run<Record<16>, 64>(count, length);
+    run<Record<48>, 8>(count, length);
+    run<Record<48>, 16>(count, length);
+    run<Record<48>, 64>(count, length);
+    return 0;
+}
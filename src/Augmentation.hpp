@@ -0,0 +1,135 @@
+#ifndef AUGMENTATION_HEADER_DEFINED
+#define AUGMENTATION_HEADER_DEFINED
+
+#include <cstddef>
+#include <limits>
+
+namespace csaur{
+    //////////////////////////////////////////////////////////////////////////////////
+    //                           Subtree Augmentations                              //
+    //////////////////////////////////////////////////////////////////////////////////
+    //
+    // An augmentation makes every internal node keep a summary of the subtree under each of its subnodes, so that
+    // queries over a key range can combine O(log n) summaries instead of visiting every entry in the range.
+    // Each augmentation provides:
+    // * `enabled` - whether summaries are kept at all.
+    // * `reads_values` - whether summaries depend on mapped values. Trees whose summaries do only hand out read-only
+    //   mapped values, so that every change goes through a modifier that refreshes the summaries above it.
+    // * `summary_type` - the summary of a subtree.
+    // * `identity()` - the summary of an empty subtree.
+    // * `lift(key, mapped)` - the summary of a single entry.
+    // * `combine(lower, higher)` - the summary of two adjacent subtrees, where `lower` holds the smaller keys.
+    // * `count(summary)` - the number of entries in a summarized subtree.
+    // * `aggregate_type` and `aggregate(summary)` - what `BPlusTree::aggregate` reports for a summarized range.
+
+    /// @brief The augmentation that keeps nothing. Trees using it pay neither space nor time for summaries.
+    struct NoAugment{
+        static constexpr bool enabled = false;
+        static constexpr bool reads_values = false;
+        struct summary_type{};
+        using aggregate_type = summary_type;
+    };
+
+    /// @brief Keeps the number of entries under every subnode, which lets the tree find the rank of a key,
+    ///        the key of a rank, and the number of keys in a range in O(log n).
+    struct OrderStatistics{
+        static constexpr bool enabled = true;
+        static constexpr bool reads_values = false;
+        using summary_type = std::size_t;
+
+        static summary_type identity(){
+            return 0;
+        }
+
+        template<typename Key, typename Mapped>
+        static summary_type lift(const Key&, const Mapped&){
+            return 1;
+        }
+
+        static summary_type combine(summary_type lower, summary_type higher){
+            return lower + higher;
+        }
+
+        static std::size_t count(summary_type summary){
+            return summary;
+        }
+
+        using aggregate_type = std::size_t;
+
+        static aggregate_type aggregate(summary_type summary){
+            return summary;
+        }
+    };
+
+    /// @brief Keeps the number of entries under every subnode, along with the combination of their mapped values
+    ///        under a monoid, which lets the tree combine the values of any key range in O(log n).
+    /// @tparam Monoid Provides `value_type`, `identity()` and an associative `combine(lower, higher)`, and may provide
+    ///         `lift(mapped)` to turn a mapped value into a `value_type`. Without it, mapped values are converted.
+    /// @note Trees using it only hand out read-only mapped values, through `at`, iterators and `for_each_in_range`.
+    ///       Values are changed through modifiers that refresh the summaries, such as `try_emplace`, `upsert` or `modify`.
+    template<class Monoid>
+    struct MonoidAugment{
+        static constexpr bool enabled = true;
+        static constexpr bool reads_values = true;
+        using aggregate_type = typename Monoid::value_type;
+
+        struct summary_type{
+            std::size_t m_count;
+            aggregate_type m_aggregate;
+
+            bool operator==(const summary_type&) const = default;
+        };
+
+        static summary_type identity(){
+            return {0, Monoid::identity()};
+        }
+
+        template<typename Key, typename Mapped>
+        static summary_type lift(const Key&, const Mapped& mapped){
+            if constexpr(requires { Monoid::lift(mapped); }){
+                return {1, Monoid::lift(mapped)};
+            }
+            else{
+                return {1, aggregate_type(mapped)};
+            }
+        }
+
+        static summary_type combine(const summary_type& lower, const summary_type& higher){
+            return {lower.m_count + higher.m_count, Monoid::combine(lower.m_aggregate, higher.m_aggregate)};
+        }
+
+        static std::size_t count(const summary_type& summary){
+            return summary.m_count;
+        }
+
+        static const aggregate_type& aggregate(const summary_type& summary){
+            return summary.m_aggregate;
+        }
+    };
+
+    /// @brief The monoid of sums, for use with `MonoidAugment`.
+    template<typename T>
+    struct Sum{
+        using value_type = T;
+        static value_type identity(){ return value_type(); }
+        static value_type combine(const value_type& lower, const value_type& higher){ return lower + higher; }
+    };
+
+    /// @brief The monoid of minimums, for use with `MonoidAugment`.
+    template<typename T>
+    struct Min{
+        using value_type = T;
+        static value_type identity(){ return std::numeric_limits<value_type>::max(); }
+        static value_type combine(const value_type& lower, const value_type& higher){ return (higher < lower) ? higher : lower; }
+    };
+
+    /// @brief The monoid of maximums, for use with `MonoidAugment`.
+    template<typename T>
+    struct Max{
+        using value_type = T;
+        static value_type identity(){ return std::numeric_limits<value_type>::lowest(); }
+        static value_type combine(const value_type& lower, const value_type& higher){ return (lower < higher) ? higher : lower; }
+    };
+};
+
+#endif
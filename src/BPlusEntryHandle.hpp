@@ -0,0 +1,154 @@
+#ifndef BPLUS_ENTRY_HANDLE_CLASS_DEFINED
+#define BPLUS_ENTRY_HANDLE_CLASS_DEFINED
+
+#include "BPlusNode.hpp"
+#include <memory>
+#include <utility>
+
+namespace csaur{
+    /// @brief An owning handle to an entry extracted from a BPlusTree, holding its key and its already constructed value.
+    ///        Inserting the handle into a tree links the same value into it, without allocating, copying or destroying it.
+    /// @note A handle that still holds an entry when destroyed destroys its value, and releases its storage through the
+    ///       value allocator of the tree it was extracted from, so it must not outlive that tree while it holds one.
+    /// @tparam Leaf The leaf type of the tree.
+    /// @tparam ValueAlloc The value allocator of the tree.
+    template<class Leaf, class ValueAlloc>
+    class BPlusEntryHandle{
+        template<OrderedKey, Storable, std::size_t, SingleElementAllocator, SingleElementAllocator, SingleElementAllocator, class, class>
+        friend class csaur::BPlusTree;
+    public:
+        using key_type = typename Leaf::key_type;
+        using mapped_type = typename Leaf::mapped_type;
+        using value_allocator = ValueAlloc;
+
+        /// @brief Creates an empty handle.
+        BPlusEntryHandle() noexcept;
+
+        /// @brief Takes the entry of another handle, leaving it empty.
+        BPlusEntryHandle(BPlusEntryHandle&& other) noexcept;
+        BPlusEntryHandle& operator= (BPlusEntryHandle&& other) noexcept;
+
+        BPlusEntryHandle(const BPlusEntryHandle&) = delete;
+        BPlusEntryHandle& operator= (const BPlusEntryHandle&) = delete;
+
+        /// @brief Destroys the held entry, if there is one.
+        ~BPlusEntryHandle();
+
+        /// @brief Checks if the handle holds no entry.
+        bool empty() const noexcept;
+        explicit operator bool() const noexcept;
+
+        /// @brief Returns the key of the held entry. It may be changed before the handle is inserted.
+        /// @note The handle must not be empty.
+        key_type& key();
+        const key_type& key() const;
+
+        /// @brief Returns the value of the held entry.
+        /// @note The handle must not be empty.
+        mapped_type& mapped();
+        const mapped_type& mapped() const;
+    private:
+        using slot_type = typename Leaf::slot_type;
+
+        /// @brief Creates a handle holding an entry taken out of a leaf.
+        BPlusEntryHandle(key_type&& key, slot_type&& slot, value_allocator& alloc) noexcept;
+
+        /// @brief Destroys the held entry, if there is one, and leaves the handle empty.
+        void reset() noexcept;
+
+        key_type m_key;
+        slot_type m_slot;
+        value_allocator* m_alloc; // the allocator the value came from, or nullptr if the handle is empty
+    };
+
+    template <class Leaf, class ValueAlloc>
+    BPlusEntryHandle<Leaf, ValueAlloc>::BPlusEntryHandle() noexcept
+    {
+        m_slot = slot_type();
+        m_alloc = nullptr;
+    }
+
+    template <class Leaf, class ValueAlloc>
+    BPlusEntryHandle<Leaf, ValueAlloc>::BPlusEntryHandle(key_type&& key, slot_type&& slot, value_allocator& alloc) noexcept
+    {
+        m_key = std::move(key);
+        m_slot = std::move(slot);
+        m_alloc = &alloc;
+    }
+
+    template <class Leaf, class ValueAlloc>
+    BPlusEntryHandle<Leaf, ValueAlloc>::BPlusEntryHandle(BPlusEntryHandle&& other) noexcept
+    {
+        m_key = std::move(other.m_key);
+        m_slot = std::move(other.m_slot);
+        m_alloc = std::exchange(other.m_alloc, nullptr);
+    }
+
+    template <class Leaf, class ValueAlloc>
+    BPlusEntryHandle<Leaf, ValueAlloc>& BPlusEntryHandle<Leaf, ValueAlloc>::operator=(BPlusEntryHandle&& other) noexcept
+    {
+        if (this != &other){
+            reset();
+            m_key = std::move(other.m_key);
+            m_slot = std::move(other.m_slot);
+            m_alloc = std::exchange(other.m_alloc, nullptr);
+        }
+        return *this;
+    }
+
+    template <class Leaf, class ValueAlloc>
+    BPlusEntryHandle<Leaf, ValueAlloc>::~BPlusEntryHandle()
+    {
+        reset();
+    }
+
+    template <class Leaf, class ValueAlloc>
+    void BPlusEntryHandle<Leaf, ValueAlloc>::reset() noexcept
+    {
+        if constexpr(!Leaf::stores_inline){   // inline values are trivially copyable, so there is nothing to release
+            if (m_alloc != nullptr){
+                std::destroy_at(m_slot);
+                m_alloc->deallocate(m_slot);
+            }
+        }
+        m_alloc = nullptr;
+    }
+
+    template <class Leaf, class ValueAlloc>
+    bool BPlusEntryHandle<Leaf, ValueAlloc>::empty() const noexcept
+    {
+        return m_alloc == nullptr;
+    }
+
+    template <class Leaf, class ValueAlloc>
+    BPlusEntryHandle<Leaf, ValueAlloc>::operator bool() const noexcept
+    {
+        return m_alloc != nullptr;
+    }
+
+    template <class Leaf, class ValueAlloc>
+    BPlusEntryHandle<Leaf, ValueAlloc>::key_type& BPlusEntryHandle<Leaf, ValueAlloc>::key()
+    {
+        return m_key;
+    }
+
+    template <class Leaf, class ValueAlloc>
+    const BPlusEntryHandle<Leaf, ValueAlloc>::key_type& BPlusEntryHandle<Leaf, ValueAlloc>::key() const
+    {
+        return m_key;
+    }
+
+    template <class Leaf, class ValueAlloc>
+    BPlusEntryHandle<Leaf, ValueAlloc>::mapped_type& BPlusEntryHandle<Leaf, ValueAlloc>::mapped()
+    {
+        return *Leaf::value_address(m_slot);
+    }
+
+    template <class Leaf, class ValueAlloc>
+    const BPlusEntryHandle<Leaf, ValueAlloc>::mapped_type& BPlusEntryHandle<Leaf, ValueAlloc>::mapped() const
+    {
+        return *Leaf::value_address(m_slot);
+    }
+};
+
+#endif
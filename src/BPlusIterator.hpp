@@ -0,0 +1,283 @@
+#ifndef BPLUS_ITERATOR_CLASS_DEFINED
+#define BPLUS_ITERATOR_CLASS_DEFINED
+
+#include "BPlusNode.hpp"
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace csaur{
+    /// @brief A bidirectional iterator over the entries of a BPlusTree, in ascending key order.
+    ///        Walks the linked list of leaves, so moving to the next or previous entry never goes through the root.
+    /// @note Dereferencing yields the mapped value, and `key()` yields its key. Keys are never modifiable through an iterator,
+    ///       and neither are mapped values when the tree's augmentation summarizes them.
+    /// @note Any insertion or erasure invalidates all iterators of the tree.
+    /// @tparam Leaf The leaf type of the tree.
+    /// @tparam is_const Whether the mapped values are read-only through the iterator.
+    template<class Leaf, bool is_const>
+    class BPlusIterator{
+        template<OrderedKey, Storable, std::size_t, SingleElementAllocator, SingleElementAllocator, SingleElementAllocator, class, class>
+        friend class csaur::BPlusTree;
+        friend class BPlusIterator<Leaf, !is_const>;
+        #ifdef DEBUGGING_B_PLUS_TREE
+            friend class ::BPlusTest;
+        #endif
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using key_type = typename Leaf::key_type;
+        using value_type = typename Leaf::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<is_const || Leaf::values_read_only, const value_type*, value_type*>;
+        using reference = std::conditional_t<is_const || Leaf::values_read_only, const value_type&, value_type&>;
+        using size_type = std::size_t;
+
+        /// @brief Creates a singular iterator, which may only be assigned to.
+        BPlusIterator();
+
+        /// @brief Converts a mutable iterator to a read-only one.
+        template<bool other_const> requires (is_const && !other_const)
+        BPlusIterator(const BPlusIterator<Leaf, other_const>& other);
+
+        /// @brief Returns the key of the entry the iterator points to.
+        const key_type& key() const;
+
+        /// @brief Returns the mapped value of the entry the iterator points to.
+        reference operator*() const;
+        pointer operator->() const;
+
+        /// @brief Moves to the entry with the next bigger key.
+        BPlusIterator& operator++();
+        BPlusIterator operator++(int);
+
+        /// @brief Moves to the entry with the next smaller key.
+        BPlusIterator& operator--();
+        BPlusIterator operator--(int);
+
+        template<bool other_const>
+        bool operator==(const BPlusIterator<Leaf, other_const>& other) const;
+    private:
+        using leaf_pointer = std::conditional_t<is_const, const Leaf*, Leaf*>;
+
+        /// @brief Creates an iterator to the entry at `index` in `leaf`. An index past the leaf's last entry
+        ///        is moved to the start of the next leaf, so every position has a single representation.
+        BPlusIterator(leaf_pointer leaf, size_type index);
+
+        leaf_pointer m_leaf;
+        size_type m_index;
+    };
+
+    /// @brief A bidirectional iterator over the entries of a BPlusTree, in descending key order.
+    ///        Like `std::reverse_iterator`, it holds the iterator to the entry after the one it points to.
+    /// @note Dereferencing yields the mapped value, and `key()` yields its key.
+    /// @tparam Iterator The BPlusIterator walked backwards.
+    template<class Iterator>
+    class BPlusReverseIterator{
+        template<class Other>
+        friend class BPlusReverseIterator;
+    public:
+        using iterator_type = Iterator;
+        using iterator_category = typename Iterator::iterator_category;
+        using key_type = typename Iterator::key_type;
+        using value_type = typename Iterator::value_type;
+        using difference_type = typename Iterator::difference_type;
+        using pointer = typename Iterator::pointer;
+        using reference = typename Iterator::reference;
+
+        /// @brief Creates a singular iterator, which may only be assigned to.
+        BPlusReverseIterator() = default;
+
+        /// @brief Creates a reverse iterator to the entry before the one `base` points to.
+        explicit BPlusReverseIterator(Iterator base);
+
+        /// @brief Converts a mutable reverse iterator to a read-only one.
+        template<class Other> requires (!std::is_same_v<Other, Iterator> && std::is_convertible_v<const Other&, Iterator>)
+        BPlusReverseIterator(const BPlusReverseIterator<Other>& other);
+
+        /// @brief Returns the iterator to the entry after the one this points to.
+        Iterator base() const;
+
+        /// @brief Returns the key of the entry the iterator points to.
+        const key_type& key() const;
+
+        /// @brief Returns the mapped value of the entry the iterator points to.
+        reference operator*() const;
+        pointer operator->() const;
+
+        /// @brief Moves to the entry with the next smaller key.
+        BPlusReverseIterator& operator++();
+        BPlusReverseIterator operator++(int);
+
+        /// @brief Moves to the entry with the next bigger key.
+        BPlusReverseIterator& operator--();
+        BPlusReverseIterator operator--(int);
+
+        template<class Other>
+        bool operator==(const BPlusReverseIterator<Other>& other) const;
+    private:
+        Iterator m_base;
+    };
+
+    template <class Leaf, bool is_const>
+    BPlusIterator<Leaf, is_const>::BPlusIterator()
+    {
+        m_leaf = nullptr;
+        m_index = 0;
+    }
+
+    template <class Leaf, bool is_const>
+    template <bool other_const> requires (is_const && !other_const)
+    BPlusIterator<Leaf, is_const>::BPlusIterator(const BPlusIterator<Leaf, other_const>& other)
+    {
+        m_leaf = other.m_leaf;
+        m_index = other.m_index;
+    }
+
+    template <class Leaf, bool is_const>
+    BPlusIterator<Leaf, is_const>::BPlusIterator(leaf_pointer leaf, size_type index)
+    {
+        m_leaf = leaf;
+        m_index = index;
+        if (m_index == m_leaf->m_key_counter && m_leaf->m_next != nullptr){
+            m_leaf = m_leaf->m_next;
+            m_index = 0;
+        }
+    }
+
+    template <class Leaf, bool is_const>
+    const BPlusIterator<Leaf, is_const>::key_type& BPlusIterator<Leaf, is_const>::key() const
+    {
+        return m_leaf->m_keys[m_index];
+    }
+
+    template <class Leaf, bool is_const>
+    BPlusIterator<Leaf, is_const>::reference BPlusIterator<Leaf, is_const>::operator*() const
+    {
+        return *Leaf::value_address(m_leaf->m_data[m_index]);
+    }
+
+    template <class Leaf, bool is_const>
+    BPlusIterator<Leaf, is_const>::pointer BPlusIterator<Leaf, is_const>::operator->() const
+    {
+        return Leaf::value_address(m_leaf->m_data[m_index]);
+    }
+
+    template <class Leaf, bool is_const>
+    BPlusIterator<Leaf, is_const>& BPlusIterator<Leaf, is_const>::operator++()
+    {
+        // the last leaf keeps the past-the-end position, so that end() can be decremented
+        if (++m_index == m_leaf->m_key_counter && m_leaf->m_next != nullptr){
+            m_leaf = m_leaf->m_next;
+            m_index = 0;
+        }
+        return *this;
+    }
+
+    template <class Leaf, bool is_const>
+    BPlusIterator<Leaf, is_const> BPlusIterator<Leaf, is_const>::operator++(int)
+    {
+        BPlusIterator old = *this;
+        ++*this;
+        return old;
+    }
+
+    template <class Leaf, bool is_const>
+    BPlusIterator<Leaf, is_const>& BPlusIterator<Leaf, is_const>::operator--()
+    {
+        if (m_index == 0){
+            m_leaf = m_leaf->m_prev;
+            m_index = m_leaf->m_key_counter;
+        }
+        --m_index;
+        return *this;
+    }
+
+    template <class Leaf, bool is_const>
+    BPlusIterator<Leaf, is_const> BPlusIterator<Leaf, is_const>::operator--(int)
+    {
+        BPlusIterator old = *this;
+        --*this;
+        return old;
+    }
+
+    template <class Leaf, bool is_const>
+    template <bool other_const>
+    bool BPlusIterator<Leaf, is_const>::operator==(const BPlusIterator<Leaf, other_const>& other) const
+    {
+        return m_leaf == other.m_leaf && m_index == other.m_index;
+    }
+    template <class Iterator>
+    BPlusReverseIterator<Iterator>::BPlusReverseIterator(Iterator base)
+    {
+        m_base = base;
+    }
+
+    template <class Iterator>
+    template <class Other> requires (!std::is_same_v<Other, Iterator> && std::is_convertible_v<const Other&, Iterator>)
+    BPlusReverseIterator<Iterator>::BPlusReverseIterator(const BPlusReverseIterator<Other>& other)
+    {
+        m_base = other.m_base;
+    }
+
+    template <class Iterator>
+    Iterator BPlusReverseIterator<Iterator>::base() const
+    {
+        return m_base;
+    }
+
+    template <class Iterator>
+    const BPlusReverseIterator<Iterator>::key_type& BPlusReverseIterator<Iterator>::key() const
+    {
+        return std::prev(m_base).key();
+    }
+
+    template <class Iterator>
+    BPlusReverseIterator<Iterator>::reference BPlusReverseIterator<Iterator>::operator*() const
+    {
+        return *std::prev(m_base);
+    }
+
+    template <class Iterator>
+    BPlusReverseIterator<Iterator>::pointer BPlusReverseIterator<Iterator>::operator->() const
+    {
+        return std::prev(m_base).operator->();
+    }
+
+    template <class Iterator>
+    BPlusReverseIterator<Iterator>& BPlusReverseIterator<Iterator>::operator++()
+    {
+        --m_base;
+        return *this;
+    }
+
+    template <class Iterator>
+    BPlusReverseIterator<Iterator> BPlusReverseIterator<Iterator>::operator++(int)
+    {
+        BPlusReverseIterator old = *this;
+        --m_base;
+        return old;
+    }
+
+    template <class Iterator>
+    BPlusReverseIterator<Iterator>& BPlusReverseIterator<Iterator>::operator--()
+    {
+        ++m_base;
+        return *this;
+    }
+
+    template <class Iterator>
+    BPlusReverseIterator<Iterator> BPlusReverseIterator<Iterator>::operator--(int)
+    {
+        BPlusReverseIterator old = *this;
+        ++m_base;
+        return old;
+    }
+
+    template <class Iterator>
+    template <class Other>
+    bool BPlusReverseIterator<Iterator>::operator==(const BPlusReverseIterator<Other>& other) const
+    {
+        return m_base == other.m_base;
+    }
+};
+
+#endif
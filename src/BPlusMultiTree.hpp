@@ -0,0 +1,405 @@
+#ifndef BPLUS_MULTI_TREE_CLASS_DEFINED
+#define BPLUS_MULTI_TREE_CLASS_DEFINED
+
+#include "BPlusTree.hpp"
+
+namespace csaur{
+    /// @brief A BPlusTree in which a key may have several mapped values. Entries with equal keys are kept in adjacent
+    ///        leaf slots, in insertion order, and a run of them may span several leaves.
+    /// @note Separators stay the smallest key under their subnode, so a run that spans leaves has separators equal
+    ///       to its key. Lookups that need the first entry of a run descend with `first_child_index`, one subnode
+    ///       left of where lookups for unique keys go, and insertions descend as usual to the end of the run.
+    /// @note The nodes, allocators, search policies and augmentations are those of BPlusTree.
+    template<OrderedKey Key,
+             Storable Mapped,
+             std::size_t N,
+             SingleElementAllocator ValueAlloc = DefaultAllocator<Mapped>,
+             SingleElementAllocator LeafAlloc = DefaultAllocator<BPlusLeaf<Key, Mapped, N>>,
+             SingleElementAllocator InternalAlloc = DefaultAllocator<BPlusInternal<Key, Mapped, N>>,
+             class Search = DefaultSearch,
+             class Augment = NoAugment
+            >
+    class BPlusMultiTree{
+    public:
+        using tree_type = BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>;
+        using key_type = Key;
+        using mapped_type = Mapped;
+        using value_type = mapped_type;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using size_type = std::size_t;
+        using iterator = typename tree_type::iterator;
+        using const_iterator = typename tree_type::const_iterator;
+        using reverse_iterator = typename tree_type::reverse_iterator;
+        using const_reverse_iterator = typename tree_type::const_reverse_iterator;
+    private:
+        #ifdef DEBUGGING_B_PLUS_TREE
+            friend class ::BPlusTest;
+        #endif
+
+        tree_type m_tree;
+    public:
+        /// @brief Returns the number of entries in the tree, counting every entry of a repeated key.
+        size_type size() const;
+
+        /// @brief Checks if the tree is empty
+        bool is_empty() const;
+
+        /// @brief Inserts a key and its associated data into the tree, after the entries already there with the same key.
+        /// @return An iterator to the new entry, or end() at failure.
+        /// @note At failure, does not change contents.
+        iterator insert (const key_type&, const mapped_type&);
+        iterator insert (key_type&&, mapped_type&&) noexcept;
+
+        /// @brief Inserts a key and its associated data into the tree, after the entries already there with the same key.
+        /// @param args Arguments used to construct the data associated with the key.
+        /// @return An iterator to the new entry, or end() at failure.
+        /// @note Keys not smaller than every key in the tree are appended without a search.
+        /// @note At failure, does not change contents.
+        template<typename ... Args> requires std::constructible_from<Mapped, Args...>
+        iterator emplace (key_type&&, Args&& ...) noexcept;
+
+        /// @brief Returns the number of entries with the given key.
+        /// @note Time Complexity: O(log n + k / N), where k is the number of entries with the key.
+        size_type count (const key_type&) const;
+
+        /// @brief Returns the range of entries with the given key, in insertion order.
+        std::pair<iterator, iterator> equal_range(const key_type& key);
+        std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const;
+
+        /// @brief Erases every entry with the given key.
+        /// @return The number of erased entries.
+        /// @note Time Complexity: the same as `erase_range`, which releases the leaves a long run fills whole.
+        size_type erase_all_of (const key_type&);
+
+        /// @brief Erases the entries whose keys are in the range [lo, hi).
+        /// @return The number of erased entries.
+        size_type erase_range (const key_type& lo, const key_type& hi);
+
+        /// @brief Erases every entry for which `pred(key, mapped)` returns true.
+        /// @return The number of erased entries.
+        template<class Predicate> requires std::predicate<Predicate&, const key_type&, const mapped_type&>
+        size_type erase_if (Predicate pred);
+
+        /// @brief Erases all entries of the tree.
+        void erase_all();
+
+        /// @brief Returns the smallest and the biggest key in the tree.
+        /// @exception std::out_of_range if the tree is empty.
+        const key_type& min_key() const;
+        const key_type& max_key() const;
+
+        /// @brief Checks if the tree holds an entry with the given key.
+        bool contains(const key_type& key) const;
+
+        /// @brief Returns an iterator to the first entry with the given key, or end() if there is none.
+        iterator find(const key_type& key);
+        const_iterator find(const key_type& key) const;
+
+        /// @brief Returns an iterator to the first entry whose key is not smaller than the given key, or end() if there is none.
+        iterator lower_bound(const key_type& key);
+        const_iterator lower_bound(const key_type& key) const;
+
+        /// @brief Returns an iterator to the first entry whose key is bigger than the given key, or end() if there is none.
+        iterator upper_bound(const key_type& key);
+        const_iterator upper_bound(const key_type& key) const;
+
+        /// @brief Returns an iterator to the entry with the smallest key.
+        iterator begin();
+        const_iterator begin() const;
+        const_iterator cbegin() const;
+
+        /// @brief Returns an iterator past the entry with the biggest key.
+        iterator end();
+        const_iterator end() const;
+        const_iterator cend() const;
+
+        /// @brief Returns a reverse iterator to the entry with the biggest key.
+        reverse_iterator rbegin();
+        const_reverse_iterator rbegin() const;
+        const_reverse_iterator crbegin() const;
+
+        /// @brief Returns a reverse iterator past the entry with the smallest key.
+        reverse_iterator rend();
+        const_reverse_iterator rend() const;
+        const_reverse_iterator crend() const;
+
+        /// @brief Returns the number of entries in the tree whose keys are smaller than the given key.
+        /// @note Time Complexity: O(log n). Requires an augmentation that keeps counts, such as `OrderStatistics`.
+        size_type rank(const key_type& key) const requires Augment::enabled;
+
+        /// @brief Returns an iterator to the k-th entry in key order, counting from 0.
+        /// @note Time Complexity: O(log n). Requires an augmentation that keeps counts, such as `OrderStatistics`.
+        /// @exception std::out_of_range if k is not smaller than the size of the tree.
+        iterator select(size_type k) requires Augment::enabled;
+        const_iterator select(size_type k) const requires Augment::enabled;
+
+        /// @brief Returns the number of entries whose keys are in the range [lo, hi).
+        /// @note Time Complexity: O(log n). Requires an augmentation that keeps counts, such as `OrderStatistics`.
+        size_type count_range(const key_type& lo, const key_type& hi) const requires Augment::enabled;
+
+        /// @brief Combines the entries whose keys are in the range [lo, hi), in key order.
+        /// @note Time Complexity: O(log n).
+        typename Augment::aggregate_type aggregate(const key_type& lo, const key_type& hi) const requires Augment::enabled;
+    };
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                        BPlusMultiTree CRUD API Block                         //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size() const
+    {
+        return m_tree.size();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    bool BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::is_empty() const
+    {
+        return m_tree.is_empty();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::insert(const key_type& key, const mapped_type& mapped)
+    {
+        return emplace(key_type(key), mapped_type(mapped));
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::insert(key_type&& key, mapped_type&& mapped) noexcept
+    {
+        return emplace(std::move(key), std::move(mapped));
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <typename ... Args> requires std::constructible_from<Mapped, Args...>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::emplace(key_type&& key, Args&&... args) noexcept
+    {
+        return m_tree.template emplace_impl<false, true>(std::move(key), std::forward<Args>(args)...).first;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::count(const key_type& key) const
+    {
+        return m_tree.count_equal(lower_bound(key), key);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    std::pair<typename BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator, typename BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator> BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::equal_range(const key_type& key)
+    {
+        return {lower_bound(key), upper_bound(key)};
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    std::pair<typename BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_iterator, typename BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_iterator> BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::equal_range(const key_type& key) const
+    {
+        return {lower_bound(key), upper_bound(key)};
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::erase_all_of(const key_type& key)
+    {
+        // the run ends where the next bigger key starts, which may be in an entry about to move, so it is copied
+        iterator last = upper_bound(key);
+        if (last == end()){
+            return m_tree.template erase_range_impl<true>(key, nullptr);
+        }
+        key_type hi = last.key();
+        return m_tree.template erase_range_impl<true>(key, &hi);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::erase_range(const key_type& lo, const key_type& hi)
+    {
+        return m_tree.template erase_range_impl<true>(lo, &hi);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <class Predicate> requires std::predicate<Predicate&, const Key&, const Mapped&>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::erase_if(Predicate pred)
+    {
+        return m_tree.erase_if(std::move(pred));
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    void BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::erase_all()
+    {
+        m_tree.erase_all();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    const BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::key_type& BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::min_key() const
+    {
+        return m_tree.min_key();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    const BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::key_type& BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::max_key() const
+    {
+        return m_tree.max_key();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    bool BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::contains(const key_type& key) const
+    {
+        return m_tree.contains(key);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                      BPlusMultiTree Iteration API Block                      //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::find(const key_type& key)
+    {
+        iterator found = lower_bound(key);
+        if (found != end() && found.key() == key){
+            return found;
+        }
+        return end();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_iterator BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::find(const key_type& key) const
+    {
+        return const_cast<BPlusMultiTree*>(this)->find(key);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::lower_bound(const key_type& key)
+    {
+        return m_tree.template bound<false, true>(key);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_iterator BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::lower_bound(const key_type& key) const
+    {
+        return m_tree.template bound<false, true>(key);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::upper_bound(const key_type& key)
+    {
+        return m_tree.upper_bound(key);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_iterator BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::upper_bound(const key_type& key) const
+    {
+        return m_tree.upper_bound(key);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::begin()
+    {
+        return m_tree.begin();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_iterator BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::begin() const
+    {
+        return m_tree.begin();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_iterator BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::cbegin() const
+    {
+        return m_tree.cbegin();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::end()
+    {
+        return m_tree.end();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_iterator BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::end() const
+    {
+        return m_tree.end();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_iterator BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::cend() const
+    {
+        return m_tree.cend();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::reverse_iterator BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::rbegin()
+    {
+        return m_tree.rbegin();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_reverse_iterator BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::rbegin() const
+    {
+        return m_tree.rbegin();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_reverse_iterator BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::crbegin() const
+    {
+        return m_tree.crbegin();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::reverse_iterator BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::rend()
+    {
+        return m_tree.rend();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_reverse_iterator BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::rend() const
+    {
+        return m_tree.rend();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_reverse_iterator BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::crend() const
+    {
+        return m_tree.crend();
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                     BPlusMultiTree Augmentation API Block                    //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::rank(const key_type& key) const requires Augment::enabled
+    {
+        return m_tree.template rank_impl<true>(key);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::select(size_type k) requires Augment::enabled
+    {
+        return m_tree.select(k);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_iterator BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::select(size_type k) const requires Augment::enabled
+    {
+        return m_tree.select(k);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::count_range(const key_type& lo, const key_type& hi) const requires Augment::enabled
+    {
+        if (!(lo < hi)){
+            return 0;
+        }
+        return m_tree.template rank_impl<true>(hi) - m_tree.template rank_impl<true>(lo);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    typename Augment::aggregate_type BPlusMultiTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::aggregate(const key_type& lo, const key_type& hi) const requires Augment::enabled
+    {
+        if (!(lo < hi)){
+            return Augment::aggregate(Augment::identity());
+        }
+        return Augment::aggregate(m_tree.template summarize_range<true>(m_tree.m_root, m_tree.m_height, &lo, &hi));
+    }
+};
+
+#endif
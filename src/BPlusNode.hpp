@@ -2,19 +2,141 @@
 #define BPLUS_NODE_CLASS_DEFINED
 
 #include "Constraints.hpp"
+#include "KeySearch.hpp"
+#include "Augmentation.hpp"
 #include <stdexcept>
 #include <array>
 #include <memory>
-#include <variant>
+#include <algorithm>
 
 namespace csaur{
-    template<OrderedKey, Storable, std::size_t, SingleElementAllocator, SingleElementAllocator>
+    template<OrderedKey, Storable, std::size_t, SingleElementAllocator, SingleElementAllocator, SingleElementAllocator, class, class>
     class BPlusTree;
 
-    template<OrderedKey Key, Storable Mapped, std::size_t N>
+    template<OrderedKey, Storable, std::size_t, SingleElementAllocator, SingleElementAllocator, SingleElementAllocator, class, class>
+    class BPlusMultiTree;
+
+    template<ConcurrentKey, Storable, std::size_t, SingleElementAllocator, SingleElementAllocator, SingleElementAllocator, class>
+    class ConcurrentBPlusTree;
+
+    template<OrderedKey, Storable, std::size_t, SingleElementAllocator, SingleElementAllocator, SingleElementAllocator, class>
+    class SnapshotBPlusTree;
+
+    template<class Traits, OrderedKey Key, Storable Mapped, std::size_t N, class Search>
+    class LooseInternal;
+
+    template<OrderedKey Key, Storable Mapped, std::size_t N, class Search = DefaultSearch, class Augment = NoAugment>
+    class BPlusNode;
+
+    template<OrderedKey Key, Storable Mapped, std::size_t N, class Search = DefaultSearch, class Augment = NoAugment>
+    class BPlusLeaf;
+
+    template<OrderedKey Key, Storable Mapped, std::size_t N, class Search = DefaultSearch, class Augment = NoAugment>
+    class BPlusInternal;
+
+    template<class Leaf, bool is_const>
+    class BPlusIterator;
+
+    template<class Leaf, class ValueAlloc>
+    class BPlusEntryHandle;
+
+    /// @brief The part shared by leaves and internal nodes: a counter and a sorted array of keys.
+    /// @note Nodes carry no type tag. The tree knows its height, so it knows which kind of node it reaches at each level.
+    /// @tparam Search The policy used to search the keys, see KeySearch.hpp.
+    /// @tparam Augment The summaries internal nodes keep of their subtrees, see Augmentation.hpp.
+    template<OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
     class BPlusNode{
-        template<OrderedKey, Storable, std::size_t, SingleElementAllocator, SingleElementAllocator>
+        static_assert(N >= 3, "BPlusNode: a node must be able to hold at least three keys.");
+
+        template<OrderedKey, Storable, std::size_t, SingleElementAllocator, SingleElementAllocator, SingleElementAllocator, class, class>
+        friend class csaur::BPlusTree;
+        template<ConcurrentKey, Storable, std::size_t, SingleElementAllocator, SingleElementAllocator, SingleElementAllocator, class>
+        friend class csaur::ConcurrentBPlusTree;
+        template<OrderedKey, Storable, std::size_t, SingleElementAllocator, SingleElementAllocator, SingleElementAllocator, class>
+        friend class csaur::SnapshotBPlusTree;
+        friend class BPlusLeaf<Key, Mapped, N, Search, Augment>;
+        friend class BPlusInternal<Key, Mapped, N, Search, Augment>;
+        template<class, OrderedKey, Storable, std::size_t, class>
+        friend class LooseInternal;
+        #ifdef DEBUGGING_B_PLUS_TREE
+            friend class ::BPlusTest;
+        #endif
+    public:
+        using key_type = Key;
+        using size_type = std::size_t;
+
+        /// @brief The least number of keys a node may hold, unless it is the root or, after appends, a rightmost node.
+        static constexpr size_type min_keys = N - N/2;
+
+    protected:
+        /// @brief Creates an empty node
+        BPlusNode();
+
+        std::size_t m_key_counter;
+        std::array<key_type, N> m_keys;
+        [[no_unique_address]] typename Search::template layout<key_type, N> m_layout;
+
+        /// @brief Brings the search policy's layout up to date after the keys changed.
+        void update_layout();
+
+        /// @brief Finds the index of the smallest key in the node that is strictly greater than the given key.
+        /// @param key The key to find the smallest bigger key for.
+        /// @return The index of the smallest key larger than the given `key` in the `m_keys` array.
+        /// @note Time Complexity: O(log x), where x is the number of keys currently stored in the node.
+        ///       The search itself is delegated to the `Search` policy.
+        /// @note Space Complexity: O(1).
+        size_type find_smallest_bigger_key_index(const key_type& key) const;
+
+        /// @brief Finds the index of the smallest key in the node that is not smaller than the given key.
+        /// @note Only needed where keys may repeat, so it uses a plain binary search rather than the `Search` policy,
+        ///       which only looks for strictly greater keys.
+        size_type find_smallest_not_smaller_key_index(const key_type& key) const;
+
+        /// @brief Inserts a key and its associated data at a given index, moving the following entries one step right.
+        /// @param node A leaf or an internal node that is not full.
+        /// @param index The index the new entry will have.
+        /// @note Summaries kept by internal nodes move along with their entries. The summary of the new entry is left for the caller to set.
+        template<class Node>
+        static void insert_at(Node& node, size_type index, key_type&& key, typename Node::data_type&& data);
+
+        /// @brief Removes the entry at a given index, moving the following entries one step left.
+        /// @note Does not release the data of the removed entry.
+        template<class Node>
+        static void erase_at(Node& node, size_type index);
+
+        /// @brief Removes the entries at the indices [first, last), moving the following entries left.
+        /// @note Does not release the data of the removed entries.
+        template<class Node>
+        static void erase_at(Node& node, size_type first, size_type last);
+
+        /// @brief Splits a full node by moving its upper entries into an empty sibling, and inserts a new entry.
+        ///        By default, both halves end up holding at least `min_keys` entries.
+        /// @param index The index of the new entry in the node before the split.
+        /// @param lower_size The number of entries the node keeps, when the new entry goes to the sibling.
+        template<class Node>
+        static void split_insert(Node& node, Node& sibling, size_type index, key_type&& key, typename Node::data_type&& data, size_type lower_size = (N + 1) / 2);
+
+        /// @brief Moves all the entries of `higher_node` to the end of `lower_node`. Assumes they fit.
+        template<class Node>
+        static void append(Node& lower_node, Node& higher_node);
+
+        /// @brief Moves entries across the boundary between two adjacent nodes, so that `lower_node` ends up holding
+        ///        `lower_size` of their entries and `higher_node` the rest. Assumes both sides fit.
+        template<class Node>
+        static void redistribute(Node& lower_node, Node& higher_node, size_type lower_size);
+    };
+
+    /// @brief A leaf node, holding the mapped values and the links to its neighbouring leaves.
+    template<OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+    class BPlusLeaf : public BPlusNode<Key, Mapped, N, Search, Augment>{
+        template<OrderedKey, Storable, std::size_t, SingleElementAllocator, SingleElementAllocator, SingleElementAllocator, class, class>
         friend class csaur::BPlusTree;
+        friend class BPlusNode<Key, Mapped, N, Search, Augment>;
+        friend class BPlusInternal<Key, Mapped, N, Search, Augment>;
+        template<class, bool>
+        friend class BPlusIterator;
+        template<class, class>
+        friend class BPlusEntryHandle;
         #ifdef DEBUGGING_B_PLUS_TREE
             friend class ::BPlusTest;
         #endif
@@ -28,53 +150,111 @@ namespace csaur{
         using const_pointer = const value_type*;
         using size_type = std::size_t;
 
-        /// @brief Creates an empty node
-        /// @param is_leaf A flag for creating either a leaf (if true) or an internal node (if false)
-        BPlusNode(bool is_leaf = false);
+        /// @brief Whether leaf slots hold the mapped values themselves (true) or pointers to values obtained from the value allocator (false).
+        static constexpr bool stores_inline = InlineStorable<Mapped>;
+        using slot_type = std::conditional_t<stores_inline, value_type, pointer>;
+        using data_type = slot_type;
+        using summary_type = typename Augment::summary_type;
+
+        /// @brief Leaves keep no summaries, their parents summarize them.
+        static constexpr bool keeps_summaries = false;
+
+        /// @brief Whether the summaries above a leaf depend on its mapped values, which are then read-only through iterators.
+        static constexpr bool values_read_only = Augment::reads_values;
+
+        /// @brief Creates an empty leaf
+        BPlusLeaf();
     private:
-        std::size_t m_key_counter;
-        std::array<key_type, N> m_keys;
-        std::variant<std::array<pointer, N>, std::array<BPlusNode*, N>> m_data; // either Mapped* in leafs or BPlusNode* in internal nodes
-        BPlusNode* m_next, * m_prev;
+        std::array<slot_type, N> m_data;
+        BPlusLeaf* m_next, * m_prev;
+
+        /// @brief Returns the address of the value held by a leaf slot.
+        static pointer value_address(slot_type&) noexcept;
+        static const_pointer value_address(const slot_type&) noexcept;
+
+        /// @brief Destroys the value held by a leaf slot, returning its storage to the value allocator if it was allocated.
+        template<class Tree>
+        static void destroy_slot(Tree&, slot_type&);
 
-        /// @brief Searches for the data associated with a given key in the node's subtree.
+        /// @brief Searches for the data associated with a given key in the leaf.
         /// @param key The key to search for.
         /// @return A pointer to the mapped data associated with the key or nullptr if there isn't one.
         pointer search (const key_type&) const;
 
-        /// @brief Inserts a new key and its associated data into the node's subtree.
-        /// @tparam Try - If set to true, double insertions will change values.
-        /// @param key The key to insert.
-        /// @param args Arguments used to construct the data associated with the key.
-        /// @return A pointer to the newly created node if the node was full and split. Otherwise, returns `nullptr` if the insertion is successful and the node is not full.
-        template<SingleElementAllocator ValAlloc, SingleElementAllocator NodeAlloc, bool Try = false, typename ... Args> requires std::constructible_from<Mapped, Args...>
-        BPlusNode* emplace (BPlusTree<Key, Mapped, N, ValAlloc, NodeAlloc>&, key_type&&, Args&& ...) noexcept;
+        /// @brief Destroys all the values held by the leaf.
+        template<class Tree>
+        void erase_all(Tree&);
 
-        static void restabilize(BPlusNode*, BPlusNode*);
+        /// @brief Returns the summary of all the entries of the leaf.
+        summary_type summary() const;
 
-        /// @brief Deletes the data associated with the given key from the node. 
-        /// @param key The key to erase.
-        /// @return `true` if the deletion was successful, `false` otherwise.
-        template<SingleElementAllocator ValAlloc, SingleElementAllocator NodeAlloc>
-        bool erase(BPlusTree<Key, Mapped, N, ValAlloc, NodeAlloc>&, const key_type&);
+        /// @brief Hints the processor to start loading every cache line of the leaf.
+        void prefetch() const;
 
-        /// @brief Removes all data if present.
-        template<SingleElementAllocator ValAlloc, SingleElementAllocator NodeAlloc>
-        void erase_all(BPlusTree<Key, Mapped, N, ValAlloc, NodeAlloc>&);
+        /// @brief Hints the processor to start loading the value at `index`. Does nothing if the values are inline.
+        void prefetch_value(size_type index) const;
+    };
 
-        /// @brief Finds the index of the smallest key in the node that is strictly greater than the given key.
-        /// @param key The key to find the smallest bigger key for.
-        /// @return The index of the smallest key larger than the given `key` in the `m_keys` array.
-        /// @note Time Complexity: O(log x), where x is the number of keys currently stored in the node.
-        /// @note Space Complexity: O(1).
-        size_type find_smallest_bigger_key_index(const key_type& key) const;
+    /// @brief An internal node, holding pointers to its subnodes. Every subnode is of the same kind.
+    /// @note `m_keys[i]` is the smallest key under `m_data[i]`, and is greater than every key under `m_data[i - 1]`.
+    template<OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+    class BPlusInternal : public BPlusNode<Key, Mapped, N, Search, Augment>{
+        template<OrderedKey, Storable, std::size_t, SingleElementAllocator, SingleElementAllocator, SingleElementAllocator, class, class>
+        friend class csaur::BPlusTree;
+        friend class BPlusNode<Key, Mapped, N, Search, Augment>;
+        #ifdef DEBUGGING_B_PLUS_TREE
+            friend class ::BPlusTest;
+        #endif
+    public:
+        using key_type = Key;
+        using size_type = std::size_t;
+        using data_type = BPlusNode<Key, Mapped, N, Search, Augment>*;
+        using summary_type = typename Augment::summary_type;
+
+        /// @brief Whether the node keeps a summary of the subtree under each of its subnodes.
+        static constexpr bool keeps_summaries = Augment::enabled;
+
+        /// @brief Creates an empty internal node
+        BPlusInternal();
+    private:
+        std::array<data_type, N> m_data;
+        // m_summaries[i] summarizes m_data[i]. Without summaries, this is the empty summary_type and takes no space
+        [[no_unique_address]] std::conditional_t<keeps_summaries, std::array<summary_type, N>, summary_type> m_summaries;
+
+        /// @brief Finds the index of the subnode whose subtree may contain the given key.
+        size_type child_index(const key_type& key) const;
+
+        /// @brief Finds the index of the first subnode whose subtree may contain the given key, when keys may repeat
+        ///        and the entries with the key may start in the subnodes before the one `child_index` finds.
+        size_type first_child_index(const key_type& key) const;
+
+        /// @brief Returns the summary of the whole subtree under the node.
+        summary_type summary() const;
+
+        /// @brief Recomputes the summary of the subnode at a given index from the subnode's own contents.
+        ///        Does nothing if the node keeps no summaries.
+        /// @param is_internal Whether the subnodes are internal nodes or leaves.
+        void refresh_summary(size_type index, bool is_internal);
+
+        /// @brief Recomputes the summaries of all the subnodes. Does nothing if the node keeps no summaries.
+        /// @param is_internal Whether the subnodes are internal nodes or leaves.
+        void refresh_summaries(bool is_internal);
+
+        /// @brief Hints the processor to start loading the cache lines a search through the node reads.
+        void prefetch() const;
+
+        /// @brief Releases every node and value in the node's subtree, leaving the node itself empty.
+        /// @param height The height of this node, where leaves have height 0.
+        template<class Tree>
+        void erase_all(Tree&, size_type height);
 
-        /// @brief Handles underflows that occur after deletion in an internal node. This method is responsible for
-        ///        deciding whether to merge nodes or redistribute keys between siblings, and it propagates the underflow
-        ///        signal to the parent if necessary.
+        /// @brief Handles underflows that occur after deletion in a subnode. This method is responsible for
+        ///        deciding whether to merge nodes or redistribute keys between siblings. Underflow of this node
+        ///        is left for the caller to handle.
+        /// @tparam is_internal Whether the subnodes are internal nodes or leaves.
         /// @param underflow_index The index of the underflowing subnode.
-        template<SingleElementAllocator ValAlloc, SingleElementAllocator NodeAlloc, bool is_internal>
-        void handle_underflow(BPlusTree<Key, Mapped, N, ValAlloc, NodeAlloc>&, size_type underflow_index);
+        template<bool is_internal, class Tree>
+        void handle_underflow(Tree&, size_type underflow_index);
     };
     #include "BPlusNode.tpp"
 };
@@ -3,322 +3,390 @@
 //////////////////////////////////////////////////////////////////////////////////
 //                        BPlusNode Implementation Block                        //
 //////////////////////////////////////////////////////////////////////////////////
-template <OrderedKey Key, Storable Mapped, std::size_t N>
-BPlusNode<Key, Mapped, N>::BPlusNode(bool is_leaf)
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+BPlusNode<Key, Mapped, N, Search, Augment>::BPlusNode()
 {
     m_key_counter = 0;
-    this->m_next = nullptr;
-    this->m_prev = nullptr;
     m_keys = std::array<Key, N>();
-    if (is_leaf){
-        m_data = std::array<pointer, N> ();
-    }
-    else{
-        m_data = std::array<BPlusNode*, N> ();
+}
+
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+BPlusNode<Key, Mapped, N, Search, Augment>::size_type BPlusNode<Key, Mapped, N, Search, Augment>::find_smallest_bigger_key_index(const key_type& key) const
+{
+    return Search::upper_bound(m_keys, m_key_counter, m_layout, key);
+}
+
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+BPlusNode<Key, Mapped, N, Search, Augment>::size_type BPlusNode<Key, Mapped, N, Search, Augment>::find_smallest_not_smaller_key_index(const key_type& key) const
+{
+    return std::lower_bound(m_keys.begin(), m_keys.begin() + m_key_counter, key) - m_keys.begin();
+}
+
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+void BPlusNode<Key, Mapped, N, Search, Augment>::update_layout()
+{
+    m_layout.rebuild(m_keys, m_key_counter);
+}
+
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+template <class Node>
+void BPlusNode<Key, Mapped, N, Search, Augment>::insert_at(Node& node, size_type index, key_type&& key, typename Node::data_type&& data)
+{
+    std::move_backward(node.m_keys.begin() + index,                 // move them all one step right to fit the new one
+                       node.m_keys.begin() + node.m_key_counter,
+                       node.m_keys.begin() + node.m_key_counter + 1);
+    std::move_backward(node.m_data.begin() + index,
+                       node.m_data.begin() + node.m_key_counter,
+                       node.m_data.begin() + node.m_key_counter + 1);
+    if constexpr(Node::keeps_summaries){
+        std::move_backward(node.m_summaries.begin() + index,
+                           node.m_summaries.begin() + node.m_key_counter,
+                           node.m_summaries.begin() + node.m_key_counter + 1);
     }
+    node.m_keys[index] = std::move(key);
+    node.m_data[index] = std::move(data);
+    ++node.m_key_counter;
+    node.update_layout();
 }
 
-template <OrderedKey Key, Storable Mapped, std::size_t N>
-BPlusNode<Key, Mapped, N>::pointer BPlusNode<Key, Mapped, N>::search(const key_type& key) const
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+template <class Node>
+void BPlusNode<Key, Mapped, N, Search, Augment>::erase_at(Node& node, size_type index)
 {
-    auto index = find_smallest_bigger_key_index(key);
-    if (index == 0) return nullptr;
-    else --index;
-    if (m_data.index() == 0){
-        // in leafs, d[i] corresponds to k[i]; in internal nodes, d[i] contains search keys which are all less than k[i]
-        if (this->m_keys[index] != key) return nullptr; 
-        return std::get<0>(m_data)[index];
+    std::move(node.m_keys.begin() + index + 1,                      // move everything left
+              node.m_keys.begin() + node.m_key_counter,
+              node.m_keys.begin() + index);
+    std::move(node.m_data.begin() + index + 1,
+              node.m_data.begin() + node.m_key_counter,
+              node.m_data.begin() + index);
+    if constexpr(Node::keeps_summaries){
+        std::move(node.m_summaries.begin() + index + 1,
+                  node.m_summaries.begin() + node.m_key_counter,
+                  node.m_summaries.begin() + index);
     }
-    return std::get<1>(m_data)[index]->search(key);
+    --node.m_key_counter;
+    node.update_layout();
 }
 
-template <OrderedKey Key, Storable Mapped, std::size_t N>
-void BPlusNode<Key, Mapped, N>::restabilize(BPlusNode *existing_node, BPlusNode *new_node)
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+template <class Node>
+void BPlusNode<Key, Mapped, N, Search, Augment>::erase_at(Node& node, size_type first, size_type last)
 {
-    std::variant<pointer, BPlusNode*> inserted_ptr;
-    key_type inserted_key = new_node->m_keys[0];
-    size_type i = existing_node->find_smallest_bigger_key_index(inserted_key);
-    i -= (i != 0);
-    if (existing_node->m_data.index() != 0){
-        inserted_ptr = std::get<1>(new_node->m_data)[0];    
-        restabilize(std::get<1>(existing_node->m_data)[i], std::get<1>(new_node->m_data)[0]);
-        inserted_key = std::get<1>(new_node->m_data)[0]->m_keys[0];
+    std::move(node.m_keys.begin() + last, node.m_keys.begin() + node.m_key_counter, node.m_keys.begin() + first);
+    std::move(node.m_data.begin() + last, node.m_data.begin() + node.m_key_counter, node.m_data.begin() + first);
+    if constexpr(Node::keeps_summaries){
+        std::move(node.m_summaries.begin() + last, node.m_summaries.begin() + node.m_key_counter, node.m_summaries.begin() + first);
     }
-    else{
-        inserted_ptr = std::get<0>(new_node->m_data)[0];  
+    node.m_key_counter -= last - first;
+    node.update_layout();
+}
+
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+template <class Node>
+void BPlusNode<Key, Mapped, N, Search, Augment>::split_insert(Node& node, Node& sibling, size_type index, key_type&& key, typename Node::data_type&& data, size_type lower_size)
+{
+    size_type mid = (index < lower_size) ? lower_size - 1 : lower_size;
+    std::move(node.m_keys.begin() + mid, node.m_keys.begin() + N, sibling.m_keys.begin());
+    std::move(node.m_data.begin() + mid, node.m_data.begin() + N, sibling.m_data.begin());
+    if constexpr(Node::keeps_summaries){
+        std::move(node.m_summaries.begin() + mid, node.m_summaries.begin() + N, sibling.m_summaries.begin());
     }
-    std::size_t mid = (inserted_key < existing_node->m_keys[N/2]) ? N/2 : N - N/2;  // stabilizing the sizes
-    BPlusNode* inserting_node = (inserted_key < existing_node->m_keys[N/2]) ? existing_node : new_node; // choose the smaller node
-    
-    std::copy_n(existing_node->m_keys.begin() + mid, existing_node->m_key_counter - mid, new_node->m_keys.begin());
-    if (existing_node->m_data.index() == 0){
-        std::copy_n(std::get<0>(existing_node->m_data).begin() + mid,               // first
-                    existing_node->m_key_counter - mid,                             // count
-                    std::get<0>(new_node->m_data).begin());                // result
+    sibling.m_key_counter = N - mid;
+    node.m_key_counter = mid;
+    if (index < lower_size){
+        insert_at(node, index, std::move(key), std::move(data));
+        sibling.update_layout();
     }
     else{
-        std::copy_n(std::get<1>(existing_node->m_data).begin() + mid, 
-                    existing_node->m_key_counter - mid, 
-                    std::get<1>(new_node->m_data).begin());
+        insert_at(sibling, index - lower_size, std::move(key), std::move(data));
+        node.update_layout();
     }
-    existing_node->m_key_counter = mid;
-    new_node->m_key_counter = N - mid;
+}
 
-    if (existing_node->m_next){
-        existing_node->m_next->m_prev = new_node;
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+template <class Node>
+void BPlusNode<Key, Mapped, N, Search, Augment>::append(Node& lower_node, Node& higher_node)
+{
+    std::move(higher_node.m_keys.begin(), higher_node.m_keys.begin() + higher_node.m_key_counter, lower_node.m_keys.begin() + lower_node.m_key_counter);
+    std::move(higher_node.m_data.begin(), higher_node.m_data.begin() + higher_node.m_key_counter, lower_node.m_data.begin() + lower_node.m_key_counter);
+    if constexpr(Node::keeps_summaries){
+        std::move(higher_node.m_summaries.begin(), higher_node.m_summaries.begin() + higher_node.m_key_counter, lower_node.m_summaries.begin() + lower_node.m_key_counter);
     }
-    new_node->m_next = existing_node->m_next;
-    existing_node->m_next = new_node;
-    new_node->m_prev = existing_node;
+    lower_node.m_key_counter += higher_node.m_key_counter;
+    higher_node.m_key_counter = 0;
+    lower_node.update_layout();
+    higher_node.update_layout();
+}
 
-    i = inserting_node->m_key_counter;
-    if (inserting_node->m_data.index() == 0){
-        for (; (i > 0)&&(inserted_key < inserting_node->m_keys[i-1]); --i){ // move them all one step right to fit the new one
-            std::get<0>(inserting_node->m_data)[i] = std::get<0>(inserting_node->m_data)[i-1];
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+template <class Node>
+void BPlusNode<Key, Mapped, N, Search, Augment>::redistribute(Node& lower_node, Node& higher_node, size_type lower_size)
+{
+    if (lower_size > lower_node.m_key_counter){
+        // move the first entries of the higher node to the end of the lower one
+        size_type moved = lower_size - lower_node.m_key_counter;
+        std::move(higher_node.m_keys.begin(), higher_node.m_keys.begin() + moved, lower_node.m_keys.begin() + lower_node.m_key_counter);
+        std::move(higher_node.m_data.begin(), higher_node.m_data.begin() + moved, lower_node.m_data.begin() + lower_node.m_key_counter);
+        if constexpr(Node::keeps_summaries){
+            std::move(higher_node.m_summaries.begin(), higher_node.m_summaries.begin() + moved, lower_node.m_summaries.begin() + lower_node.m_key_counter);
         }
-        std::get<0>(inserting_node->m_data)[i] = std::get<0>(inserted_ptr);
+        lower_node.m_key_counter = lower_size;
+        erase_at(higher_node, 0, moved);
+        lower_node.update_layout();
     }
-    else{
-        for (; (i > 0)&&(inserted_key < inserting_node->m_keys[i-1]); --i){ // move them all one step right to fit the new one
-            std::get<1>(inserting_node->m_data)[i] = std::get<1>(inserting_node->m_data)[i-1];
+    else if (lower_size < lower_node.m_key_counter){
+        // make room at the start of the higher node for the last entries of the lower one
+        size_type moved = lower_node.m_key_counter - lower_size;
+        std::move_backward(higher_node.m_keys.begin(), higher_node.m_keys.begin() + higher_node.m_key_counter, higher_node.m_keys.begin() + higher_node.m_key_counter + moved);
+        std::move_backward(higher_node.m_data.begin(), higher_node.m_data.begin() + higher_node.m_key_counter, higher_node.m_data.begin() + higher_node.m_key_counter + moved);
+        std::move(lower_node.m_keys.begin() + lower_size, lower_node.m_keys.begin() + lower_node.m_key_counter, higher_node.m_keys.begin());
+        std::move(lower_node.m_data.begin() + lower_size, lower_node.m_data.begin() + lower_node.m_key_counter, higher_node.m_data.begin());
+        if constexpr(Node::keeps_summaries){
+            std::move_backward(higher_node.m_summaries.begin(), higher_node.m_summaries.begin() + higher_node.m_key_counter, higher_node.m_summaries.begin() + higher_node.m_key_counter + moved);
+            std::move(lower_node.m_summaries.begin() + lower_size, lower_node.m_summaries.begin() + lower_node.m_key_counter, higher_node.m_summaries.begin());
         }
-        std::get<1>(inserting_node->m_data)[i] = std::get<1>(inserted_ptr);
+        higher_node.m_key_counter += moved;
+        lower_node.m_key_counter = lower_size;
+        lower_node.update_layout();
+        higher_node.update_layout();
     }
-    for (i = inserting_node->m_key_counter; (i > 0)&&(inserted_key < inserting_node->m_keys[i-1]); --i){ // move them all one step right to fit the new one
-        inserting_node->m_keys[i] = inserting_node->m_keys[i-1];
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//                        BPlusLeaf Implementation Block                        //
+//////////////////////////////////////////////////////////////////////////////////
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+BPlusLeaf<Key, Mapped, N, Search, Augment>::BPlusLeaf()
+{
+    m_data = std::array<slot_type, N> ();
+    m_next = nullptr;
+    m_prev = nullptr;
+}
+
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+BPlusLeaf<Key, Mapped, N, Search, Augment>::pointer BPlusLeaf<Key, Mapped, N, Search, Augment>::value_address(slot_type& slot) noexcept
+{
+    if constexpr(stores_inline){
+        return &slot;
+    }
+    else{
+        return slot;
     }
-    inserting_node->m_keys[i] = inserted_key;
-    ++inserting_node->m_key_counter;
 }
 
-template <OrderedKey Key, Storable Mapped, std::size_t N>
-template<SingleElementAllocator ValAlloc, SingleElementAllocator NodeAlloc, bool Try, typename ... Args> requires std::constructible_from<Mapped, Args...>
-BPlusNode<Key, Mapped, N> *BPlusNode<Key, Mapped, N>::emplace(BPlusTree<Key, Mapped, N, ValAlloc, NodeAlloc>& tree, key_type&&key, Args&& ... args) noexcept
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+BPlusLeaf<Key, Mapped, N, Search, Augment>::const_pointer BPlusLeaf<Key, Mapped, N, Search, Augment>::value_address(const slot_type& slot) noexcept
 {
-    std::variant<pointer, BPlusNode*> inserted_ptr;
-    Key inserted_key;
-    if (m_data.index() == 0){                           // if leaf
-        try{
-            pointer val_ptr = search(key);
-            if (val_ptr != nullptr){
-                if constexpr(Try){
-                    *val_ptr = std::move(args...);
-                }
-                return nullptr;
-            };
-            inserted_ptr = std::construct_at(tree.m_val_alloc.allocate(), std::move(args...));
-        }
-        catch(std::bad_alloc& e){
-            return nullptr;
-        }
-        inserted_key = Key (std::move(key));
+    if constexpr(stores_inline){
+        return &slot;
     }
-    else{                                               // if internal
-        std::size_t working_index = this->find_smallest_bigger_key_index(key);
-        working_index -= (working_index != 0);
-        if (this->m_keys[working_index] > key){
-            this->m_keys[working_index] = key;
-        }
-        inserted_ptr = std::get<1>(this->m_data)[working_index]->emplace(tree, std::move(key), std::move(args...));
-        if (std::get<1>(inserted_ptr) == nullptr) return nullptr;
-        if (this->m_key_counter != N){
-            restabilize(std::get<1>(this->m_data)[working_index], std::get<1>(inserted_ptr));
-        }
-        inserted_key = std::get<1>(inserted_ptr)->m_keys[0];
+    else{
+        return slot;
     }
+}
 
-    if (this->m_key_counter == N){ // split
-        BPlusNode* new_node;
-        try{
-            new_node = std::construct_at(tree.m_node_alloc.allocate(), this->m_data.index() == 0);              // index == 0 <-> this is a leaf
-        }
-        catch(std::bad_alloc& e){
-            while(inserted_ptr.index() != 0){
-                auto temp = std::get<1>(inserted_ptr);
-                if (temp->m_data.index() == 0){
-                    inserted_ptr = std::get<1>(temp->m_data)[0];
-                }
-                else{
-                    inserted_ptr = std::get<0>(temp->m_data)[0];
-                }
-                std::destroy_at(temp);
-                tree.m_node_alloc.deallocate(temp);
-            }
-            std::destroy_at(std::get<0>(inserted_ptr));
-            tree.m_val_alloc.deallocate(std::get<0>(inserted_ptr));
-            return nullptr;
-        }
-        if (tree.m_max == this){
-            tree.m_max = new_node;
-        }
-        new_node->m_keys[0] = inserted_key;
-        if (this->m_data.index() == 0){
-            std::get<0>(new_node->m_data)[0] = std::get<0>(inserted_ptr);
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+template <class Tree>
+void BPlusLeaf<Key, Mapped, N, Search, Augment>::destroy_slot(Tree& tree, slot_type& slot)
+{
+    if constexpr(!stores_inline){   // inline values are trivially copyable, so there is nothing to release
+        std::destroy_at(slot);
+        tree.m_val_alloc.deallocate(slot);
+    }
+}
 
-        }
-        else{
-            std::get<1>(new_node->m_data)[0] = std::get<1>(inserted_ptr);
-        }
-        return new_node;
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+BPlusLeaf<Key, Mapped, N, Search, Augment>::pointer BPlusLeaf<Key, Mapped, N, Search, Augment>::search(const key_type& key) const
+{
+    auto index = this->find_smallest_bigger_key_index(key);
+    if (index == 0 || this->m_keys[index - 1] != key) return nullptr;
+    return const_cast<pointer>(value_address(m_data[index - 1]));
+}
+
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+template <class Tree>
+void BPlusLeaf<Key, Mapped, N, Search, Augment>::erase_all(Tree& tree)
+{
+    for (std::size_t i = 0; i < this->m_key_counter; ++i){
+        destroy_slot(tree, m_data[i]);
     }
-    std::size_t i = this->m_key_counter;
-    if (this->m_data.index() == 0){
-        for (; (i > 0)&&(inserted_key < this->m_keys[i-1]); --i){ // move them all one step right to fit the new one
-            std::get<0>(this->m_data)[i] = std::get<0>(this->m_data)[i-1];
-        }
-        std::get<0>(this->m_data)[i] = std::get<0>(inserted_ptr);
+    this->m_key_counter = 0;
+    this->update_layout();
+}
+
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+BPlusLeaf<Key, Mapped, N, Search, Augment>::summary_type BPlusLeaf<Key, Mapped, N, Search, Augment>::summary() const
+{
+    summary_type result = Augment::identity();
+    for (std::size_t i = 0; i < this->m_key_counter; ++i){
+        result = Augment::combine(result, Augment::lift(this->m_keys[i], *value_address(m_data[i])));
     }
-    else{
-        for (; (i > 0)&&(inserted_key < this->m_keys[i-1]); --i){ // move them all one step right to fit the new one
-            std::get<1>(this->m_data)[i] = std::get<1>(this->m_data)[i-1];
+    return result;
+}
+
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+void BPlusLeaf<Key, Mapped, N, Search, Augment>::prefetch() const
+{
+    #if defined(__GNUC__)
+        for (std::size_t offset = 0; offset < sizeof(BPlusLeaf); offset += 64){
+            __builtin_prefetch(reinterpret_cast<const char*>(this) + offset);
         }
-        std::get<1>(this->m_data)[i] = std::get<1>(inserted_ptr);
-    }
-    for (i = this->m_key_counter; (i > 0)&&(inserted_key < this->m_keys[i-1]); --i){ // move them all one step right to fit the new one
-        this->m_keys[i] = this->m_keys[i-1];
+    #endif
+}
+
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+void BPlusLeaf<Key, Mapped, N, Search, Augment>::prefetch_value(size_type index) const
+{
+    #if defined(__GNUC__)
+        if constexpr(!stores_inline){
+            __builtin_prefetch(m_data[index]);
+        }
+    #endif
+}
+
+//////////////////////////////////////////////////////////////////////////////////
+//                      BPlusInternal Implementation Block                      //
+//////////////////////////////////////////////////////////////////////////////////
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+BPlusInternal<Key, Mapped, N, Search, Augment>::BPlusInternal()
+{
+    m_data = std::array<data_type, N> ();
+}
+
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+BPlusInternal<Key, Mapped, N, Search, Augment>::size_type BPlusInternal<Key, Mapped, N, Search, Augment>::child_index(const key_type& key) const
+{
+    // in internal nodes, d[i] contains search keys which are all less than k[i+1]
+    size_type index = this->find_smallest_bigger_key_index(key);
+    return index - (index != 0);
+}
+
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+BPlusInternal<Key, Mapped, N, Search, Augment>::size_type BPlusInternal<Key, Mapped, N, Search, Augment>::first_child_index(const key_type& key) const
+{
+    // the subnode before the first one whose separator equals the key may end with the key
+    size_type index = this->find_smallest_not_smaller_key_index(key);
+    return index - (index != 0);
+}
+
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+BPlusInternal<Key, Mapped, N, Search, Augment>::summary_type BPlusInternal<Key, Mapped, N, Search, Augment>::summary() const
+{
+    summary_type result = Augment::identity();
+    for (std::size_t i = 0; i < this->m_key_counter; ++i){
+        result = Augment::combine(result, m_summaries[i]);
     }
-    this->m_keys[i] = inserted_key;
-    ++this->m_key_counter;
-    return nullptr;
+    return result;
 }
 
-template <OrderedKey Key, Storable Mapped, std::size_t N>
-template<SingleElementAllocator ValAlloc, SingleElementAllocator NodeAlloc>
-bool BPlusNode<Key, Mapped, N>::erase(BPlusTree<Key, Mapped, N, ValAlloc, NodeAlloc>& tree, const key_type& key)
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+void BPlusInternal<Key, Mapped, N, Search, Augment>::refresh_summary(size_type index, bool is_internal)
 {
-    std::size_t i = this->find_smallest_bigger_key_index(key);
-    if (i == 0) return false;
-    if (this->m_data.index() != 0){
-        --i;
-        auto res = std::get<1>(this->m_data)[i]->erase(tree, key);
-        if (std::get<1>(this->m_data)[i]->m_key_counter >= N-N/2) return res; // if there's no underflow, return
-        if (std::get<1>(this->m_data)[i]->m_data.index() == 0){ // else, fix the situation and then return
-            handle_underflow<ValAlloc, NodeAlloc, false>(tree, i);
+    if constexpr(keeps_summaries){
+        if (is_internal){
+            m_summaries[index] = static_cast<const BPlusInternal*>(m_data[index])->summary();
         }
         else{
-            handle_underflow<ValAlloc, NodeAlloc, true>(tree, i);
+            m_summaries[index] = static_cast<const BPlusLeaf<Key, Mapped, N, Search, Augment>*>(m_data[index])->summary();
         }
-        return res;
     }
-    if (this->m_keys[i - 1] != key)
-        return false;
-
-    std::destroy_at(std::get<0>(this->m_data)[i-1]);
-    tree.m_val_alloc.deallocate(std::get<0>(this->m_data)[i-1]);
-    
-    std::copy_n(std::get<0>(this->m_data).begin() + i,      // move everything left
-                this->m_key_counter - i, 
-                std::get<0>(this->m_data).begin() + i - 1);
-    std::copy_n(this->m_keys.begin() + i, 
-                this->m_key_counter - i, 
-                this->m_keys.begin() + i - 1);
-
-    --this->m_key_counter;
-    return true;
 }
 
-template <OrderedKey Key, Storable Mapped, std::size_t N>
-template<SingleElementAllocator ValAlloc, SingleElementAllocator NodeAlloc>
-void BPlusNode<Key, Mapped, N>::erase_all(BPlusTree<Key, Mapped, N, ValAlloc, NodeAlloc>& tree)
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+void BPlusInternal<Key, Mapped, N, Search, Augment>::refresh_summaries(bool is_internal)
 {
-    if (this->m_data.index() == 0){
+    if constexpr(keeps_summaries){
         for (std::size_t i = 0; i < this->m_key_counter; ++i){
-            std::destroy_at(std::get<0>(this->m_data)[i]);
-            tree.m_val_alloc.deallocate(std::get<0>(this->m_data)[i]);
+            refresh_summary(i, is_internal);
         }
     }
-    else{
-        for (std::size_t i = 0; i < this->m_key_counter; ++i){
-            std::get<1>(this->m_data)[i]->erase_all(tree);
-            std::destroy_at(std::get<1>(this->m_data)[i]);
-            tree.m_node_alloc.deallocate(std::get<1>(this->m_data)[i]);
+}
+
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+void BPlusInternal<Key, Mapped, N, Search, Augment>::prefetch() const
+{
+    #if defined(__GNUC__)
+        // the keys, the search layout and the subnode pointers, but not the summaries behind them
+        auto start = reinterpret_cast<const char*>(this);
+        std::size_t size = reinterpret_cast<const char*>(m_data.data() + N) - start;
+        for (std::size_t offset = 0; offset < size; offset += 64){
+            __builtin_prefetch(start + offset);
         }
-    }
-    this->m_key_counter = 0;
+    #endif
 }
 
-template <OrderedKey Key, Storable Mapped, std::size_t N>
-BPlusNode<Key, Mapped, N>::size_type BPlusNode<Key, Mapped, N>::find_smallest_bigger_key_index(const key_type& key) const
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+template <class Tree>
+void BPlusInternal<Key, Mapped, N, Search, Augment>::erase_all(Tree& tree, size_type height)
 {
-    std::size_t left = 0, right = (m_key_counter != 0) ? m_key_counter - 1 : 0, result = m_key_counter;
-    // binary search, T(n) = O(log n) & S(n) = O(1)
-    while (left <= right){
-        auto mid = (left + right) / 2;
-        if (key < m_keys[mid]){ // comparison is permitted because Key must support 'operator<(Key, Key)'
-            result = mid;
-            if (mid == 0) break; // prevents out-of-range indexing
-            right = mid - 1;
+    for (std::size_t i = 0; i < this->m_key_counter; ++i){
+        if (height == 1){
+            auto leaf = static_cast<BPlusLeaf<Key, Mapped, N, Search, Augment>*>(m_data[i]);
+            leaf->erase_all(tree);
+            std::destroy_at(leaf);
+            tree.m_leaf_alloc.deallocate(leaf);
         }
         else{
-            left = mid + 1; 
+            auto internal = static_cast<BPlusInternal*>(m_data[i]);
+            internal->erase_all(tree, height - 1);
+            std::destroy_at(internal);
+            tree.m_internal_alloc.deallocate(internal);
         }
     }
-    return result;
+    this->m_key_counter = 0;
+    this->update_layout();
 }
 
-template <OrderedKey Key, Storable Mapped, std::size_t N>
-template<SingleElementAllocator ValAlloc, SingleElementAllocator NodeAlloc, bool is_internal>
-void BPlusNode<Key, Mapped, N>::handle_underflow(BPlusTree<Key, Mapped, N, ValAlloc, NodeAlloc>& tree, size_type underflow_index)
+template <OrderedKey Key, Storable Mapped, std::size_t N, class Search, class Augment>
+template <bool is_internal, class Tree>
+void BPlusInternal<Key, Mapped, N, Search, Augment>::handle_underflow(Tree& tree, size_type underflow_index)
 {
+    using subnode_type = std::conditional_t<is_internal, BPlusInternal, BPlusLeaf<Key, Mapped, N, Search, Augment>>;
     // assumes having at least two sons, for the case for less would have already been dealt with
     std::size_t neighbour_index = (underflow_index > 0) ? underflow_index - 1 : underflow_index + 1;
-    BPlusNode* underflow_subnode = std::get<1>(this->m_data)[underflow_index], * neighbour_subnode = std::get<1>(this->m_data)[neighbour_index];
+    subnode_type* underflow_subnode = static_cast<subnode_type*>(m_data[underflow_index]), * neighbour_subnode = static_cast<subnode_type*>(m_data[neighbour_index]);
     if (underflow_subnode->m_key_counter + neighbour_subnode->m_key_counter > N){
         // Case 1: borrow
         if (underflow_index > neighbour_index){
-            // first move all things here rightwards
-            for (std::size_t i = underflow_subnode->m_key_counter; i > 0; --i) {
-                underflow_subnode->m_keys[i] = underflow_subnode->m_keys[i - 1];
-                std::get<is_internal>(underflow_subnode->m_data)[i] = std::get<is_internal>(underflow_subnode->m_data)[i - 1];
-            }
-            // then borrow at the start
-            underflow_subnode->m_keys[0] = neighbour_subnode->m_keys[neighbour_subnode->m_key_counter - 1];
-            std::get<is_internal>(underflow_subnode->m_data)[0] = std::get<is_internal>(neighbour_subnode->m_data)[neighbour_subnode->m_key_counter - 1];
-
+            // borrow the neighbour's last entry to the start
+            this->insert_at(*underflow_subnode, 0,
+                            std::move(neighbour_subnode->m_keys[neighbour_subnode->m_key_counter - 1]),
+                            std::move(neighbour_subnode->m_data[neighbour_subnode->m_key_counter - 1]));
             --neighbour_subnode->m_key_counter;
-            ++underflow_subnode->m_key_counter;
-            // then fix extremes and this' keys
+            neighbour_subnode->update_layout();
+            if constexpr(subnode_type::keeps_summaries){
+                underflow_subnode->m_summaries[0] = neighbour_subnode->m_summaries[neighbour_subnode->m_key_counter];
+            }
+            // then fix this' keys
             this->m_keys[underflow_index] = underflow_subnode->m_keys[0];
+            this->update_layout();
         }
         else{
-            // first borrow at the end
-            underflow_subnode->m_keys[underflow_subnode->m_key_counter] = neighbour_subnode->m_keys[0];
-            std::get<is_internal>(underflow_subnode->m_data)[underflow_subnode->m_key_counter] = std::get<is_internal>(neighbour_subnode->m_data)[0];
-
-            --neighbour_subnode->m_key_counter;
-            ++underflow_subnode->m_key_counter;
-            // then move all the neighbour's leftwards
-            std::copy_n(std::get<is_internal>(neighbour_subnode->m_data).begin() + 1,      // move everything left
-                        neighbour_subnode->m_key_counter, 
-                        std::get<is_internal>(neighbour_subnode->m_data).begin());
-            std::copy_n(neighbour_subnode->m_keys.begin() + 1, 
-                        neighbour_subnode->m_key_counter, 
-                        neighbour_subnode->m_keys.begin());
-            // then fix extremes and this' keys
+            // borrow the neighbour's first entry to the end
+            this->insert_at(*underflow_subnode, underflow_subnode->m_key_counter,
+                            std::move(neighbour_subnode->m_keys[0]),
+                            std::move(neighbour_subnode->m_data[0]));
+            if constexpr(subnode_type::keeps_summaries){
+                underflow_subnode->m_summaries[underflow_subnode->m_key_counter - 1] = neighbour_subnode->m_summaries[0];
+            }
+            this->erase_at(*neighbour_subnode, 0);
+            // then fix this' keys
             this->m_keys[neighbour_index] = neighbour_subnode->m_keys[0];
+            this->update_layout();
         }
+        refresh_summary(underflow_index, is_internal);
+        refresh_summary(neighbour_index, is_internal);
     }
     else{
         // Case 2: merge
+        std::size_t higher_index = std::max(underflow_index, neighbour_index);
         if (underflow_index > neighbour_index) {
-            if (tree.m_max == underflow_subnode) {
-                tree.m_max = neighbour_subnode;
-            }
             tree.template merge<is_internal>(neighbour_subnode, underflow_subnode);
         }
-        else { 
-            if (tree.m_max == neighbour_subnode) {
-                tree.m_max = underflow_subnode;
-            }
+        else {
             tree.template merge<is_internal>(underflow_subnode, neighbour_subnode);
         }
-        std::size_t i = std::max(underflow_index, neighbour_index) + 1;
-        std::copy_n(std::get<1>(this->m_data).begin() + i,      // move everything left
-                    this->m_key_counter - i, 
-                    std::get<1>(this->m_data).begin() + i - 1);
-        std::copy_n(this->m_keys.begin() + i, 
-                    this->m_key_counter - i, 
-                    this->m_keys.begin() + i - 1);
-        this->m_key_counter--;
+        this->erase_at(*this, higher_index);
+        refresh_summary(higher_index - 1, is_internal);
     }
 }
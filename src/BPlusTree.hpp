@@ -4,17 +4,27 @@
 #include "Constraints.hpp"
 #include <stdexcept>
 #include <array>
-#include <variant>
 #include <string>
 #include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <cmath>
+#include <span>
+#include <optional>
 #include "BPlusNode.hpp"
+#include "BPlusIterator.hpp"
+#include "BPlusEntryHandle.hpp"
 #include "DefaultAllocator.hpp"
 namespace csaur{
     template<OrderedKey Key, 
              Storable Mapped, 
              std::size_t N, 
              SingleElementAllocator ValueAlloc = DefaultAllocator<Mapped>,
-             SingleElementAllocator NodeAlloc = DefaultAllocator<BPlusNode<Key, Mapped, N>>
+             SingleElementAllocator LeafAlloc = DefaultAllocator<BPlusLeaf<Key, Mapped, N>>,
+             SingleElementAllocator InternalAlloc = DefaultAllocator<BPlusInternal<Key, Mapped, N>>,
+             class Search = DefaultSearch,
+             class Augment = NoAugment
             >
     class BPlusTree{
     public:
@@ -27,30 +37,207 @@ namespace csaur{
         using const_pointer = const value_type*;
         using size_type = std::size_t;
         using value_allocator = ValueAlloc;
-        using node_type = BPlusNode<Key, Mapped, N>;
-        using node_allocator = NodeAlloc;
+        using node_type = BPlusNode<Key, Mapped, N, Search, Augment>;
+        using leaf_type = BPlusLeaf<Key, Mapped, N, Search, Augment>;
+        using internal_type = BPlusInternal<Key, Mapped, N, Search, Augment>;
+        using leaf_allocator = rebind_allocator_t<LeafAlloc, leaf_type>;
+        using internal_allocator = rebind_allocator_t<InternalAlloc, internal_type>;
+        using search_policy = Search;
+        using augmentation = Augment;
+        using iterator = BPlusIterator<leaf_type, false>;
+        using const_iterator = BPlusIterator<leaf_type, true>;
+        using reverse_iterator = BPlusReverseIterator<iterator>;
+        using const_reverse_iterator = BPlusReverseIterator<const_iterator>;
+        using entry_handle = BPlusEntryHandle<leaf_type, value_allocator>;
     private:
+        /// @brief An upper bound on the height of any tree, since every non-root internal node has at least two subnodes.
+        static constexpr size_type max_height = 8 * sizeof(size_type);
 
         /// @brief Gets two adjacent node pointers and merges them into the lower one. Assumes the input nodes are adjacent.
         /// @param lower_node A pointer to a node
         /// @param higher_node A pointer to a node
         template <bool is_internal>
-        void merge(node_type* lower_node, node_type* higher_node);
+        void merge(std::conditional_t<is_internal, internal_type, leaf_type>* lower_node, std::conditional_t<is_internal, internal_type, leaf_type>* higher_node);
 
-        /// @brief Allocates a node and copies the contents of another into it.
+        /// @brief Allocates a node and copies the contents of another into it, along with its subtree.
         /// @param source A pointer to the node to be copied.
+        /// @param height The height of the source node, where leaves have height 0.
+        /// @param last_leaf The last leaf copied so far, which the next copied leaf will be linked to.
         /// @return A new allocated node copy.
-        node_type* copy (const node_type* source, const node_type* prev, bool has_min, bool has_max);
+        node_type* copy (const node_type* source, size_type height, leaf_type*& last_leaf);
+
+        /// @brief Releases every node and value of the tree, including the root.
+        void release();
+
+        /// @brief Releases every node and value of a subtree, including its root.
+        /// @param height The height of the subtree's root, where leaves have height 0.
+        void release(node_type* node, size_type height);
+
+        /// @brief Removes the entries whose keys are in the range [lo, *hi) from a subtree, releasing whole the subnodes
+        ///        that lie inside the range. Keeps separators and summaries up to date, but leaves the nodes along the
+        ///        ends of the range possibly underfull.
+        /// @param hi The upper bound of the range, or nullptr if the range is unbounded above.
+        /// @tparam Multi Whether keys may repeat, in which case the ends of the range are found with `first_child_index`.
+        template<bool Multi = false>
+        void erase_range_in(node_type* node, size_type height, const key_type& lo, const key_type* hi);
+
+        /// @brief Refills the underfull nodes on the path to a key by borrowing from and merging with their neighbours,
+        ///        bottom-up, and shrinks the tree if the root is left with a single subnode.
+        /// @tparam Multi Whether keys may repeat, in which case the path leads to the first leaf holding the key.
+        template<bool Multi = false>
+        void rebalance_path(const key_type& key);
+
+        /// @brief Finds the index of the subnode holding the first entry with a key in the tree, when keys may repeat.
+        ///        That is the subnode `first_child_index` finds, unless all of its keys are smaller and the next one starts with the key.
+        /// @param height The height of the node, where leaves have height 0.
+        size_type first_holder_index(const internal_type* node, size_type height, const key_type& key) const;
+
+        /// @brief Drops the emptied subnodes of a subtree and refills its underfull ones, bottom-up, restoring the
+        ///        separators and summaries on the way. Leaves the root of the subtree itself possibly underfull.
+        /// @param height The height of the subtree's root, where leaves have height 0.
+        void repair(internal_type* node, size_type height);
+
+        /// @brief Refills the underfull subnodes of an internal node, by merging each with a neighbour, or by evening
+        ///        out their entries when they do not fit in a single node, then refreshes the node's summaries.
+        ///        Internal subnodes that merge or even out are refilled in turn, since they may bring together an
+        ///        only subnode left underfull with new neighbours.
+        /// @param height The height of the node, where leaves have height 0.
+        template<bool is_internal>
+        void refill(internal_type* node, size_type height);
+
+        /// @brief Releases the internal nodes of a subtree, leaving its leaves and values alone.
+        /// @param height The height of the subtree's root, where leaves have height 0.
+        void release_internals(node_type* node, size_type height);
+
+        /// @brief Exchanges the nodes and sizes of two trees, keeping their allocators and settings.
+        void exchange(BPlusTree& other);
+
+        /// @brief Attaches the root of a shorter subtree as the last or first subnode of the node above its level on
+        ///        the rightmost or leftmost spine, splitting the full nodes above it. Its keys must all be bigger or
+        ///        smaller than the keys of the tree. Leaves the leaf chain, the size and `m_min`/`m_max` to the caller.
+        /// @param height The height of the subtree's root, where leaves have height 0. At most `m_height`.
+        /// @param at_end Whether the subtree goes to the rightmost spine. Requires `height < m_height` otherwise.
+        /// @note At failure, does not change contents.
+        void graft(node_type* subtree, size_type height, bool at_end);
+
+        /// @brief Removes the entries whose keys are in the range [lo, *hi), where a null `hi` leaves the range unbounded above.
+        /// @return The number of removed entries.
+        /// @tparam Multi Whether keys may repeat, as in a `BPlusMultiTree`.
+        template<bool Multi = false>
+        size_type erase_range_impl(const key_type& lo, const key_type* hi);
+
+        /// @brief Recomputes the summaries of the subnodes along a descent path, from a given level up to the root.
+        ///        Does nothing if the tree keeps no summaries.
+        /// @param level The number of path nodes to refresh, starting from the one at index `level - 1`.
+        void refresh_path(const std::array<internal_type*, max_height>& path, const std::array<size_type, max_height>& indices, size_type level);
+
+        /// @brief Sets the separators of the leaf at the end of a descent path to its new first key, from its parent up to
+        ///        the lowest ancestor it is not the first subnode of. Separators are kept equal to the smallest key under them.
+        void refresh_separators(const std::array<internal_type*, max_height>& path, const std::array<size_type, max_height>& indices, const key_type& smallest);
+
+        /// @brief Returns the number of nodes to spread a given number of entries over, so that each node holds about
+        ///        `target` entries and at least `min_keys`. A single node is returned if the entries fit in one.
+        static size_type bulk_node_count(size_type entries, size_type target);
+
+        /// @brief Returns the number of internal nodes `bulk_build_levels` needs over a given number of leaves.
+        static size_type bulk_internal_count(size_type leaves, size_type target);
+
+        /// @brief Builds the internal levels of a tree bottom-up over its filled leaves, spreading each level evenly
+        ///        over nodes holding about `target` subnodes each.
+        /// @param level The leaves, in order. Left holding the root alone.
+        /// @param internals The empty internal nodes to build the levels from, as many as `bulk_internal_count` returns.
+        /// @return The height of the built tree.
+        size_type bulk_build_levels(std::vector<node_type*>& level, const std::vector<internal_type*>& internals, size_type target);
+
+        /// @brief Combines the entries of a subtree whose keys are in the range [*lo, *hi), using the cached summaries
+        ///        of the subnodes that lie entirely inside the range.
+        /// @param lo The lower bound of the range, or nullptr if the range is unbounded below.
+        /// @param hi The upper bound of the range, or nullptr if the range is unbounded above.
+        /// @tparam Multi Whether keys may repeat, in which case the ends of the range are found with `first_child_index`.
+        template<bool Multi = false>
+        typename Augment::summary_type summarize_range(const node_type* node, size_type height, const key_type* lo, const key_type* hi) const;
+
+        /// @brief Returns the number of entries whose keys are smaller than the given key.
+        /// @tparam Multi Whether keys may repeat, in which case the descent follows `first_child_index`.
+        template<bool Multi = false>
+        size_type rank_impl(const key_type& key) const;
+
+        /// @brief Finds the leaf whose key range contains the given key.
+        /// @tparam First Whether to find the first leaf that may hold the key rather than the last, for trees where keys may repeat.
+        template<bool First = false>
+        leaf_type* find_leaf(const key_type& key) const;
+
+        /// @brief The number of lookups `multi_get` keeps in flight at once.
+        static constexpr size_type multi_get_group = 16;
+
+        /// @brief Looks up a group of at most `multi_get_group` keys, descending for all of them one level at a time.
+        /// @return The number of keys that were found.
+        template<class Pointer>
+        size_type lookup_group(const key_type* keys, Pointer* results, size_type count) const;
+
+        /// @brief Inserts a new key and its associated data into the tree with a single descent.
+        /// @tparam Try - If set to true, double insertions will change values.
+        /// @tparam Multi - If set to true, double insertions add an entry after the ones with the same key.
+        /// @return An iterator to the entry with the key, or end() at failure, and whether a new key was inserted.
+        template<bool Try, bool Multi = false, typename ... Args> requires std::constructible_from<Mapped, Args...>
+        std::pair<iterator, bool> emplace_impl (key_type&&, Args&& ...) noexcept;
+
+        /// @brief Finds the slot of a key with a single descent, and either updates the value in it or inserts the key.
+        /// @param create Called as `create()` to make the slot of a new key.
+        /// @param update Called as `update(mapped)` on the value of a key already in the tree, returning whether it changed it.
+        /// @return An iterator to the entry with the key, or end() at allocation failure, and whether a new key was inserted.
+        /// @note Keys bigger than every key in the tree are appended to `m_max` without a search, and the nodes they
+        ///       split are split according to `m_append_fill`.
+        /// @note The summaries above an updated value are refreshed even if `update` throws.
+        /// @param discard Called as `discard(slot)` on the slot made by `create` if the nodes the insertion needs cannot be allocated.
+        /// @tparam Multi Whether keys may repeat, in which case the key is always inserted, after the entries with equal keys.
+        template<bool Multi = false, class Create, class Update, class Discard>
+        std::pair<iterator, bool> emplace_with (key_type&&, Create& create, Update& update, Discard& discard);
+
+        /// @brief Erases a key from the tree with a single descent if found, after handing its entry to `take(key, slot)`.
+        /// @return Whether or not the key was found.
+        template<class Take>
+        bool erase_with (const key_type&, Take& take);
+
+        /// @brief Constructs the value of a new leaf slot, allocating it if values are not stored inline.
+        template<typename ... Args>
+        typename leaf_type::slot_type make_slot(Args&& ...);
+
+        /// @brief Returns the leaf whose key range contains the given key if it is the hinted leaf or one of its
+        ///        neighbours, or nullptr if it is neither. Relies on every separator being the smallest key under it.
+        leaf_type* hinted_leaf(const leaf_type* hint, const key_type& key) const;
+
+        /// @brief Finds the first entry whose key is not smaller (Upper = false) or is bigger (Upper = true) than the given key.
+        /// @return An iterator to the entry, or end() if there is none.
+        /// @tparam Multi Whether keys may repeat, in which case the first of the entries with an equal key is found.
+        template<bool Upper, bool Multi = false>
+        iterator bound(const key_type&) const;
+
+        /// @brief Counts the entries with a given key from the first of them on, searching each leaf they span once.
+        /// @param first An iterator to the first entry with the key, or to the entry that would follow it.
+        size_type count_equal(const_iterator first, const key_type& key) const;
+
+        /// @brief Calls `func(key, mapped)` on every entry from the given position whose key is smaller than `hi`.
+        template<bool Prefetch, class Function>
+        void scan(leaf_type* leaf, size_type index, const key_type& hi, Function& func) const;
 
         friend node_type;
+        friend leaf_type;
+        friend internal_type;
+        template<OrderedKey, Storable, std::size_t, SingleElementAllocator, SingleElementAllocator, SingleElementAllocator, class, class>
+        friend class BPlusMultiTree;
         #ifdef DEBUGGING_B_PLUS_TREE
             friend class ::BPlusTest;
         #endif
 
     private:
         size_type m_size; 
-        node_type* m_root,* m_min,* m_max;
-        NodeAlloc m_node_alloc;
+        size_type m_height; // the number of internal levels above the leaves
+        double m_append_fill; // the portion of a rightmost node that stays in it when an append splits it
+        node_type* m_root;
+        leaf_type* m_min,* m_max;
+        leaf_allocator m_leaf_alloc;
+        internal_allocator m_internal_alloc;
         value_allocator m_val_alloc;
     public:
         /// @brief Creates an empty BPlusTree.
@@ -104,14 +291,143 @@ namespace csaur{
         template<typename ... Args> requires std::constructible_from<Mapped, Args...>
         void try_emplace (key_type&&, Args&& ...) noexcept;
 
+        /// @brief Updates the value of a key in place if it is in the tree, or inserts the key with a value made on
+        ///        demand otherwise, with a single descent either way.
+        /// @param make Called as `make()` to make the value of a new key.
+        /// @param update Called as `update(mapped)` on the value of a key already in the tree.
+        /// @return An iterator to the entry with the key, or end() at allocation failure, and whether the key was inserted.
+        /// @note Summaries follow the updated value, even if `update` throws.
+        template<class Make, class Update> requires std::invocable<Make&> && std::constructible_from<Mapped, std::invoke_result_t<Make&>> && std::invocable<Update&, Mapped&>
+        std::pair<iterator, bool> upsert (key_type&&, Make make, Update update);
+
+        /// @brief Calls `func(mapped)` on the value of a key in place, with a single descent.
+        /// @return Whether the key was found.
+        /// @note Summaries follow the modified value, even if `func` throws.
+        template<class Function> requires std::invocable<Function&, Mapped&>
+        bool modify (const key_type&, Function func);
+
+        /// @brief Inserts a new key and its associated data into the tree, starting from a hinted position instead of the root.
+        /// @param hint An iterator near the place of the key, typically the one returned by the previous insertion.
+        /// @param key The key to insert.
+        /// @param args Arguments used to construct the data associated with the key.
+        /// @return An iterator to the entry with the key, or end() at failure.
+        /// @note Time Complexity: O(1) plus the search in the leaf when the key belongs in the hinted leaf or one of its
+        ///       neighbours and no split is needed, which makes inserting sorted runs cheap. Otherwise, the same as `emplace`.
+        ///       Trees with an augmentation always descend from the root, since the summaries above the leaf change.
+        /// @note There can only be one associated value per key.
+        /// @note At failure, does not change contents.
+        template<typename ... Args> requires std::constructible_from<Mapped, Args...>
+        iterator emplace_hint (const_iterator hint, key_type&&, Args&& ...) noexcept;
+
+        /// @brief Inserts a batch of entries in a single pass over the tree. The batch is sorted, and the entries that
+        ///        belong in the same leaf are merged into it together, after a single descent.
+        /// @tparam Replace If set to true, entries whose keys are already in the tree replace their values, and among
+        ///         entries of the batch with the same key, the last one counts. Otherwise, the first one does.
+        /// @param batch The entries to insert. It is sorted in place, and the mapped values are moved into the tree.
+        /// @return The number of keys that were not in the tree before.
+        /// @note Time Complexity: O(b log b + (b / N + l) log n), where b is the size of the batch and l the number of
+        ///       leaves it touches. Leaves split only when full, each split making room for the entries that follow.
+        /// @note At failure, the entries inserted so far stay in the tree, and the rest are not inserted.
+        template<bool Replace = false>
+        size_type insert_batch (std::span<std::pair<key_type, mapped_type>> batch) noexcept;
+
+        /// @brief Sets how full the rightmost nodes are left when appends, insertions of keys bigger than every key in the
+        ///        tree, split them. The rest of the split node and the new entry go to the new rightmost node.
+        /// @param fill_factor The portion of the split node that stays in it, in [0.5, 1]. At 1, the default, ascending
+        ///        insertions leave every node but the rightmost ones full. At 0.5, appends split nodes in half like other insertions.
+        /// @note Rightmost nodes may hold fewer than `min_keys` entries, and every other node still holds at least `min_keys`.
+        /// @exception std::invalid_argument if the fill factor is out of range.
+        void set_append_fill(double fill_factor);
+
+        /// @brief Returns the portion of a rightmost node that stays in it when an append splits it.
+        double append_fill() const;
+
         /// @brief Erases a key and its associated data from the tree if found.
         /// @param key The key to erase.
         /// @return Whether or not the key was found.
         bool erase (const key_type&);
 
+        /// @brief Takes a key and its associated value out of the tree, without destroying or copying the value.
+        /// @return A handle owning the entry, or an empty handle if the key was not found.
+        entry_handle extract (const key_type&);
+
+        /// @brief Links the entry held by a handle into the tree, without allocating, copying or destroying its value.
+        ///        The handle is left empty if the entry was inserted.
+        /// @return An iterator to the entry with the key, or end() at failure or if the handle is empty, and whether
+        ///         the entry was inserted. If the key was already in the tree, its value is kept and the handle keeps the entry.
+        /// @note The value's storage passes to this tree, so its value allocator must be able to release storage obtained
+        ///       from the allocator of the tree the entry was extracted from, as when trees are moved.
+        /// @note At failure, does not change contents, and the handle keeps the entry.
+        std::pair<iterator, bool> insert (entry_handle&&) noexcept;
+
+        /// @brief Erases the entries whose keys are in the range [lo, hi).
+        /// @return The number of erased entries.
+        /// @note Time Complexity: O(log n + k), where k is the number of erased entries. Subtrees inside the range are
+        ///       released whole, and only the nodes along the two ends of the range are rebalanced.
+        size_type erase_range (const key_type& lo, const key_type& hi);
+
+        /// @brief Erases the entries in [first, last).
+        /// @return An iterator to the entry that followed the erased ones.
+        /// @note Time Complexity: the same as `erase_range`.
+        iterator erase (const_iterator first, const_iterator last);
+
+        /// @brief Erases every entry for which `pred(key, mapped)` returns true.
+        /// @return The number of erased entries.
+        /// @note Time Complexity: O(n). The leaves are compacted in place along the leaf chain, and the nodes left
+        ///       underfull are refilled afterwards, in a single bottom-up pass instead of a rebalancing per erased key.
+        /// @note If the predicate throws, the entries it chose so far are erased, and the rest stay in the tree.
+        template<class Predicate> requires std::predicate<Predicate&, const key_type&, const mapped_type&>
+        size_type erase_if (Predicate pred);
+
         /// @brief Removes all data if present.
         void erase_all();
 
+        /// @brief Replaces the contents of the tree with the entries of a sorted range, building the tree bottom-up:
+        ///        leaves are packed in order and linked, then each level of internal nodes is built over the one below.
+        /// @param first, last A range of pairs whose `first` is a key and `second` a mapped value, sorted by strictly increasing keys.
+        /// @param fill_factor The portion of each node to fill, in (0, 1]. Nodes never hold fewer than `min_keys` entries,
+        ///        so lower factors are rounded up to it. Full nodes suit read-mostly data, sparser ones leave room for insertions.
+        /// @note Time Complexity: O(n), instead of the O(n log n) of repeated insertions.
+        /// @note At failure, does not change contents.
+        /// @exception std::invalid_argument if the range is not sorted by strictly increasing keys, or the fill factor is out of range.
+        template<std::forward_iterator Iterator> requires requires (Iterator it){
+            key_type(it->first);
+            mapped_type(it->second);
+        }
+        void bulk_load(Iterator first, Iterator last, double fill_factor = 1.0);
+
+        /// @brief Moves the entries whose keys are not smaller than a given key into a new tree, by cutting the nodes
+        ///        along the path to the key in two. No entry is moved apart from those of the leaf the path ends at.
+        /// @return A tree holding the entries whose keys are not smaller than `key`, while this tree keeps the rest.
+        /// @note Time Complexity: O(log n) node operations when the tree keeps summaries, which count the moved entries.
+        ///       Otherwise, the leaves of the smaller part are walked to count its entries.
+        /// @note Nodes change trees, so, as with moves, the allocators of both trees must be able to release them.
+        /// @note At failure, does not change contents.
+        BPlusTree split (const key_type& key);
+
+        /// @brief Moves every entry of another tree into this one, when the keys of one of the trees are all smaller
+        ///        than the keys of the other. The root of the shorter tree becomes a subnode of the taller one, at the
+        ///        side spine facing it, and only the nodes along the seam are split or refilled.
+        /// @param other The tree whose entries are moved, which is left empty.
+        /// @note Time Complexity: O(log n) node operations.
+        /// @note Nodes change trees, so, as with moves, the allocators of both trees must be able to release them.
+        /// @note At failure, neither tree changes.
+        /// @exception std::invalid_argument if the key ranges of the trees overlap.
+        void join (BPlusTree&& other);
+
+        /// @brief Moves every entry of another tree into this one, merging the leaf chains of both trees in key order
+        ///        into densely packed new leaves, then building the internal levels over them bottom-up, as `bulk_load`
+        ///        does. Values are moved, never copied or reallocated. Trees whose key ranges do not overlap are joined.
+        /// @tparam Replace If set to true, the entries of `other` whose keys are already in this tree replace their
+        ///         values. Otherwise, the values of this tree are kept.
+        /// @param other The tree whose entries are moved, which is left empty.
+        /// @return The number of keys that were not in this tree before.
+        /// @note Time Complexity: O(n + m), accessing both trees sequentially, instead of the O(m log n) of m insertions.
+        /// @note Nodes and values change trees, so, as with moves, the allocators of both trees must be able to release them.
+        /// @note At failure, neither tree changes.
+        template<bool Replace = false>
+        size_type merge_from (BPlusTree&& other);
+
         /// @brief Returns the minimal key in the tree
         /// @exception std::out_of_range if the container is empty. 
         const key_type& min_key() const;
@@ -123,90 +439,188 @@ namespace csaur{
         /// @param key A key to compare to.
         /// @return A reference to the mapped value associated with the key.
         /// @exception std::out_of_range if the container does not have an element with the specified key. 
-        mapped_type& at(const key_type& key);
+        /// @note The reference is read-only when the augmentation summarizes mapped values, see `modify` instead.
+        mapped_type& at(const key_type& key) requires (!Augment::reads_values);
         const mapped_type& at(const key_type& key) const;
 
         /// @brief Checks if there is a value mapped to the key in this tree.
         /// @param key A key to compare to.
         /// @return Whether there is a value mapped to the key in this tree.
         bool contains(const key_type& key) const;
+
+        /// @brief Looks up many keys at once. The descents of a group of keys advance one level at a time, and every
+        ///        node is prefetched as soon as its address is known, so the cache misses of independent lookups overlap
+        ///        instead of being paid one after another.
+        /// @param keys The keys to look up, in any order.
+        /// @param results Receives, for every key, a pointer to its mapped value or nullptr if it is not in the tree.
+        /// @return The number of keys that were found.
+        /// @note Gains the most on trees that do not fit in cache. On small trees it performs about as well as `at`.
+        /// @exception std::invalid_argument if `results` is shorter than `keys`.
+        size_type multi_get(std::span<const key_type> keys, std::span<mapped_type*> results) requires (!Augment::reads_values);
+        size_type multi_get(std::span<const key_type> keys, std::span<const mapped_type*> results) const;
+
+        /// @brief Returns an iterator to the entry with the smallest key.
+        iterator begin();
+        const_iterator begin() const;
+        const_iterator cbegin() const;
+
+        /// @brief Returns an iterator past the entry with the biggest key.
+        iterator end();
+        const_iterator end() const;
+        const_iterator cend() const;
+
+        /// @brief Returns a reverse iterator to the entry with the biggest key.
+        reverse_iterator rbegin();
+        const_reverse_iterator rbegin() const;
+        const_reverse_iterator crbegin() const;
+
+        /// @brief Returns a reverse iterator past the entry with the smallest key.
+        reverse_iterator rend();
+        const_reverse_iterator rend() const;
+        const_reverse_iterator crend() const;
+
+        /// @brief Returns an iterator to the first entry whose key is not smaller than the given key, or end() if there is none.
+        /// @note Time Complexity: O(log n). Walking on from the result visits the leaves in order, without going back through the root.
+        iterator lower_bound(const key_type& key);
+        const_iterator lower_bound(const key_type& key) const;
+
+        /// @brief Returns an iterator to the first entry whose key is bigger than the given key, or end() if there is none.
+        /// @note Time Complexity: O(log n).
+        iterator upper_bound(const key_type& key);
+        const_iterator upper_bound(const key_type& key) const;
+
+        /// @brief Returns the range of entries whose key equals the given key, which holds at most one entry.
+        /// @return The pair (lower_bound(key), upper_bound(key)).
+        std::pair<iterator, iterator> equal_range(const key_type& key);
+        std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const;
+
+        /// @brief Returns an iterator to the entry with the given key, or end() if there is none.
+        iterator find(const key_type& key);
+        const_iterator find(const key_type& key) const;
+
+        /// @brief Finds the entry with the given key, starting from a hinted position instead of the root.
+        /// @param hint An iterator near the entry, e.g. the result of the previous lookup.
+        /// @return An iterator to the entry, or end() if there is none.
+        /// @note Time Complexity: O(log N) when the key belongs in the hinted leaf or one of its neighbours, O(log n) otherwise.
+        iterator find_from(const_iterator hint, const key_type& key);
+        const_iterator find_from(const_iterator hint, const key_type& key) const;
+
+        /// @brief Returns the number of keys in the tree that are smaller than the given key.
+        /// @note Time Complexity: O(log n). Requires an augmentation that keeps counts, such as `OrderStatistics`.
+        size_type rank(const key_type& key) const requires Augment::enabled;
+
+        /// @brief Returns an iterator to the entry with the k-th smallest key, counting from 0.
+        /// @note Time Complexity: O(log n). Requires an augmentation that keeps counts, such as `OrderStatistics`.
+        /// @exception std::out_of_range if k is not smaller than the size of the tree.
+        iterator select(size_type k) requires Augment::enabled;
+        const_iterator select(size_type k) const requires Augment::enabled;
+
+        /// @brief Returns the number of keys in the range [lo, hi).
+        /// @note Time Complexity: O(log n). Requires an augmentation that keeps counts, such as `OrderStatistics`.
+        size_type count_range(const key_type& lo, const key_type& hi) const requires Augment::enabled;
+
+        /// @brief Combines the entries whose keys are in the range [lo, hi), in ascending key order, e.g. the sum of
+        ///        their mapped values under `MonoidAugment<Sum<T>>`.
+        /// @note Time Complexity: O(log n). Only the two subtrees holding the ends of the range are descended into.
+        typename Augment::aggregate_type aggregate(const key_type& lo, const key_type& hi) const requires Augment::enabled;
+
+        /// @brief Calls `func(key, mapped)` on every entry whose key is in the range [lo, hi), in ascending key order.
+        /// @tparam Prefetch Whether to prefetch the leaves ahead of the scan and the values they point to. Leaves are
+        ///         allocated one by one, so consecutive leaves are rarely adjacent and each hop is otherwise a cache miss.
+        /// @note Time Complexity: O(log n + k), where k is the number of entries in the range.
+        template<bool Prefetch = true, class Function> requires (!Augment::reads_values && std::invocable<Function&, const key_type&, mapped_type&>)
+        void for_each_in_range(const key_type& lo, const key_type& hi, Function func);
+        template<bool Prefetch = true, class Function> requires std::invocable<Function&, const key_type&, const mapped_type&>
+        void for_each_in_range(const key_type& lo, const key_type& hi, Function func) const;
     };
 
     //////////////////////////////////////////////////////////////////////////////////
     //                      BPlusTree CTOR, DTOR, & =TOR Block                      //
     //////////////////////////////////////////////////////////////////////////////////
 
-    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator NodeAlloc>
-    BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::BPlusTree()
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::BPlusTree()
     {
         m_size = 0;
-        m_root = std::construct_at(m_node_alloc.allocate(), true);
-        m_min = m_root;
-        m_max = m_root;
+        m_height = 0;
+        m_append_fill = 1.0;
+        m_min = std::construct_at(m_leaf_alloc.allocate());
+        m_max = m_min;
+        m_root = m_min;
     }
 
-    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator NodeAlloc>
-    BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::BPlusTree(const BPlusTree &other)
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::BPlusTree(const BPlusTree &other)
     {
+        leaf_type* last_leaf = nullptr;
         m_size = other.m_size;
-        m_root = copy(other.m_root, nullptr, true, true);
+        m_height = other.m_height;
+        m_append_fill = other.m_append_fill;
+        m_root = copy(other.m_root, other.m_height, last_leaf);
+        m_max = last_leaf;
     }
 
-    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator NodeAlloc>
-    BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::BPlusTree(BPlusTree &&other)
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::BPlusTree(BPlusTree &&other) : BPlusTree()
     {
-        m_size = other.m_size;
-        m_root = other.m_root;
-        m_min = other.m_min;
-        m_max = other.m_max;
+        std::swap(m_size, other.m_size);
+        std::swap(m_height, other.m_height);
+        std::swap(m_append_fill, other.m_append_fill);
+        std::swap(m_root, other.m_root);
+        std::swap(m_min, other.m_min);
+        std::swap(m_max, other.m_max);
     }
 
-    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator NodeAlloc>
-    BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::~BPlusTree()
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::~BPlusTree()
     {
-        m_root->erase_all(*this);
-        std::destroy_at(m_root);
-        m_node_alloc.deallocate(m_root);
+        release();
     }
 
-    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator NodeAlloc>
-    BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>& BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::operator=(const BPlusTree &other)
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>& BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::operator=(const BPlusTree &other)
     {
-        m_root->erase_all(*this);
-        std::destroy_at(m_root);
-        m_node_alloc.deallocate(m_root);
+        if (this == &other){
+            return *this;
+        }
+        leaf_type* last_leaf = nullptr;
+        node_type* root = copy(other.m_root, other.m_height, last_leaf);
+        release();
         m_size = other.m_size;
-        m_root = copy(other.m_root, nullptr, true, true);
+        m_height = other.m_height;
+        m_append_fill = other.m_append_fill;
+        m_root = root;
+        m_max = last_leaf;
         return *this;
     }
 
-    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator NodeAlloc>
-    BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>& BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::operator=(BPlusTree &&other)
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>& BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::operator=(BPlusTree &&other)
     {
-        m_root->erase_all(*this);
-        std::destroy_at(m_root);
-        m_node_alloc.deallocate(m_root);
-        m_size = other.m_size;
-        m_root = other.m_root;
-        m_min = other.m_min;
-        m_max = other.m_max;
+        erase_all();
+        std::swap(m_size, other.m_size);
+        std::swap(m_height, other.m_height);
+        std::swap(m_append_fill, other.m_append_fill);
+        std::swap(m_root, other.m_root);
+        std::swap(m_min, other.m_min);
+        std::swap(m_max, other.m_max);
         return *this;
     }
 
-    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator NodeAlloc>
-    BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::size_type BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::size() const
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size() const
     {
         return m_size;
     }
 
-    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator NodeAlloc>
-    bool BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::is_empty() const
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    bool BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::is_empty() const
     {
         return m_size == 0;
     }
 
-    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator NodeAlloc>
-    const BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::key_type &BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::min_key() const
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    const BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::key_type &BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::min_key() const
     {
         if (is_empty()){
             throw std::out_of_range("BPlusTree::min_key: An empty tree has no minimal key.\n");
@@ -214,11 +628,11 @@ namespace csaur{
         return m_min->m_keys[0];
     }
 
-    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator NodeAlloc>
-    const BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::key_type &BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::max_key() const
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    const BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::key_type &BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::max_key() const
     {
         if (is_empty()){
-            throw std::out_of_range("BPlusTree::min_key: An empty tree has no minimal key.\n");
+            throw std::out_of_range("BPlusTree::max_key: An empty tree has no maximal key.\n");
         }
         return m_max->m_keys[m_max->m_key_counter - 1];
     }
@@ -227,193 +641,1926 @@ namespace csaur{
     //                           BPlusTree CRUD API Block                           //
     //////////////////////////////////////////////////////////////////////////////////
 
-    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator NodeAlloc>
-    void BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::insert(const key_type& key, const mapped_type& mapped)
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    void BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::insert(const key_type& key, const mapped_type& mapped)
     {
-        emplace(key_type(key), key_type(mapped));
+        emplace(key_type(key), mapped_type(mapped));
     }
 
-    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator NodeAlloc>
-    void BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::insert(key_type&& key, mapped_type&& mapped) noexcept
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    void BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::insert(key_type&& key, mapped_type&& mapped) noexcept
     {
         emplace(std::move(key), std::move(mapped));
     }
 
-    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator NodeAlloc> 
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment> 
     template <typename ... Args> requires std::constructible_from<Mapped, Args...>
-    void BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::emplace(key_type && key, Args &&... args) noexcept
+    void BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::emplace(key_type && key, Args &&... args) noexcept
     {
-        std::variant<pointer, node_type*> new_node = m_root->template emplace<ValueAlloc, NodeAlloc, false, Args...>(*this, std::move(key), std::move(args...));
-        if (std::get<1>(new_node)){
-            node_type* new_root;
-            try{
-                new_root = std::construct_at(m_node_alloc.allocate(), false);
+        emplace_impl<false>(std::move(key), std::forward<Args>(args)...);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment> 
+    template <typename ... Args> requires std::constructible_from<Mapped, Args...>
+    void BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::try_emplace(key_type && key, Args &&... args) noexcept
+    {
+        emplace_impl<true>(std::move(key), std::forward<Args>(args)...);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <class Make, class Update> requires std::invocable<Make&> && std::constructible_from<Mapped, std::invoke_result_t<Make&>> && std::invocable<Update&, Mapped&>
+    std::pair<typename BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator, bool> BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::upsert(key_type && key, Make make, Update update)
+    {
+        auto create = [&](){
+            return make_slot(make());
+        };
+        auto updated = [&](mapped_type& value){
+            update(value);
+            return true;
+        };
+        auto discard = [&](typename leaf_type::slot_type& slot){
+            leaf_type::destroy_slot(*this, slot);
+        };
+        return emplace_with(std::move(key), create, updated, discard);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <class Function> requires std::invocable<Function&, Mapped&>
+    bool BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::modify(const key_type& key, Function func)
+    {
+        std::array<internal_type*, max_height> path;
+        std::array<size_type, max_height> indices;
+        node_type* node = m_root;
+        for (size_type level = 0; level < m_height; ++level){
+            path[level] = static_cast<internal_type*>(node);
+            indices[level] = path[level]->child_index(key);
+            node = path[level]->m_data[indices[level]];
+        }
+        auto leaf = static_cast<leaf_type*>(node);
+        size_type index = leaf->find_smallest_bigger_key_index(key);
+        if (index == 0 || !(leaf->m_keys[index - 1] == key)){
+            return false;
+        }
+        try{
+            func(*leaf_type::value_address(leaf->m_data[index - 1]));
+        }
+        catch(...){
+            refresh_path(path, indices, m_height);
+            throw;
+        }
+        refresh_path(path, indices, m_height);
+        return true;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <typename ... Args> requires std::constructible_from<Mapped, Args...>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::emplace_hint(const_iterator hint, key_type && key, Args &&... args) noexcept
+    {
+        // without summaries to refresh, an insertion that does not split touches the leaf alone, which needs no path.
+        // keys below the leaf's first one are left to emplace_impl, since the minimum of the tree may be changing
+        leaf_type* leaf = (hint.m_leaf != nullptr && !internal_type::keeps_summaries) ? hinted_leaf(hint.m_leaf, key) : nullptr;
+        if (leaf == nullptr || key < leaf->m_keys[0]){
+            return emplace_impl<false>(std::move(key), std::forward<Args>(args)...).first;
+        }
+        size_type index = leaf->find_smallest_bigger_key_index(key);
+        if (leaf->m_keys[index - 1] == key){
+            return iterator(leaf, index - 1);
+        }
+        if (leaf->m_key_counter == N){
+            return emplace_impl<false>(std::move(key), std::forward<Args>(args)...).first;
+        }
+        typename leaf_type::slot_type slot;
+        try{
+            slot = make_slot(std::forward<Args>(args)...);
+        }
+        catch(std::bad_alloc& e){
+            return end();
+        }
+        node_type::insert_at(*leaf, index, std::move(key), std::move(slot));
+        ++m_size;
+        return iterator(leaf, index);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment> 
+    template <bool Try, bool Multi, typename ... Args> requires std::constructible_from<Mapped, Args...>
+    std::pair<typename BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator, bool> BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::emplace_impl(key_type && key, Args &&... args) noexcept
+    {
+        auto create = [&](){
+            return make_slot(std::forward<Args>(args)...);
+        };
+        auto update = [&](mapped_type& value){
+            if constexpr(Try){
+                value = Mapped(std::forward<Args>(args)...);
             }
-            catch(std::bad_alloc& e){
-                while(new_node.index() != 0){
-                    auto temp = std::get<1>(new_node);
-                    if (temp->m_data.index() == 0){
-                        new_node = std::get<1>(temp->m_data)[0];
-                    }
-                    else{
-                        new_node = std::get<0>(temp->m_data)[0];
-                    }
-                    std::destroy_at(temp);
-                    m_node_alloc.deallocate(temp);
+            return Try;
+        };
+        auto discard = [&](typename leaf_type::slot_type& slot){
+            leaf_type::destroy_slot(*this, slot);
+        };
+        return emplace_with<Multi>(std::move(key), create, update, discard);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <bool Multi, class Create, class Update, class Discard>
+    std::pair<typename BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator, bool> BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::emplace_with(key_type && key, Create& create, Update& update, Discard& discard)
+    {
+        std::array<internal_type*, max_height> path;
+        std::array<size_type, max_height> indices;
+        // an append goes to the end of m_max, so its path is the rightmost one and is only walked if something on it changes
+        bool appending = m_size != 0 && (Multi ? !(key < m_max->m_keys[m_max->m_key_counter - 1]) : m_max->m_keys[m_max->m_key_counter - 1] < key);
+        leaf_type* leaf = m_max;
+        size_type index = m_max->m_key_counter;
+        if (!appending || internal_type::keeps_summaries || m_max->m_key_counter == N){
+            node_type* node = m_root;
+            for (size_type level = 0; level < m_height; ++level){
+                path[level] = static_cast<internal_type*>(node);
+                indices[level] = appending ? path[level]->m_key_counter - 1 : path[level]->child_index(key);
+                node = path[level]->m_data[indices[level]];
+            }
+            leaf = static_cast<leaf_type*>(node);
+        }
+        if (!appending){
+            index = leaf->find_smallest_bigger_key_index(key);
+        }
+
+        typename leaf_type::slot_type slot;
+        try{
+            if (!Multi && index != 0 && leaf->m_keys[index - 1] == key){
+                bool updated;
+                try{
+                    updated = update(*leaf_type::value_address(leaf->m_data[index - 1]));
                 }
-                std::destroy_at(std::get<0>(new_node));
-                m_val_alloc.deallocate(std::get<0>(new_node));
-                return;
+                catch(...){
+                    refresh_path(path, indices, m_height);
+                    throw;
+                }
+                if (updated){
+                    refresh_path(path, indices, m_height);
+                }
+                return {iterator(leaf, index - 1), false};
+            }
+            slot = create();
+        }
+        catch(std::bad_alloc& e){
+            return {end(), false};
+        }
+
+        // every node a split will need is allocated before anything is modified, so a failure leaves the tree intact
+        size_type splits = 0;
+        if (leaf->m_key_counter == N){
+            for (splits = 1; splits <= m_height && path[m_height - splits]->m_key_counter == N; ++splits){}
+        }
+        std::array<node_type*, max_height + 1> fresh_nodes;
+        size_type allocated = 0;
+        try{
+            for (; allocated < splits + (splits > m_height); ++allocated){
+                if (allocated == 0){
+                    fresh_nodes[allocated] = std::construct_at(m_leaf_alloc.allocate());
+                }
+                else{
+                    fresh_nodes[allocated] = std::construct_at(m_internal_alloc.allocate());
+                }
+            }
+        }
+        catch(std::bad_alloc& e){
+            while (allocated > 1){
+                --allocated;
+                std::destroy_at(static_cast<internal_type*>(fresh_nodes[allocated]));
+                m_internal_alloc.deallocate(static_cast<internal_type*>(fresh_nodes[allocated]));
             }
-            node_type::restabilize(m_root, std::get<1>(new_node));
-            new_root->m_key_counter = 2;
-            new_root->m_keys[0] = m_root->m_keys[0];
-            new_root->m_keys[1] = std::get<1>(new_node)->m_keys[0];
-            std::get<1>(new_root->m_data)[0] = m_root;
-            std::get<1>(new_root->m_data)[1] = std::get<1>(new_node);
-            m_root = new_root;
+            if (allocated == 1){
+                std::destroy_at(static_cast<leaf_type*>(fresh_nodes[0]));
+                m_leaf_alloc.deallocate(static_cast<leaf_type*>(fresh_nodes[0]));
+            }
+            discard(slot);
+            return {end(), false};
         }
         ++m_size;
+
+        for (size_type level = 0; !appending && level < m_height && indices[level] == 0; ++level){
+            if (key < path[level]->m_keys[0]){
+                path[level]->m_keys[0] = key;
+                path[level]->update_layout();
+            }
+        }
+        if (splits == 0){
+            node_type::insert_at(*leaf, index, std::move(key), std::move(slot));
+            refresh_path(path, indices, m_height);
+            return {iterator(leaf, index), true};
+        }
+
+        // appends leave the split nodes as full as m_append_fill asks, keeping at least two subnodes in new internal nodes
+        size_type leaf_keeps = appending ? std::clamp<size_type>((size_type)std::ceil(N * m_append_fill), node_type::min_keys, N) : (N + 1) / 2;
+        size_type internal_keeps = std::min<size_type>(leaf_keeps, N - 1);
+        leaf_type* new_leaf = static_cast<leaf_type*>(fresh_nodes[0]);
+        node_type::split_insert(*leaf, *new_leaf, index, std::move(key), std::move(slot), leaf_keeps);
+        iterator position = (index < leaf_keeps) ? iterator(leaf, index) : iterator(new_leaf, index - leaf_keeps);
+        if (leaf->m_next){
+            leaf->m_next->m_prev = new_leaf;
+        }
+        new_leaf->m_next = leaf->m_next;
+        leaf->m_next = new_leaf;
+        new_leaf->m_prev = leaf;
+        if (m_max == leaf){
+            m_max = new_leaf;
+        }
+
+        node_type* inserted_node = new_leaf;
+        for (size_type level = m_height, used = 1; level > 0; --level, ++used){
+            internal_type* parent = path[level - 1];
+            if (parent->m_key_counter != N){
+                node_type::insert_at(*parent, indices[level - 1] + 1, key_type(inserted_node->m_keys[0]), std::move(inserted_node));
+                parent->refresh_summary(indices[level - 1], level != m_height);
+                parent->refresh_summary(indices[level - 1] + 1, level != m_height);
+                refresh_path(path, indices, level - 1);
+                return {position, true};
+            }
+            internal_type* new_internal = static_cast<internal_type*>(fresh_nodes[used]);
+            node_type::split_insert(*parent, *new_internal, indices[level - 1] + 1, key_type(inserted_node->m_keys[0]), std::move(inserted_node), internal_keeps);
+            parent->refresh_summaries(level != m_height);       // splits are rare enough for a full refresh
+            new_internal->refresh_summaries(level != m_height);
+            inserted_node = new_internal;
+        }
+
+        internal_type* new_root = static_cast<internal_type*>(fresh_nodes[splits]);
+        new_root->m_key_counter = 2;
+        new_root->m_keys[0] = m_root->m_keys[0];
+        new_root->m_keys[1] = inserted_node->m_keys[0];
+        new_root->m_data[0] = m_root;
+        new_root->m_data[1] = inserted_node;
+        new_root->update_layout();
+        new_root->refresh_summaries(m_height != 0);
+        m_root = new_root;
+        ++m_height;
+        return {position, true};
     }
 
-    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator NodeAlloc> 
-    template <typename ... Args> requires std::constructible_from<Mapped, Args...>
-    void BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::try_emplace(key_type && key, Args &&... args) noexcept
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <bool Replace>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::insert_batch(std::span<std::pair<key_type, mapped_type>> batch) noexcept
     {
-        std::variant<pointer, node_type*> new_node = m_root->template emplace<ValueAlloc, NodeAlloc, true, Args...>(*this, std::move(key), std::move(args...));
-        if (std::get<1>(new_node)){
-            node_type* new_root;
-            try{
-                new_root = std::construct_at(m_node_alloc.allocate(), false);
+        std::stable_sort(batch.begin(), batch.end(), [](const auto& lhs, const auto& rhs){ return lhs.first < rhs.first; });
+        size_type inserted = 0;
+        std::array<internal_type*, max_height> path;
+        std::array<size_type, max_height> indices;
+        std::array<typename leaf_type::slot_type, N> slots;
+        std::array<size_type, N> sources;          // the batch indices of the entries new to the leaf, in order
+        size_type next = 0;
+        while (next < batch.size()){
+            node_type* node = m_root;
+            for (size_type level = 0; level < m_height; ++level){
+                path[level] = static_cast<internal_type*>(node);
+                indices[level] = path[level]->child_index(batch[next].first);
+                node = path[level]->m_data[indices[level]];
             }
-            catch(std::bad_alloc& e){
-                while(new_node.index() != 0){
-                    auto temp = std::get<1>(new_node);
-                    if (temp->m_data.index() == 0){
-                        new_node = std::get<1>(temp->m_data)[0];
+            leaf_type* leaf = static_cast<leaf_type*>(node);
+            const key_type* upper = (leaf->m_next != nullptr) ? &leaf->m_next->m_keys[0] : nullptr;
+
+            // walks the entries that belong in the leaf alongside its keys, replacing values and gathering new entries
+            // until the leaf's free slots run out
+            size_type fresh = 0, index = 0;
+            try{
+                for (; next < batch.size() && (upper == nullptr || batch[next].first < *upper); ){
+                    size_type last = next;
+                    while (last + 1 < batch.size() && batch[last + 1].first == batch[next].first){
+                        ++last;
+                    }
+                    size_type chosen = Replace ? last : next;
+                    for (; index < leaf->m_key_counter && leaf->m_keys[index] < batch[chosen].first; ++index){}
+                    if (index < leaf->m_key_counter && leaf->m_keys[index] == batch[chosen].first){
+                        if constexpr(Replace){
+                            *leaf_type::value_address(leaf->m_data[index]) = std::move(batch[chosen].second);
+                        }
+                    }
+                    else if (leaf->m_key_counter + fresh == N){
+                        break;
                     }
                     else{
-                        new_node = std::get<0>(temp->m_data)[0];
+                        slots[fresh] = make_slot(std::move(batch[chosen].second));
+                        sources[fresh++] = chosen;
                     }
-                    std::destroy_at(temp);
-                    m_node_alloc.deallocate(temp);
+                    next = last + 1;
                 }
-                std::destroy_at(std::get<0>(new_node));
-                m_val_alloc.deallocate(std::get<0>(new_node));
-                return;
             }
-            node_type::restabilize(m_root, std::get<1>(new_node));
-            new_root->m_key_counter = 2;
-            new_root->m_keys[0] = m_root->m_keys[0];
-            new_root->m_keys[1] = std::get<1>(new_node)->m_keys[0];
-            std::get<1>(new_root->m_data)[0] = m_root;
-            std::get<1>(new_root->m_data)[1] = std::get<1>(new_node);
-            m_root = new_root;
+            catch(std::bad_alloc& e){
+                next = batch.size();        // the new entries gathered so far are still merged in
+            }
+
+            // merges the new entries in from the back, so every entry of the leaf moves at most once
+            bool lowered = fresh != 0 && (leaf->m_key_counter == 0 || batch[sources[0]].first < leaf->m_keys[0]);
+            for (size_type from = leaf->m_key_counter, to = leaf->m_key_counter + fresh; fresh > 0; ){
+                --to;
+                if (from > 0 && batch[sources[fresh - 1]].first < leaf->m_keys[from - 1]){
+                    --from;
+                    leaf->m_keys[to] = std::move(leaf->m_keys[from]);
+                    leaf->m_data[to] = std::move(leaf->m_data[from]);
+                }
+                else{
+                    --fresh;
+                    leaf->m_keys[to] = std::move(batch[sources[fresh]].first);
+                    leaf->m_data[to] = std::move(slots[fresh]);
+                    ++leaf->m_key_counter;
+                    ++m_size;
+                    ++inserted;
+                }
+            }
+            leaf->update_layout();
+            if (lowered){
+                refresh_separators(path, indices, leaf->m_keys[0]);
+            }
+            refresh_path(path, indices, m_height);
+
+            // the leaf is full and the next entry belongs in it, so it is split by inserting that entry alone
+            if (next < batch.size() && (upper == nullptr || batch[next].first < *upper)){
+                size_type last = next;
+                while (last + 1 < batch.size() && batch[last + 1].first == batch[next].first){
+                    ++last;
+                }
+                size_type chosen = Replace ? last : next;
+                auto [position, added] = emplace_impl<Replace>(std::move(batch[chosen].first), std::move(batch[chosen].second));
+                if (position == end()){
+                    break;
+                }
+                inserted += added;
+                next = last + 1;
+            }
         }
-        ++m_size;
+        return inserted;
     }
 
-    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator NodeAlloc>
-    bool BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::erase(const key_type &key)
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <typename ... Args>
+    typename BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::leaf_type::slot_type BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::make_slot(Args &&... args)
     {
-        bool out = m_root->erase(*this, key);
-        if (m_root->m_key_counter == 1 && m_root->m_data.index() == 1){
-            auto temp = std::get<1>(m_root->m_data)[0];
-            std::get<1>(m_root->m_data)[0] = nullptr;
-            std::destroy_at(m_root);
-            m_node_alloc.deallocate(m_root);
-            m_root = temp;
+        if constexpr(leaf_type::stores_inline){
+            return typename leaf_type::slot_type(std::forward<Args>(args)...);
+        }
+        else{
+            typename leaf_type::pointer value = m_val_alloc.allocate();
+            try{
+                return std::construct_at(value, std::forward<Args>(args)...);
+            }
+            catch(...){
+                m_val_alloc.deallocate(value);
+                throw;
+            }
         }
-        --m_size;
-        return out;
     }
 
-    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator NodeAlloc>
-    void BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::erase_all()
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    void BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::set_append_fill(double fill_factor)
     {
-        m_root->erase_all(*this);
-        m_size = 0;
-        m_root->m_data = std::array<pointer, N> ();
-        m_min = m_root;
-        m_max = m_root;
+        if (!(fill_factor >= 0.5 && fill_factor <= 1.0)){
+            throw std::invalid_argument("BPlusTree::set_append_fill: The fill factor must be in [0.5, 1].\n");
+        }
+        m_append_fill = fill_factor;
     }
 
-    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator NodeAlloc>
-    BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::mapped_type& BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::at(const key_type &key)
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    double BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::append_fill() const
     {
-        pointer search_result = m_root->search(key);
-        if (search_result){
-            return *search_result;
+        return m_append_fill;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    bool BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::erase(const key_type &key)
+    {
+        auto take = [&](key_type&, typename leaf_type::slot_type& slot){
+            leaf_type::destroy_slot(*this, slot);
+        };
+        return erase_with(key, take);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::entry_handle BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::extract(const key_type &key)
+    {
+        entry_handle handle;
+        auto take = [&](key_type& taken_key, typename leaf_type::slot_type& slot){
+            handle = entry_handle(std::move(taken_key), std::move(slot), m_val_alloc);
+        };
+        erase_with(key, take);
+        return handle;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    std::pair<typename BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator, bool> BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::insert(entry_handle&& handle) noexcept
+    {
+        if (handle.empty()){
+            return {end(), false};
         }
-        throw std::out_of_range("BPlusTree::at: No value associated with the key was found.\n");
+        // the slot goes back to the handle if the insertion fails, and the key is only moved once it succeeds
+        auto create = [&](){
+            return std::move(handle.m_slot);
+        };
+        auto update = [](mapped_type&){
+            return false;
+        };
+        auto discard = [&](typename leaf_type::slot_type& slot){
+            handle.m_slot = std::move(slot);
+        };
+        auto result = emplace_with(std::move(handle.m_key), create, update, discard);
+        if (result.second){
+            handle.m_alloc = nullptr;
+        }
+        return result;
     }
 
-    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator NodeAlloc>
-    const BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::mapped_type& BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::at(const key_type &key) const
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <class Take>
+    bool BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::erase_with(const key_type &key, Take& take)
     {
-        pointer search_result = m_root->search(key);
-        if (search_result){
-            return *search_result;
+        std::array<internal_type*, max_height> path;
+        std::array<size_type, max_height> indices;
+        node_type* node = m_root;
+        for (size_type level = 0; level < m_height; ++level){
+            path[level] = static_cast<internal_type*>(node);
+            indices[level] = path[level]->child_index(key);
+            node = path[level]->m_data[indices[level]];
         }
-        throw std::out_of_range("BPlusTree::at: No value associated with the key was found.\n");
+        leaf_type* leaf = static_cast<leaf_type*>(node);
+        size_type index = leaf->find_smallest_bigger_key_index(key);
+        if (index == 0 || leaf->m_keys[index - 1] != key){
+            return false;
+        }
+        take(leaf->m_keys[index - 1], leaf->m_data[index - 1]);
+        node_type::erase_at(*leaf, index - 1);
+        --m_size;
+
+        if (index == 1 && leaf->m_key_counter != 0){
+            refresh_separators(path, indices, leaf->m_keys[0]);
+        }
+
+        for (size_type level = m_height; level > 0; --level){
+            internal_type* parent = path[level - 1];
+            if (parent->m_data[indices[level - 1]]->m_key_counter >= node_type::min_keys){         // if there's no underflow, stop
+                parent->refresh_summary(indices[level - 1], level != m_height);
+                refresh_path(path, indices, level - 1);
+                break;
+            }
+            if (level == m_height){                                                               // else, fix the situation and go up
+                parent->template handle_underflow<false>(*this, indices[level - 1]);
+            }
+            else{
+                parent->template handle_underflow<true>(*this, indices[level - 1]);
+            }
+        }
+        while (m_height > 0 && m_root->m_key_counter == 1){
+            internal_type* old_root = static_cast<internal_type*>(m_root);
+            m_root = old_root->m_data[0];
+            std::destroy_at(old_root);
+            m_internal_alloc.deallocate(old_root);
+            --m_height;
+        }
+        return true;
     }
 
-    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator NodeAlloc>
-    bool BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::contains(const key_type &key) const
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::erase_range(const key_type &lo, const key_type &hi)
     {
-        return nullptr != m_root->search(key);
+        return erase_range_impl(lo, &hi);
     }
 
-    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator NodeAlloc>
-    template <bool is_internal>
-    void BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::merge(typename BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::node_type* lower_node, typename BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::node_type* higher_node){
-        for (std::size_t i = 0; i < higher_node->m_key_counter; ++i) {
-            lower_node->m_keys[lower_node->m_key_counter + i] = higher_node->m_keys[i];
-            std::get<is_internal>(lower_node->m_data)[lower_node->m_key_counter + i] = std::get<is_internal>(higher_node->m_data)[i];
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::erase(const_iterator first, const_iterator last)
+    {
+        if (first == last){
+            return iterator(const_cast<leaf_type*>(last.m_leaf), last.m_index);
+        }
+        std::optional<key_type> hi;
+        if (last != cend()){
+            hi = last.key();
+        }
+        erase_range_impl(key_type(first.key()), hi ? &*hi : nullptr);
+        return hi ? lower_bound(*hi) : end();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <class Predicate> requires std::predicate<Predicate&, const Key&, const Mapped&>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::erase_if(Predicate pred)
+    {
+        size_type erased = 0;
+        // once the leaves are compacted, the tree is repaired even if the predicate threw halfway
+        auto settle = [&](){
+            if (erased == 0){
+                return;
+            }
+            m_size -= erased;
+            if (m_size == 0){
+                erase_all();
+                return;
+            }
+            if (m_height > 0){
+                repair(static_cast<internal_type*>(m_root), m_height);
+            }
+            while (m_height > 0 && m_root->m_key_counter == 1){
+                internal_type* old_root = static_cast<internal_type*>(m_root);
+                m_root = old_root->m_data[0];
+                std::destroy_at(old_root);
+                m_internal_alloc.deallocate(old_root);
+                --m_height;
+            }
+        };
+        try{
+            for (leaf_type* leaf = m_min; leaf != nullptr; leaf = leaf->m_next){
+                size_type kept = 0, i = 0;
+                try{
+                    for (; i < leaf->m_key_counter; ++i){
+                        if (pred(std::as_const(leaf->m_keys[i]), std::as_const(*leaf_type::value_address(leaf->m_data[i])))){
+                            leaf_type::destroy_slot(*this, leaf->m_data[i]);
+                            ++erased;
+                        }
+                        else{
+                            if (kept != i){
+                                leaf->m_keys[kept] = std::move(leaf->m_keys[i]);
+                                leaf->m_data[kept] = std::move(leaf->m_data[i]);
+                            }
+                            ++kept;
+                        }
+                    }
+                }
+                catch(...){
+                    // close the gap left by the erased entries before the throwing one
+                    node_type::erase_at(*leaf, kept, i);
+                    throw;
+                }
+                leaf->m_key_counter = kept;
+                leaf->update_layout();
+            }
         }
+        catch(...){
+            settle();
+            throw;
+        }
+        settle();
+        return erased;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    void BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::erase_all()
+    {
+        // the minimal leaf is detached and kept as the new root, so clearing never allocates
+        m_min->erase_all(*this);
+        if (m_height > 0){
+            internal_type* parent = static_cast<internal_type*>(m_root);
+            for (size_type level = 1; level < m_height; ++level){
+                parent = static_cast<internal_type*>(parent->m_data[0]);
+            }
+            node_type::erase_at(*parent, 0);
+            release();
+        }
+        m_size = 0;
+        m_height = 0;
+        m_root = m_min;
+        m_min->m_next = nullptr;
+        m_max = m_min;
+    }
 
-        lower_node->m_key_counter += higher_node->m_key_counter;
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <std::forward_iterator Iterator> requires requires (Iterator it){
+        Key(it->first);
+        Mapped(it->second);
+    }
+    void BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::bulk_load(Iterator first, Iterator last, double fill_factor)
+    {
+        if (!(fill_factor > 0.0 && fill_factor <= 1.0)){
+            throw std::invalid_argument("BPlusTree::bulk_load: The fill factor must be in (0, 1].\n");
+        }
+        size_type count = 0;
+        for (Iterator it = first, previous = first; it != last; previous = it++, ++count){
+            if (count != 0 && !(previous->first < it->first)){
+                throw std::invalid_argument("BPlusTree::bulk_load: The keys are not strictly increasing.\n");
+            }
+        }
+        size_type target = std::clamp<size_type>((size_type)std::ceil(N * fill_factor), node_type::min_keys, N);
 
-        if (higher_node->m_next){
-            higher_node->m_next->m_prev = lower_node;
+        // the new tree is built on the side, and only replaces the old one once every allocation succeeded
+        size_type leaf_count = bulk_node_count(count, target);
+        std::vector<node_type*> level;
+        std::vector<internal_type*> internals;
+        level.reserve(leaf_count);
+        internals.reserve(leaf_count);
+        leaf_type* first_leaf = nullptr,* last_leaf = nullptr;
+        size_type height = 0;
+        try{
+            for (size_type i = 0; i < leaf_count; ++i){
+                leaf_type* leaf = std::construct_at(m_leaf_alloc.allocate());
+                level.push_back(leaf);
+                leaf->m_prev = last_leaf;
+                if (last_leaf){
+                    last_leaf->m_next = leaf;
+                }
+                else{
+                    first_leaf = leaf;
+                }
+                last_leaf = leaf;
+                size_type entries = count / leaf_count + (i < count % leaf_count);
+                for (; leaf->m_key_counter < entries; ++first){
+                    leaf->m_keys[leaf->m_key_counter] = key_type(first->first);
+                    if constexpr(leaf_type::stores_inline){
+                        leaf->m_data[leaf->m_key_counter] = mapped_type(first->second);
+                    }
+                    else{
+                        typename leaf_type::pointer value = m_val_alloc.allocate();
+                        try{
+                            leaf->m_data[leaf->m_key_counter] = std::construct_at(value, first->second);
+                        }
+                        catch(...){
+                            m_val_alloc.deallocate(value);
+                            throw;
+                        }
+                    }
+                    ++leaf->m_key_counter;
+                }
+                leaf->update_layout();
+            }
+            for (size_type i = bulk_internal_count(leaf_count, target); i > 0; --i){
+                internals.push_back(std::construct_at(m_internal_alloc.allocate()));
+            }
+            height = bulk_build_levels(level, internals, target);
+        }
+        catch(...){
+            for (internal_type* internal : internals){
+                std::destroy_at(internal);
+                m_internal_alloc.deallocate(internal);
+            }
+            while (first_leaf != nullptr){
+                leaf_type* next = first_leaf->m_next;
+                first_leaf->erase_all(*this);
+                std::destroy_at(first_leaf);
+                m_leaf_alloc.deallocate(first_leaf);
+                first_leaf = next;
+            }
+            throw;
         }
-        lower_node->m_next = higher_node->m_next;
 
-        std::destroy_at(higher_node);
-        m_node_alloc.deallocate(higher_node);
+        release();
+        m_root = level[0];
+        m_height = height;
+        m_size = count;
+        m_min = first_leaf;
+        m_max = last_leaf;
     }
 
-    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator NodeAlloc>
-    typename BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::node_type *BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::copy(const typename BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::node_type *source, const typename BPlusTree<Key, Mapped, N, ValueAlloc, NodeAlloc>::node_type *prev, bool has_min, bool has_max)
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment> BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::split(const key_type& key)
     {
-        node_type* out = std::construct_at(m_node_alloc.allocate(), source->m_data.index());
-        out->m_prev = prev;
-        if (prev){
-            prev->m_next = out;
+        BPlusTree higher;
+        higher.m_append_fill = m_append_fill;
+        if (m_size == 0 || m_max->m_keys[m_max->m_key_counter - 1] < key){
+            return higher;
         }
-        out->m_key_counter = source->m_key_counter;
-        for (size_type i = 0; i < out->m_key_counter; ++i){
-            out->m_keys[i] = source->m_keys[i];
+        if (!(m_min->m_keys[0] < key)){
+            exchange(higher);
+            return higher;
         }
-        if (source->m_data.index() == 0){
-            for (size_type i = 0; i < out->m_key_counter; ++i){
-                std::get<0>(out->m_data)[i] = new value_type (std::get<0>(source->m_data)[i]);
+
+        // every node of the higher part's cut path is allocated up front, so a failure leaves the tree intact
+        std::array<internal_type*, max_height> fresh_nodes;
+        size_type allocated = 0;
+        try{
+            for (; allocated < m_height; ++allocated){
+                fresh_nodes[allocated] = std::construct_at(m_internal_alloc.allocate());
             }
-            if (has_min){
-                m_min = out;
+        }
+        catch(...){
+            while (allocated > 0){
+                --allocated;
+                std::destroy_at(fresh_nodes[allocated]);
+                m_internal_alloc.deallocate(fresh_nodes[allocated]);
+            }
+            throw;
+        }
+
+        std::array<internal_type*, max_height> path;
+        std::array<size_type, max_height> indices;
+        node_type* node = m_root;
+        for (size_type level = 0; level < m_height; ++level){
+            path[level] = static_cast<internal_type*>(node);
+            indices[level] = path[level]->child_index(key);
+            node = path[level]->m_data[indices[level]];
+        }
+        leaf_type* leaf = static_cast<leaf_type*>(node);
+        size_type index = leaf->find_smallest_bigger_key_index(key);
+        index -= (index != 0 && leaf->m_keys[index - 1] == key);
+
+        // the leaf is cut in two, and either part is dropped if it is left empty
+        leaf_type* higher_leaf = static_cast<leaf_type*>(higher.m_root);
+        leaf_type* lower_last = (index != 0) ? leaf : leaf->m_prev;
+        leaf_type* higher_first = (index != leaf->m_key_counter) ? higher_leaf : leaf->m_next;
+        higher.m_max = (m_max == leaf) ? higher_leaf : m_max;
+        if (index != leaf->m_key_counter){
+            node_type::redistribute(*leaf, *higher_leaf, index);
+            higher_leaf->m_next = leaf->m_next;
+            if (leaf->m_next){
+                leaf->m_next->m_prev = higher_leaf;
+            }
+        }
+        lower_last->m_next = nullptr;
+        higher_first->m_prev = nullptr;
+        m_max = lower_last;
+        higher.m_min = higher_first;
+        node_type* lower_part = leaf,* higher_part = higher_leaf;
+        if (index == 0){
+            release(leaf, 0);
+            lower_part = nullptr;
+        }
+        if (higher_leaf->m_key_counter == 0){
+            std::destroy_at(higher_leaf);
+            higher.m_leaf_alloc.deallocate(higher_leaf);
+            higher_part = nullptr;
+        }
+
+        // then every node on the path keeps its subnodes before the cut, and a new node takes the ones after it
+        for (size_type level = m_height; level > 0; --level){
+            internal_type* parent = path[level - 1],* sibling = fresh_nodes[level - 1];
+            size_type cut = indices[level - 1];
+            node_type::redistribute(*parent, *sibling, cut + 1);
+            if (higher_part != nullptr){
+                node_type::insert_at(*sibling, 0, key_type(higher_part->m_keys[0]), std::move(higher_part));
+                sibling->refresh_summary(0, level != m_height);
+            }
+            if (lower_part == nullptr){
+                node_type::erase_at(*parent, cut);
             }
-            if (has_max){
-                m_max = out;
+            else{
+                parent->refresh_summary(cut, level != m_height);
             }
+            lower_part = parent;
+            higher_part = sibling;
+            if (parent->m_key_counter == 0){
+                std::destroy_at(parent);
+                m_internal_alloc.deallocate(parent);
+                lower_part = nullptr;
+            }
+            if (sibling->m_key_counter == 0){
+                std::destroy_at(sibling);
+                m_internal_alloc.deallocate(sibling);
+                higher_part = nullptr;
+            }
+        }
+        m_root = lower_part;
+        higher.m_root = higher_part;
+        higher.m_height = m_height;
+
+        if constexpr(internal_type::keeps_summaries){
+            higher.m_size = (m_height == 0) ? higher_part->m_key_counter : Augment::count(static_cast<internal_type*>(higher_part)->summary());
         }
         else{
-            size_type i = 0;
-            std::get<1>(out->m_data)[i] = copy (std::get<1>(source->m_data)[i], nullptr, has_min, false);
-            for (++i; i < out->m_key_counter - 1; ++i){
-                std::get<1>(out->m_data)[i] = copy (std::get<1>(source->m_data)[i], std::get<1>(out->m_data)[i - 1], false, false);
+            // walks both parts away from the cut, counting the entries of the one that ends first
+            size_type counted = 0;
+            leaf_type* down = lower_last,* up = higher_first;
+            for (; down != nullptr && up != nullptr; down = down->m_prev, up = up->m_next){
+                counted += up->m_key_counter;
             }
-            std::get<1>(out->m_data)[i] = copy (std::get<1>(source->m_data)[i], std::get<1>(out->m_data)[i - 1], false, has_max);
+            if (up == nullptr){
+                higher.m_size = counted;
+            }
+            else{
+                for (counted = 0, down = lower_last; down != nullptr; down = down->m_prev){
+                    counted += down->m_key_counter;
+                }
+                higher.m_size = m_size - counted;
+            }
+        }
+        m_size -= higher.m_size;
+
+        // the nodes along the cut may be left underfull, or with a single subnode
+        for (BPlusTree* part : {this, &higher}){
+            while (part->m_height > 0 && part->m_root->m_key_counter == 1){
+                internal_type* old_root = static_cast<internal_type*>(part->m_root);
+                part->m_root = old_root->m_data[0];
+                std::destroy_at(old_root);
+                part->m_internal_alloc.deallocate(old_root);
+                --part->m_height;
+            }
+        }
+        key_type lower_seam = m_max->m_keys[m_max->m_key_counter - 1], higher_seam = higher.m_min->m_keys[0];
+        rebalance_path(lower_seam);
+        higher.rebalance_path(higher_seam);
+        return higher;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    void BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::join(BPlusTree&& other)
+    {
+        if (this == &other || other.m_size == 0){
+            return;
+        }
+        if (m_size == 0){
+            exchange(other);
+            return;
+        }
+        bool this_lower = m_max->m_keys[m_max->m_key_counter - 1] < other.m_min->m_keys[0];
+        if (!this_lower && !(other.m_max->m_keys[other.m_max->m_key_counter - 1] < m_min->m_keys[0])){
+            throw std::invalid_argument("BPlusTree::join: The key ranges of the trees overlap.\n");
+        }
+        BPlusTree& lower = this_lower ? *this : other,& higher = this_lower ? other : *this;
+        key_type lower_seam = lower.m_max->m_keys[lower.m_max->m_key_counter - 1], higher_seam = higher.m_min->m_keys[0];
+
+        // the other tree is handed a new empty root, allocated before anything changes
+        leaf_type* empty_leaf = std::construct_at(m_leaf_alloc.allocate());
+        BPlusTree& taller = (lower.m_height >= higher.m_height) ? lower : higher;
+        BPlusTree& shorter = (&taller == &lower) ? higher : lower;
+        try{
+            taller.graft(shorter.m_root, shorter.m_height, &taller == &lower);
+        }
+        catch(...){
+            std::destroy_at(empty_leaf);
+            m_leaf_alloc.deallocate(empty_leaf);
+            throw;
+        }
+        lower.m_max->m_next = higher.m_min;
+        higher.m_min->m_prev = lower.m_max;
+        taller.m_min = lower.m_min;
+        taller.m_max = higher.m_max;
+        taller.m_size = lower.m_size + higher.m_size;
+        if (&taller != this){
+            exchange(other);
+        }
+        other.m_root = other.m_min = other.m_max = empty_leaf;
+        other.m_size = 0;
+        other.m_height = 0;
+
+        // the nodes along the seam may be underfull, being former roots or rightmost nodes
+        rebalance_path(lower_seam);
+        rebalance_path(higher_seam);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::mapped_type& BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::at(const key_type &key) requires (!Augment::reads_values)
+    {
+        pointer search_result = find_leaf(key)->search(key);
+        if (search_result){
+            return *search_result;
+        }
+        throw std::out_of_range("BPlusTree::at: No value associated with the key was found.\n");
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    const BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::mapped_type& BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::at(const key_type &key) const
+    {
+        pointer search_result = find_leaf(key)->search(key);
+        if (search_result){
+            return *search_result;
+        }
+        throw std::out_of_range("BPlusTree::at: No value associated with the key was found.\n");
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    bool BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::contains(const key_type &key) const
+    {
+        return nullptr != find_leaf(key)->search(key);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::multi_get(std::span<const key_type> keys, std::span<mapped_type*> results) requires (!Augment::reads_values)
+    {
+        if (results.size() < keys.size()){
+            throw std::invalid_argument("BPlusTree::multi_get: There are fewer results than keys.\n");
+        }
+        size_type found = 0;
+        for (size_type first = 0; first < keys.size(); first += multi_get_group){
+            found += lookup_group(keys.data() + first, results.data() + first, std::min(multi_get_group, keys.size() - first));
+        }
+        return found;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::multi_get(std::span<const key_type> keys, std::span<const mapped_type*> results) const
+    {
+        if (results.size() < keys.size()){
+            throw std::invalid_argument("BPlusTree::multi_get: There are fewer results than keys.\n");
+        }
+        size_type found = 0;
+        for (size_type first = 0; first < keys.size(); first += multi_get_group){
+            found += lookup_group(keys.data() + first, results.data() + first, std::min(multi_get_group, keys.size() - first));
+        }
+        return found;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::rank(const key_type &key) const requires Augment::enabled
+    {
+        return rank_impl(key);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <bool Multi>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::rank_impl(const key_type &key) const
+    {
+        size_type result = 0;
+        node_type* node = m_root;
+        for (size_type level = 0; level < m_height; ++level){
+            auto internal = static_cast<internal_type*>(node);
+            size_type index = Multi ? internal->first_child_index(key) : internal->child_index(key);
+            for (size_type i = 0; i < index; ++i){
+                result += Augment::count(internal->m_summaries[i]);
+            }
+            node = internal->m_data[index];
+        }
+        auto leaf = static_cast<leaf_type*>(node);
+        if constexpr(Multi){
+            return result + leaf->find_smallest_not_smaller_key_index(key);
+        }
+        size_type index = leaf->find_smallest_bigger_key_index(key);
+        if (index != 0 && leaf->m_keys[index - 1] == key){
+            --index;
+        }
+        return result + index;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::select(size_type k) requires Augment::enabled
+    {
+        if (k >= m_size){
+            throw std::out_of_range("BPlusTree::select: The tree has no key of the given rank.\n");
+        }
+        node_type* node = m_root;
+        for (size_type level = 0; level < m_height; ++level){
+            auto internal = static_cast<internal_type*>(node);
+            size_type index = 0;
+            for (; k >= Augment::count(internal->m_summaries[index]); ++index){
+                k -= Augment::count(internal->m_summaries[index]);
+            }
+            node = internal->m_data[index];
+        }
+        return iterator(static_cast<leaf_type*>(node), k);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_iterator BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::select(size_type k) const requires Augment::enabled
+    {
+        return const_cast<BPlusTree*>(this)->select(k);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::count_range(const key_type &lo, const key_type &hi) const requires Augment::enabled
+    {
+        if (!(lo < hi)){
+            return 0;
+        }
+        return rank(hi) - rank(lo);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    typename Augment::aggregate_type BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::aggregate(const key_type &lo, const key_type &hi) const requires Augment::enabled
+    {
+        if (!(lo < hi)){
+            return Augment::aggregate(Augment::identity());
+        }
+        return Augment::aggregate(summarize_range(m_root, m_height, &lo, &hi));
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                         BPlusTree Iteration API Block                        //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::begin()
+    {
+        return iterator(m_min, 0);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_iterator BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::begin() const
+    {
+        return const_iterator(m_min, 0);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_iterator BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::cbegin() const
+    {
+        return begin();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::end()
+    {
+        return iterator(m_max, m_max->m_key_counter);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_iterator BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::end() const
+    {
+        return const_iterator(m_max, m_max->m_key_counter);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_iterator BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::cend() const
+    {
+        return end();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::reverse_iterator BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::rbegin()
+    {
+        return reverse_iterator(end());
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_reverse_iterator BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::rbegin() const
+    {
+        return const_reverse_iterator(end());
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_reverse_iterator BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::crbegin() const
+    {
+        return rbegin();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::reverse_iterator BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::rend()
+    {
+        return reverse_iterator(begin());
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_reverse_iterator BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::rend() const
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_reverse_iterator BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::crend() const
+    {
+        return rend();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::lower_bound(const key_type &key)
+    {
+        return bound<false>(key);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_iterator BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::lower_bound(const key_type &key) const
+    {
+        return bound<false>(key);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::upper_bound(const key_type &key)
+    {
+        return bound<true>(key);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_iterator BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::upper_bound(const key_type &key) const
+    {
+        return bound<true>(key);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    std::pair<typename BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator, typename BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator> BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::equal_range(const key_type &key)
+    {
+        iterator lower = bound<false>(key), upper = lower;
+        if (upper != end() && upper.key() == key){
+            ++upper;
+        }
+        return {lower, upper};
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    std::pair<typename BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_iterator, typename BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_iterator> BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::equal_range(const key_type &key) const
+    {
+        iterator lower = bound<false>(key), upper = lower;
+        if (upper != end() && upper.key() == key){
+            ++upper;
+        }
+        return {lower, upper};
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::find(const key_type &key)
+    {
+        iterator found = bound<false>(key);
+        if (found != end() && found.key() == key){
+            return found;
+        }
+        return end();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_iterator BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::find(const key_type &key) const
+    {
+        iterator found = bound<false>(key);
+        if (found != end() && found.key() == key){
+            return found;
+        }
+        return end();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::find_from(const_iterator hint, const key_type &key)
+    {
+        leaf_type* leaf = (hint.m_leaf != nullptr) ? hinted_leaf(hint.m_leaf, key) : nullptr;
+        if (leaf == nullptr){
+            return find(key);
+        }
+        size_type index = leaf->find_smallest_bigger_key_index(key);
+        if (index != 0 && leaf->m_keys[index - 1] == key){
+            return iterator(leaf, index - 1);
+        }
+        return end();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::const_iterator BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::find_from(const_iterator hint, const key_type &key) const
+    {
+        return const_cast<BPlusTree*>(this)->find_from(hint, key);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <bool Prefetch, class Function> requires (!Augment::reads_values && std::invocable<Function&, const Key&, Mapped&>)
+    void BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::for_each_in_range(const key_type &lo, const key_type &hi, Function func)
+    {
+        iterator first = bound<false>(lo);
+        scan<Prefetch>(first.m_leaf, first.m_index, hi, func);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <bool Prefetch, class Function> requires std::invocable<Function&, const Key&, const Mapped&>
+    void BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::for_each_in_range(const key_type &lo, const key_type &hi, Function func) const
+    {
+        auto const_func = [&func](const key_type& key, const mapped_type& mapped){ func(key, mapped); };
+        iterator first = bound<false>(lo);
+        scan<Prefetch>(first.m_leaf, first.m_index, hi, const_func);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                       BPlusTree Internal Helpers Block                       //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <bool First>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::leaf_type* BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::find_leaf(const key_type &key) const
+    {
+        node_type* node = m_root;
+        for (size_type level = 0; level < m_height; ++level){
+            auto internal = static_cast<internal_type*>(node);
+            node = internal->m_data[First ? internal->first_child_index(key) : internal->child_index(key)];
+        }
+        return static_cast<leaf_type*>(node);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <class Pointer>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::lookup_group(const key_type* keys, Pointer* results, size_type count) const
+    {
+        // every lookup of the group takes one step down before any takes the next, so while a node is searched
+        // the prefetches of the nodes the other lookups just stepped to are still in flight
+        std::array<node_type*, multi_get_group> nodes;
+        nodes.fill(m_root);
+        for (size_type level = 0; level < m_height; ++level){
+            bool leaves_next = (level + 1 == m_height);
+            for (size_type i = 0; i < count; ++i){
+                auto internal = static_cast<internal_type*>(nodes[i]);
+                nodes[i] = internal->m_data[internal->child_index(keys[i])];
+                if (leaves_next){
+                    static_cast<leaf_type*>(nodes[i])->prefetch();
+                }
+                else{
+                    static_cast<internal_type*>(nodes[i])->prefetch();
+                }
+            }
+        }
+        size_type found = 0;
+        for (size_type i = 0; i < count; ++i){
+            results[i] = static_cast<leaf_type*>(nodes[i])->search(keys[i]);
+            found += (results[i] != nullptr);
+        }
+        return found;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::leaf_type* BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::hinted_leaf(const leaf_type* hint, const key_type &key) const
+    {
+        // a leaf holds the keys from its first key (any key, for m_min) up to the first key of the next leaf
+        if (hint->m_key_counter == 0){
+            return nullptr;
+        }
+        if (hint != m_min && key < hint->m_keys[0]){
+            leaf_type* prev = hint->m_prev;
+            return (prev == m_min || !(key < prev->m_keys[0])) ? prev : nullptr;
+        }
+        if (hint->m_next != nullptr && !(key < hint->m_next->m_keys[0])){
+            leaf_type* next = hint->m_next;
+            return (next->m_next == nullptr || key < next->m_next->m_keys[0]) ? next : nullptr;
+        }
+        return const_cast<leaf_type*>(hint);     // the tree owns its leaves
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <bool Upper, bool Multi>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::iterator BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::bound(const key_type &key) const
+    {
+        if constexpr(Multi && !Upper){
+            leaf_type* leaf = find_leaf<true>(key);
+            return iterator(leaf, leaf->find_smallest_not_smaller_key_index(key));
+        }
+        leaf_type* leaf = find_leaf(key);
+        size_type index = leaf->find_smallest_bigger_key_index(key);
+        if (!Upper && index != 0 && leaf->m_keys[index - 1] == key){
+            --index;
+        }
+        return iterator(leaf, index);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::count_equal(const_iterator first, const key_type &key) const
+    {
+        size_type count = 0;
+        const leaf_type* leaf = first.m_leaf;
+        for (size_type index = first.m_index; leaf != nullptr; leaf = leaf->m_next, index = 0){
+            size_type end = leaf->find_smallest_bigger_key_index(key);
+            count += end - index;
+            if (end != leaf->m_key_counter){
+                break;
+            }
+        }
+        return count;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <bool Prefetch, class Function>
+    void BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::scan(leaf_type* leaf, size_type index, const key_type &hi, Function& func) const
+    {
+        // `ahead` runs up to look_ahead leaves in front of the scan, and is prefetched whenever it moves.
+        // By the time its link is followed again it has long arrived, so the look-ahead itself rarely misses
+        constexpr size_type look_ahead = std::max<size_type>(2, 64 / N);
+        leaf_type* ahead = leaf;
+        size_type distance = 0;
+        for (; leaf != nullptr; leaf = leaf->m_next, index = 0){
+            if constexpr(Prefetch){
+                while (distance < look_ahead && ahead->m_next != nullptr && ahead->m_keys[ahead->m_key_counter - 1] < hi){
+                    ahead = ahead->m_next;
+                    ahead->prefetch();
+                    ++distance;
+                }
+            }
+            // the values of the next leaf are requested one per visited entry, rather than all at once,
+            // so that they do not compete with the leaves for the processor's few outstanding misses
+            const leaf_type* next = (Prefetch && distance > 0) ? leaf->m_next : nullptr;
+            for (; index < leaf->m_key_counter; ++index){
+                if (!(leaf->m_keys[index] < hi)) return;
+                if constexpr(Prefetch && !leaf_type::stores_inline){
+                    if (next != nullptr && index < next->m_key_counter){
+                        next->prefetch_value(index);
+                    }
+                }
+                func(leaf->m_keys[index], *leaf_type::value_address(leaf->m_data[index]));
+            }
+            if constexpr(Prefetch){
+                if (distance == 0){
+                    ahead = leaf->m_next;
+                }
+                else{
+                    --distance;
+                }
+            }
+        }
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    void BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::refresh_separators(const std::array<internal_type*, max_height>& path, const std::array<size_type, max_height>& indices, const key_type& smallest)
+    {
+        // separators equal to the smallest key under them make a leaf's key range [its first key, the next leaf's first key),
+        // which lets hints place a key by its leaf alone
+        for (size_type level = m_height; level > 0; --level){
+            path[level - 1]->m_keys[indices[level - 1]] = smallest;
+            path[level - 1]->update_layout();
+            if (indices[level - 1] != 0){
+                break;
+            }
+        }
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    void BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::refresh_path(const std::array<internal_type*, max_height>& path, const std::array<size_type, max_height>& indices, size_type level)
+    {
+        if constexpr(internal_type::keeps_summaries){
+            for (; level > 0; --level){
+                path[level - 1]->refresh_summary(indices[level - 1], level != m_height);
+            }
+        }
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <bool Multi>
+    typename Augment::summary_type BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::summarize_range(const node_type* node, size_type height, const key_type* lo, const key_type* hi) const
+    {
+        typename Augment::summary_type result = Augment::identity();
+        if (height == 0){
+            auto leaf = static_cast<const leaf_type*>(node);
+            for (size_type i = 0; i < leaf->m_key_counter; ++i){
+                if ((lo == nullptr || !(leaf->m_keys[i] < *lo)) && (hi == nullptr || leaf->m_keys[i] < *hi)){
+                    result = Augment::combine(result, Augment::lift(leaf->m_keys[i], *leaf_type::value_address(leaf->m_data[i])));
+                }
+            }
+            return result;
+        }
+        auto internal = static_cast<const internal_type*>(node);
+        size_type first = (lo != nullptr) ? (Multi ? internal->first_child_index(*lo) : internal->child_index(*lo)) : 0;
+        size_type last = (hi != nullptr) ? (Multi ? internal->first_child_index(*hi) : internal->child_index(*hi)) : internal->m_key_counter - 1;
+        if (first == last){
+            return summarize_range<Multi>(internal->m_data[first], height - 1, lo, hi);
+        }
+        // the subnodes strictly between the two ends lie entirely inside the range
+        result = summarize_range<Multi>(internal->m_data[first], height - 1, lo, nullptr);
+        for (size_type i = first + 1; i < last; ++i){
+            result = Augment::combine(result, internal->m_summaries[i]);
+        }
+        return Augment::combine(result, summarize_range<Multi>(internal->m_data[last], height - 1, nullptr, hi));
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::bulk_node_count(size_type entries, size_type target)
+    {
+        if (entries <= N){
+            return 1;
+        }
+        size_type nodes = (entries + target - 1) / target;
+        if (entries / nodes < node_type::min_keys){   // a short last node is avoided by spreading over fewer nodes
+            nodes = entries / node_type::min_keys;
+        }
+        return nodes;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::bulk_internal_count(size_type leaves, size_type target)
+    {
+        size_type total = 0;
+        for (size_type nodes = leaves; nodes > 1; total += nodes){
+            nodes = bulk_node_count(nodes, target);
+        }
+        return total;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::bulk_build_levels(std::vector<node_type*>& level, const std::vector<internal_type*>& internals, size_type target)
+    {
+        size_type height = 0, used = 0;
+        while (level.size() > 1){
+            size_type children = level.size(), parent_count = bulk_node_count(children, target);
+            for (size_type i = 0, child = 0; i < parent_count; ++i){
+                internal_type* parent = internals[used++];
+                size_type entries = children / parent_count + (i < children % parent_count);
+                for (; parent->m_key_counter < entries; ++child){
+                    parent->m_keys[parent->m_key_counter] = level[child]->m_keys[0];
+                    parent->m_data[parent->m_key_counter] = level[child];
+                    ++parent->m_key_counter;
+                }
+                parent->update_layout();
+                parent->refresh_summaries(height != 0);
+                level[i] = parent;      // the children of the nodes after this one are further down the level
+            }
+            level.resize(parent_count);
+            ++height;
+        }
+        return height;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    void BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::release()
+    {
+        release(m_root, m_height);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    void BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::release(node_type* node, size_type height)
+    {
+        if (height == 0){
+            auto leaf = static_cast<leaf_type*>(node);
+            leaf->erase_all(*this);
+            std::destroy_at(leaf);
+            m_leaf_alloc.deallocate(leaf);
+        }
+        else{
+            auto internal = static_cast<internal_type*>(node);
+            internal->erase_all(*this, height);
+            std::destroy_at(internal);
+            m_internal_alloc.deallocate(internal);
+        }
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <bool Multi>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::erase_range_impl(const key_type& lo, const key_type* hi)
+    {
+        // the bounds may live in entries about to be erased
+        key_type lower = lo;
+        std::optional<key_type> higher;
+        if (hi != nullptr){
+            if (!(lo < *hi)){
+                return 0;
+            }
+            higher = *hi;
+        }
+        iterator first = bound<false, Multi>(lower), last = higher ? bound<false, Multi>(*higher) : end();
+        if (first == last){
+            return 0;
+        }
+        size_type erased = 0;
+        for (leaf_type* leaf = first.m_leaf; ; leaf = leaf->m_next){
+            erased += ((leaf == last.m_leaf) ? last.m_index : leaf->m_key_counter) - ((leaf == first.m_leaf) ? first.m_index : 0);
+            if (leaf == last.m_leaf){
+                break;
+            }
+        }
+        if (erased == m_size){
+            erase_all();
+            return erased;
+        }
+
+        // the leaves holding the entries right before and right after the range survive, and are linked to each other
+        // up front, so the leaves in between can be released along with their subtrees
+        std::optional<key_type> before, after;
+        leaf_type* previous = nullptr,* next = nullptr;
+        if (first != begin()){
+            previous = (first.m_index != 0) ? first.m_leaf : first.m_leaf->m_prev;
+            before = std::prev(first).key();
+        }
+        if (last != end()){
+            next = last.m_leaf;
+            after = last.key();
+        }
+        if (previous != next){
+            (previous ? previous->m_next : m_min) = next;
+            (next ? next->m_prev : m_max) = previous;
+        }
+        erase_range_in<Multi>(m_root, m_height, lower, higher ? &*higher : nullptr);
+        m_size -= erased;
+
+        // with repeated keys, the entry before the range is still the last one with its key, but the entry after it
+        // may be followed by more with the same key
+        if (before){
+            rebalance_path(*before);
+        }
+        if (after){
+            rebalance_path<Multi>(*after);
+        }
+        return erased;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <bool Multi>
+    void BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::erase_range_in(node_type* node, size_type height, const key_type& lo, const key_type* hi)
+    {
+        if (height == 0){
+            auto leaf = static_cast<leaf_type*>(node);
+            size_type from, to = leaf->m_key_counter;
+            if constexpr(Multi){
+                from = leaf->find_smallest_not_smaller_key_index(lo);
+                if (hi != nullptr){
+                    to = leaf->find_smallest_not_smaller_key_index(*hi);
+                }
+            }
+            else{
+                from = leaf->find_smallest_bigger_key_index(lo);
+                from -= (from != 0 && leaf->m_keys[from - 1] == lo);
+                if (hi != nullptr){
+                    to = leaf->find_smallest_bigger_key_index(*hi);
+                    to -= (to != 0 && leaf->m_keys[to - 1] == *hi);
+                }
+            }
+            if (from < to){
+                for (size_type i = from; i < to; ++i){
+                    leaf_type::destroy_slot(*this, leaf->m_data[i]);
+                }
+                node_type::erase_at(*leaf, from, to);
+            }
+            return;
+        }
+
+        // the subnodes strictly between the ones holding the ends of the range lie inside it
+        auto internal = static_cast<internal_type*>(node);
+        size_type first = Multi ? internal->first_child_index(lo) : internal->child_index(lo);
+        size_type last = (hi != nullptr) ? (Multi ? internal->first_child_index(*hi) : internal->child_index(*hi)) : internal->m_key_counter - 1;
+        for (size_type i = first + 1; i < last; ++i){
+            release(internal->m_data[i], height - 1);
+        }
+        if (last != first){
+            erase_range_in<Multi>(internal->m_data[last], height - 1, lo, hi);
+        }
+        erase_range_in<Multi>(internal->m_data[first], height - 1, lo, hi);
+
+        // the subnodes at the ends are dropped too if nothing is left in them
+        bool first_kept = internal->m_data[first]->m_key_counter != 0;
+        bool last_kept = last != first && internal->m_data[last]->m_key_counter != 0;
+        if (!first_kept){
+            release(internal->m_data[first], height - 1);
+        }
+        if (last != first && !last_kept){
+            release(internal->m_data[last], height - 1);
+        }
+        size_type begin = first + first_kept, end = last_kept ? last : std::max(first, last) + 1;
+        node_type::erase_at(*internal, begin, end);
+        for (size_type i : {first, begin}){
+            if ((i == first && first_kept) || (i == begin && last_kept)){
+                internal->m_keys[i] = internal->m_data[i]->m_keys[0];
+                internal->refresh_summary(i, height != 1);
+            }
+        }
+        internal->update_layout();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <bool Multi>
+    void BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::rebalance_path(const key_type& key)
+    {
+        // an underfull node whose parent has no other subnode can only be refilled once the parent is, so the path
+        // is walked again until nothing on it is left underfull
+        std::array<internal_type*, max_height> path;
+        for (bool stuck = true; stuck; ){
+            stuck = false;
+            node_type* node = m_root;
+            for (size_type level = 0; level < m_height; ++level){
+                path[level] = static_cast<internal_type*>(node);
+                node = path[level]->m_data[Multi ? first_holder_index(path[level], m_height - level, key) : path[level]->child_index(key)];
+            }
+            for (size_type level = m_height; level > 0; --level){
+                internal_type* parent = path[level - 1];
+                size_type index = Multi ? first_holder_index(parent, m_height - level + 1, key) : parent->child_index(key);
+                while (parent->m_key_counter > 1 && parent->m_data[index]->m_key_counter < node_type::min_keys){
+                    if (level == m_height){
+                        parent->template handle_underflow<false>(*this, index);
+                    }
+                    else{
+                        parent->template handle_underflow<true>(*this, index);
+                    }
+                    index = Multi ? first_holder_index(parent, m_height - level + 1, key) : parent->child_index(key);
+                }
+                stuck = stuck || parent->m_data[index]->m_key_counter < node_type::min_keys;
+            }
+            while (m_height > 0 && m_root->m_key_counter == 1){
+                internal_type* old_root = static_cast<internal_type*>(m_root);
+                m_root = old_root->m_data[0];
+                std::destroy_at(old_root);
+                m_internal_alloc.deallocate(old_root);
+                --m_height;
+            }
+        }
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::first_holder_index(const internal_type* node, size_type height, const key_type& key) const
+    {
+        size_type index = node->first_child_index(key);
+        if (index + 1 < node->m_key_counter && node->m_keys[index + 1] == key){
+            const node_type* last = node->m_data[index];
+            for (size_type level = height - 1; level > 0; --level){
+                auto internal = static_cast<const internal_type*>(last);
+                last = internal->m_data[internal->m_key_counter - 1];
+            }
+            index += last->m_keys[last->m_key_counter - 1] < key;
+        }
+        return index;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <bool Replace>
+    BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::merge_from(BPlusTree&& other)
+    {
+        if (this == &other || other.m_size == 0){
+            return 0;
+        }
+        if (m_size == 0 || m_max->m_keys[m_max->m_key_counter - 1] < other.m_min->m_keys[0] || other.m_max->m_keys[other.m_max->m_key_counter - 1] < m_min->m_keys[0]){
+            size_type added = other.m_size;
+            join(std::move(other));
+            return added;
+        }
+
+        // the merged entries are counted first, so that every node of the result is allocated before anything moves
+        size_type count = 0;
+        for (const_iterator mine = cbegin(), theirs = other.cbegin(); mine != cend() || theirs != other.cend(); ++count){
+            bool from_mine = theirs == other.cend() || (mine != cend() && !(theirs.key() < mine.key()));
+            bool from_theirs = mine == cend() || (theirs != other.cend() && !(mine.key() < theirs.key()));
+            if (from_mine){
+                ++mine;
+            }
+            if (from_theirs){
+                ++theirs;
+            }
+        }
+        size_type leaf_count = bulk_node_count(count, N);
+        std::vector<node_type*> level;
+        std::vector<internal_type*> internals;
+        leaf_type* empty_leaf = nullptr;      // the other tree's new root
+        try{
+            level.reserve(leaf_count);
+            empty_leaf = std::construct_at(m_leaf_alloc.allocate());
+            for (size_type i = 0; i < leaf_count; ++i){
+                level.push_back(std::construct_at(m_leaf_alloc.allocate()));
+            }
+            for (size_type i = bulk_internal_count(leaf_count, N); i > 0; --i){
+                internals.push_back(std::construct_at(m_internal_alloc.allocate()));
+            }
+        }
+        catch(...){
+            for (internal_type* internal : internals){
+                std::destroy_at(internal);
+                m_internal_alloc.deallocate(internal);
+            }
+            for (node_type* leaf : level){
+                std::destroy_at(static_cast<leaf_type*>(leaf));
+                m_leaf_alloc.deallocate(static_cast<leaf_type*>(leaf));
+            }
+            if (empty_leaf != nullptr){
+                std::destroy_at(empty_leaf);
+                m_leaf_alloc.deallocate(empty_leaf);
+            }
+            throw;
+        }
+        release_internals(m_root, m_height);
+        other.release_internals(other.m_root, other.m_height);
+
+        // both leaf chains are consumed in key order, and each of their leaves is released once its last entry moves out
+        leaf_type* mine = m_min,* theirs = other.m_min;
+        size_type mine_index = 0, theirs_index = 0, added = 0;
+        auto advance = [](BPlusTree& owner, leaf_type*& leaf, size_type& index){
+            if (++index == leaf->m_key_counter){
+                leaf_type* next = leaf->m_next;
+                std::destroy_at(leaf);
+                owner.m_leaf_alloc.deallocate(leaf);
+                leaf = next;
+                index = 0;
+            }
+        };
+        leaf_type* previous = nullptr;
+        for (size_type i = 0; i < leaf_count; ++i){
+            leaf_type* leaf = static_cast<leaf_type*>(level[i]);
+            leaf->m_prev = previous;
+            if (previous){
+                previous->m_next = leaf;
+            }
+            previous = leaf;
+            size_type entries = count / leaf_count + (i < count % leaf_count);
+            for (; leaf->m_key_counter < entries; ++leaf->m_key_counter){
+                bool from_mine = theirs == nullptr || (mine != nullptr && !(theirs->m_keys[theirs_index] < mine->m_keys[mine_index]));
+                bool from_theirs = mine == nullptr || (theirs != nullptr && !(mine->m_keys[mine_index] < theirs->m_keys[theirs_index]));
+                if (from_mine && from_theirs){
+                    // the key is in both trees, and only one of its values is kept
+                    if constexpr(Replace){
+                        leaf_type::destroy_slot(*this, mine->m_data[mine_index]);
+                        advance(*this, mine, mine_index);
+                        from_mine = false;
+                    }
+                    else{
+                        leaf_type::destroy_slot(other, theirs->m_data[theirs_index]);
+                        advance(other, theirs, theirs_index);
+                    }
+                }
+                else{
+                    added += from_theirs;
+                }
+                BPlusTree& owner = from_mine ? *this : other;
+                leaf_type*& source = from_mine ? mine : theirs;
+                size_type& index = from_mine ? mine_index : theirs_index;
+                leaf->m_keys[leaf->m_key_counter] = std::move(source->m_keys[index]);
+                leaf->m_data[leaf->m_key_counter] = std::move(source->m_data[index]);
+                advance(owner, source, index);
+            }
+            leaf->update_layout();
+        }
+
+        m_min = static_cast<leaf_type*>(level[0]);
+        m_max = previous;
+        m_height = bulk_build_levels(level, internals, N);
+        m_root = level[0];
+        m_size = count;
+        other.m_root = other.m_min = other.m_max = empty_leaf;
+        other.m_size = 0;
+        other.m_height = 0;
+        return added;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    void BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::release_internals(node_type* node, size_type height)
+    {
+        if (height == 0){
+            return;
+        }
+        auto internal = static_cast<internal_type*>(node);
+        if (height > 1){
+            for (size_type i = 0; i < internal->m_key_counter; ++i){
+                release_internals(internal->m_data[i], height - 1);
+            }
+        }
+        std::destroy_at(internal);
+        m_internal_alloc.deallocate(internal);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    void BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::exchange(BPlusTree& other)
+    {
+        std::swap(m_size, other.m_size);
+        std::swap(m_height, other.m_height);
+        std::swap(m_root, other.m_root);
+        std::swap(m_min, other.m_min);
+        std::swap(m_max, other.m_max);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    void BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::graft(node_type* subtree, size_type height, bool at_end)
+    {
+        std::array<internal_type*, max_height> path;
+        std::array<size_type, max_height> indices;
+        size_type levels = m_height - height;       // the number of spine nodes above the subtree's level
+        node_type* node = m_root;
+        for (size_type level = 0; level < levels; ++level){
+            path[level] = static_cast<internal_type*>(node);
+            indices[level] = at_end ? path[level]->m_key_counter - 1 : 0;
+            node = path[level]->m_data[indices[level]];
+        }
+
+        // every node a split will need is allocated before anything is modified, so a failure leaves the tree intact
+        size_type splits = 0;
+        for (; splits < levels && path[levels - 1 - splits]->m_key_counter == N; ++splits){}
+        std::array<internal_type*, max_height + 1> fresh_nodes;
+        size_type allocated = 0;
+        try{
+            for (; allocated < splits + (splits == levels); ++allocated){
+                fresh_nodes[allocated] = std::construct_at(m_internal_alloc.allocate());
+            }
+        }
+        catch(...){
+            while (allocated > 0){
+                --allocated;
+                std::destroy_at(fresh_nodes[allocated]);
+                m_internal_alloc.deallocate(fresh_nodes[allocated]);
+            }
+            throw;
+        }
+
+        if (!at_end){
+            for (size_type level = 0; level + 1 < levels; ++level){
+                path[level]->m_keys[0] = subtree->m_keys[0];
+                path[level]->update_layout();
+            }
+        }
+        node_type* inserted_node = subtree;
+        size_type position = (levels == 0 || !at_end) ? 0 : path[levels - 1]->m_key_counter;
+        for (size_type level = levels, used = 0; level > 0; --level, ++used){
+            internal_type* parent = path[level - 1];
+            if (parent->m_key_counter != N){
+                node_type::insert_at(*parent, position, key_type(inserted_node->m_keys[0]), std::move(inserted_node));
+                parent->refresh_summary(position, level != m_height);
+                if (level != levels){
+                    parent->refresh_summary(indices[level - 1], level != m_height);
+                }
+                refresh_path(path, indices, level - 1);
+                return;
+            }
+            internal_type* new_internal = fresh_nodes[used];
+            node_type::split_insert(*parent, *new_internal, position, key_type(inserted_node->m_keys[0]), std::move(inserted_node));
+            parent->refresh_summaries(level != m_height);
+            new_internal->refresh_summaries(level != m_height);
+            inserted_node = new_internal;
+            position = (level > 1) ? indices[level - 2] + 1 : 0;
+        }
+
+        internal_type* new_root = fresh_nodes[splits];
+        new_root->m_key_counter = 2;
+        new_root->m_keys[0] = m_root->m_keys[0];
+        new_root->m_keys[1] = inserted_node->m_keys[0];
+        new_root->m_data[0] = m_root;
+        new_root->m_data[1] = inserted_node;
+        new_root->update_layout();
+        new_root->refresh_summaries(m_height != 0);
+        m_root = new_root;
+        ++m_height;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    void BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::repair(internal_type* node, size_type height)
+    {
+        if (height > 1){
+            for (size_type i = 0; i < node->m_key_counter; ++i){
+                repair(static_cast<internal_type*>(node->m_data[i]), height - 1);
+            }
+        }
+        size_type kept = 0;
+        for (size_type i = 0; i < node->m_key_counter; ++i){
+            node_type* subnode = node->m_data[i];
+            if (subnode->m_key_counter != 0){
+                node->m_keys[kept] = subnode->m_keys[0];
+                node->m_data[kept++] = subnode;
+                continue;
+            }
+            if (height == 1){
+                auto leaf = static_cast<leaf_type*>(subnode);
+                (leaf->m_prev ? leaf->m_prev->m_next : m_min) = leaf->m_next;
+                (leaf->m_next ? leaf->m_next->m_prev : m_max) = leaf->m_prev;
+            }
+            release(subnode, height - 1);
+        }
+        node->m_key_counter = kept;
+        if (height == 1){
+            refill<false>(node, height);
+        }
+        else{
+            refill<true>(node, height);
+        }
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <bool is_internal>
+    void BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::refill(internal_type* node, size_type height)
+    {
+        using subnode_type = std::conditional_t<is_internal, internal_type, leaf_type>;
+        auto refill_subnode = [&](subnode_type* subnode){
+            if constexpr(is_internal){
+                if (height == 2){
+                    refill<false>(subnode, height - 1);
+                }
+                else{
+                    refill<true>(subnode, height - 1);
+                }
+            }
+        };
+        // every pair of neighbours is left holding at least `min_keys` entries each, sweeping from left to right
+        for (size_type i = 1; i < node->m_key_counter; ){
+            auto lower = static_cast<subnode_type*>(node->m_data[i - 1]), higher = static_cast<subnode_type*>(node->m_data[i]);
+            if (lower->m_key_counter >= node_type::min_keys && higher->m_key_counter >= node_type::min_keys){
+                ++i;
+            }
+            else if (lower->m_key_counter + higher->m_key_counter <= N){
+                merge<is_internal>(lower, higher);
+                node_type::erase_at(*node, i);
+                refill_subnode(lower);
+                // a merged last subnode that is still underfull is refilled from the one before it
+                i -= (i == node->m_key_counter && i > 1 && lower->m_key_counter < node_type::min_keys);
+            }
+            else{
+                node_type::redistribute(*lower, *higher, (lower->m_key_counter + higher->m_key_counter) / 2);
+                node->m_keys[i] = higher->m_keys[0];
+                // refilling the subnodes may leave them underfull again, so the pair is checked once more
+                refill_subnode(lower);
+                refill_subnode(higher);
+            }
+        }
+        node->refresh_summaries(is_internal);
+        node->update_layout();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <bool is_internal>
+    void BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::merge(std::conditional_t<is_internal, internal_type, leaf_type>* lower_node, std::conditional_t<is_internal, internal_type, leaf_type>* higher_node){
+        node_type::append(*lower_node, *higher_node);
+        if constexpr(is_internal){
+            std::destroy_at(higher_node);
+            m_internal_alloc.deallocate(higher_node);
+        }
+        else{
+            if (higher_node->m_next){
+                higher_node->m_next->m_prev = lower_node;
+            }
+            lower_node->m_next = higher_node->m_next;
+            if (m_max == higher_node){
+                m_max = lower_node;
+            }
+            std::destroy_at(higher_node);
+            m_leaf_alloc.deallocate(higher_node);
+        }
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    typename BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::node_type *BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::copy(const node_type *source, size_type height, leaf_type*& last_leaf)
+    {
+        if (height == 0){
+            auto source_leaf = static_cast<const leaf_type*>(source);
+            leaf_type* out = std::construct_at(m_leaf_alloc.allocate());
+            out->m_key_counter = source_leaf->m_key_counter;
+            for (size_type i = 0; i < out->m_key_counter; ++i){
+                out->m_keys[i] = source_leaf->m_keys[i];
+                if constexpr(leaf_type::stores_inline){
+                    out->m_data[i] = source_leaf->m_data[i];
+                }
+                else{
+                    out->m_data[i] = std::construct_at(m_val_alloc.allocate(), *source_leaf->m_data[i]);
+                }
+            }
+            out->update_layout();
+            out->m_prev = last_leaf;
+            if (last_leaf){
+                last_leaf->m_next = out;
+            }
+            else{
+                m_min = out;
+            }
+            last_leaf = out;
+            return out;
+        }
+        auto source_internal = static_cast<const internal_type*>(source);
+        internal_type* out = std::construct_at(m_internal_alloc.allocate());
+        out->m_key_counter = source_internal->m_key_counter;
+        for (size_type i = 0; i < out->m_key_counter; ++i){
+            out->m_keys[i] = source_internal->m_keys[i];
+            out->m_data[i] = copy(source_internal->m_data[i], height - 1, last_leaf);
         }
+        out->m_summaries = source_internal->m_summaries;
+        out->update_layout();
         return out;
     }
 };
@@ -28,6 +28,8 @@ namespace csaur{
         using const_reference = const value_type&;
         using pointer = value_type*;
         using const_pointer = const value_type*;
+        template<class U>
+        using rebind = BankAllocator<U, M>;
 
         BankAllocator();
         ~BankAllocator();
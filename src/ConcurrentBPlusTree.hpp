@@ -0,0 +1,616 @@
+#ifndef CONCURRENT_BPLUS_TREE_CLASS_DEFINED
+#define CONCURRENT_BPLUS_TREE_CLASS_DEFINED
+
+#include "ConcurrentNode.hpp"
+#include "DefaultAllocator.hpp"
+#include "EpochReclaimer.hpp"
+#include <atomic>
+#include <new>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace csaur{
+    /// @brief A B+ tree that many threads may search and change at once, through optimistic lock coupling. Every node
+    ///        carries a version lock word, see OptimisticLock.hpp. Searches take no lock: they descend noting the
+    ///        version of each node, and restart from the root when a node changed before they were done with it.
+    ///        Writers descend the same way and only lock the nodes they change: the leaf they insert into or erase
+    ///        from, or, to split or merge a node, that node, its parent and the sibling involved.
+    /// @note Nodes are split and merged on the way down rather than on the way back up. Writers split every full node
+    ///       they are about to enter and refill every node a removal could leave underfull, so a change never spreads
+    ///       to a node above the one being changed. A writer restarts from the root after each such restructuring.
+    /// @note The nodes and values a writer unlinks may still be read by searches that started earlier, so they are
+    ///       retired to an EpochReclaimer, which releases them once every operation that could reach them is over.
+    /// @note Entries are only handed out as copies. The allocators are called from many threads at once, so they must
+    ///       be thread-safe, as DefaultAllocator is.
+    /// @tparam Search The policy used to search the keys within a node, see KeySearch.hpp.
+    template<ConcurrentKey Key,
+             Storable Mapped,
+             std::size_t N,
+             SingleElementAllocator ValueAlloc = DefaultAllocator<Mapped>,
+             SingleElementAllocator LeafAlloc = DefaultAllocator<ConcurrentLeaf<Key, Mapped, N>>,
+             SingleElementAllocator InternalAlloc = DefaultAllocator<ConcurrentInternal<Key, Mapped, N>>,
+             class Search = DefaultSearch
+            >
+    class ConcurrentBPlusTree{
+        static_assert(N >= 5, "ConcurrentBPlusTree: a node must be able to hold at least five keys, so that the nodes split and refilled on the way down keep two subnodes.");
+
+        #ifdef DEBUGGING_B_PLUS_TREE
+            friend class ::BPlusTest;
+        #endif
+    public:
+        using key_type = Key;
+        using mapped_type = Mapped;
+        using value_type = mapped_type;
+        using pointer = value_type*;
+        using size_type = std::size_t;
+        using value_allocator = ValueAlloc;
+        using node_type = ConcurrentNode<Key, Mapped, N, Search>;
+        using leaf_type = ConcurrentLeaf<Key, Mapped, N, Search>;
+        using internal_type = ConcurrentInternal<Key, Mapped, N, Search>;
+        using leaf_allocator = rebind_allocator_t<LeafAlloc, leaf_type>;
+        using internal_allocator = rebind_allocator_t<InternalAlloc, internal_type>;
+        using search_policy = Search;
+
+        /// @brief Creates an empty tree.
+        ConcurrentBPlusTree();
+
+        ConcurrentBPlusTree(const ConcurrentBPlusTree&) = delete;
+        ConcurrentBPlusTree& operator= (const ConcurrentBPlusTree&) = delete;
+
+        /// @brief Releases every node and value. No other thread may be using the tree.
+        ~ConcurrentBPlusTree();
+
+        /// @brief Returns the number of entries, which concurrent writers may change right after.
+        size_type size() const noexcept;
+
+        /// @brief Checks if the tree holds no entries.
+        bool is_empty() const noexcept;
+
+        /// @brief Finds a key and copies the value mapped to it.
+        /// @return The value, or nothing if the key is not in the tree.
+        std::optional<mapped_type> get(const key_type&) const;
+
+        /// @brief Checks if a key is in the tree.
+        bool contains(const key_type&) const;
+
+        /// @brief Inserts an entry, unless its key is already in the tree.
+        /// @return Whether the entry was inserted.
+        /// @note At failure, does not change contents and returns false.
+        bool insert(key_type&&, mapped_type&&) noexcept;
+
+        /// @brief Inserts an entry, or maps its key to the new value if the key is already in the tree.
+        /// @return Whether a new entry was inserted.
+        /// @note At failure, does not change contents and returns false.
+        bool insert_or_assign(key_type&&, mapped_type&&) noexcept;
+
+        /// @brief Erases the entry with a given key.
+        /// @return Whether there was such an entry.
+        bool erase(const key_type&);
+
+        /// @brief Returns the number of bytes of the nodes and values unlinked from the tree and not released yet.
+        size_type pending_retired_bytes() const noexcept;
+
+        /// @brief Returns the number of bytes of unlinked nodes and values released so far.
+        size_type released_bytes() const noexcept;
+    private:
+        using version_type = OptimisticLock::version_type;
+        using slot_type = typename leaf_type::slot_type;
+
+        /// @brief The least number of entries a node other than the root holds. Writers refill a node that holds no
+        ///        more before entering it, so both halves of a full node stay above it, even when N is odd.
+        static constexpr size_type min_fill = (N - 1) / 2;
+
+        /// @brief Notes the versions of the root lock and of the root, to start a descent.
+        /// @param height Set to the height of the root, where leaves have height 0.
+        /// @return The root, or nullptr if the root was being replaced and the descent must restart.
+        node_type* enter(version_type& root_version, version_type& version, size_type& height) const;
+
+        /// @brief Reads the subnode of a node whose subtree may contain a key, and notes its version.
+        /// @param version The version of the node noted on the way down.
+        /// @param index Set to the index of the subnode.
+        /// @return The subnode, or nullptr if the node changed meanwhile and the descent must restart.
+        node_type* step(const internal_type* node, version_type version, const key_type& key, size_type& index, version_type& child_version) const;
+
+        /// @brief The common part of insert and insert_or_assign.
+        /// @tparam Assign Whether to map an existing key to the new value.
+        template<bool Assign>
+        bool insert_impl(key_type&&, mapped_type&&) noexcept;
+
+        /// @brief Allocates the spare node a split at a given height takes, unless there already is one.
+        ///        Only called while holding no lock, since it may throw.
+        void reserve(size_type height, leaf_type*& spare_leaf, internal_type*& spare_internal);
+
+        /// @brief Moves the upper half of a full, locked node into a spare node. Leaves linking it to the caller.
+        /// @param height The height of the node, where leaves have height 0.
+        /// @return The new sibling, unlocked.
+        node_type* split(node_type* node, size_type height, leaf_type*& spare_leaf, internal_type*& spare_internal);
+
+        /// @brief Merges two adjacent subnodes of a node, or evens out their entries if they do not fit in one, then
+        ///        releases the locks on the three nodes. All three must be locked by the caller.
+        /// @param index The index of the lower of the two subnodes.
+        /// @param height The height of the subnodes, where leaves have height 0.
+        void refill(internal_type* node, size_type index, size_type height);
+
+        /// @brief Hands a node a writer unlinked to the reclaimer, since readers may still be on it.
+        /// @param height The height of the node, where leaves have height 0.
+        void retire(node_type* node, size_type height);
+
+        /// @brief Hands a value a writer unlinked to the reclaimer, since readers may still copy it.
+        void retire(pointer value);
+
+        /// @brief Destroys a retired object and returns it to its allocator. Called by the reclaimer.
+        /// @tparam Object A leaf, an internal node or a value.
+        template<class Object>
+        static void release_retired(void* tree, void* object);
+
+        /// @brief Releases every node and value of a subtree, including its root.
+        /// @param height The height of the subtree's root, where leaves have height 0.
+        void release(node_type* node, size_type height);
+
+        OptimisticLock m_root_lock;                 // guards m_root and m_height
+        node_type* m_root;
+        size_type m_height;
+        std::atomic<size_type> m_size;
+        mutable EpochReclaimer m_reclaimer;
+        [[no_unique_address]] leaf_allocator m_leaf_alloc;
+        [[no_unique_address]] internal_allocator m_internal_alloc;
+        [[no_unique_address]] value_allocator m_val_alloc;
+    };
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                         ConcurrentBPlusTree CTOR & DTOR                      //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <ConcurrentKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::ConcurrentBPlusTree()
+    {
+        m_root = std::construct_at(m_leaf_alloc.allocate());
+        m_height = 0;
+        m_size.store(0, std::memory_order_relaxed);
+    }
+
+    template <ConcurrentKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::~ConcurrentBPlusTree()
+    {
+        m_reclaimer.release_all();                  // before the allocators go
+        release(m_root, m_height);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                         ConcurrentBPlusTree Observers                        //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <ConcurrentKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::size_type ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::size() const noexcept
+    {
+        return m_size.load(std::memory_order_relaxed);
+    }
+
+    template <ConcurrentKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    bool ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::is_empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    template <ConcurrentKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::size_type ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::pending_retired_bytes() const noexcept
+    {
+        return m_reclaimer.pending_bytes();
+    }
+
+    template <ConcurrentKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::size_type ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::released_bytes() const noexcept
+    {
+        return m_reclaimer.released_bytes();
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                          ConcurrentBPlusTree Lookup                          //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <ConcurrentKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::node_type* ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::enter(version_type& root_version, version_type& version, size_type& height) const
+    {
+        m_root_lock.read_lock(root_version);
+        node_type* root = m_root;
+        height = m_height;
+        // the root is only dereferenced once it is known to be the root, and only trusted if it still is after
+        if (!m_root_lock.validate(root_version) || !root->m_lock.read_lock(version) || !m_root_lock.validate(root_version)){
+            return nullptr;
+        }
+        return root;
+    }
+
+    template <ConcurrentKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::node_type* ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::step(const internal_type* node, version_type version, const key_type& key, size_type& index, version_type& child_version) const
+    {
+        index = node->child_index(key);
+        node_type* child = node->m_data[index];
+        // as in enter, the node is validated once before the subnode is dereferenced, and once after its version is noted,
+        // since a subnode changed between the two may no longer hold the key
+        if (!node->m_lock.validate(version) || !child->m_lock.read_lock(child_version) || !node->m_lock.validate(version)){
+            return nullptr;
+        }
+        return child;
+    }
+
+    template <ConcurrentKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    std::optional<Mapped> ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::get(const key_type& key) const
+    {
+        EpochReclaimer::Guard guard(m_reclaimer);
+        for (;;){
+            version_type root_version, version;
+            size_type height, index;
+            node_type* node = enter(root_version, version, height);
+            for (; node != nullptr && height > 0; --height){
+                version_type child_version;
+                node = step(static_cast<const internal_type*>(node), version, key, index, child_version);
+                version = child_version;
+            }
+            if (node == nullptr){
+                continue;
+            }
+            auto leaf = static_cast<const leaf_type*>(node);
+            index = std::min(leaf->find_smallest_bigger_key_index(key), N);
+            bool found = index != 0 && leaf->m_keys[index - 1] == key;
+            slot_type slot = found ? leaf->m_data[index - 1] : slot_type();
+            if (!leaf->m_lock.validate(version)){
+                continue;
+            }
+            if (!found){
+                return std::nullopt;
+            }
+            // a value behind a pointer is never changed once linked, and is not released while the guard lives,
+            // so it is copied after validating, when the pointer is known to be right
+            return *leaf_type::value_address(slot);
+        }
+    }
+
+    template <ConcurrentKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    bool ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::contains(const key_type& key) const
+    {
+        return get(key).has_value();
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                          ConcurrentBPlusTree Insert                          //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <ConcurrentKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    bool ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::insert(key_type&& key, mapped_type&& mapped) noexcept
+    {
+        return insert_impl<false>(std::move(key), std::move(mapped));
+    }
+
+    template <ConcurrentKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    bool ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::insert_or_assign(key_type&& key, mapped_type&& mapped) noexcept
+    {
+        return insert_impl<true>(std::move(key), std::move(mapped));
+    }
+
+    template <ConcurrentKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    void ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::reserve(size_type height, leaf_type*& spare_leaf, internal_type*& spare_internal)
+    {
+        if (height == 0 && spare_leaf == nullptr){
+            spare_leaf = std::construct_at(m_leaf_alloc.allocate());
+        }
+        else if (height != 0 && spare_internal == nullptr){
+            spare_internal = std::construct_at(m_internal_alloc.allocate());
+        }
+    }
+
+    template <ConcurrentKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::node_type* ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::split(node_type* node, size_type height, leaf_type*& spare_leaf, internal_type*& spare_internal)
+    {
+        if (height == 0){
+            leaf_type* sibling = std::exchange(spare_leaf, nullptr);
+            node_type::redistribute(*static_cast<leaf_type*>(node), *sibling, N - N/2);
+            return sibling;
+        }
+        internal_type* sibling = std::exchange(spare_internal, nullptr);
+        node_type::redistribute(*static_cast<internal_type*>(node), *sibling, N - N/2);
+        return sibling;
+    }
+
+    template <ConcurrentKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    template <bool Assign>
+    bool ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::insert_impl(key_type&& key, mapped_type&& mapped) noexcept
+    {
+        // the value, and every node a split takes, is allocated while holding no lock, so a failure leaves the tree intact
+        slot_type slot = slot_type();
+        leaf_type* spare_leaf = nullptr;
+        internal_type* spare_internal = nullptr, * spare_root = nullptr;
+        bool inserted = false, assigned = false;
+        EpochReclaimer::Guard guard(m_reclaimer);
+        try{
+            if constexpr(leaf_type::stores_inline){
+                slot = std::move(mapped);
+            }
+            else{
+                pointer value = m_val_alloc.allocate();
+                try{
+                    slot = std::construct_at(value, std::move(mapped));
+                }
+                catch(...){
+                    m_val_alloc.deallocate(value);
+                    throw;
+                }
+            }
+
+            for (bool done = false; !done; ){
+                version_type root_version, version;
+                size_type height, index;
+                node_type* node = enter(root_version, version, height);
+                if (node == nullptr){
+                    continue;
+                }
+                if (node->m_key_counter == N){
+                    // a full root is split under the root lock, under a new root
+                    reserve(height, spare_leaf, spare_internal);
+                    if (spare_root == nullptr){
+                        spare_root = std::construct_at(m_internal_alloc.allocate());
+                    }
+                    if (!m_root_lock.upgrade(root_version)){
+                        continue;
+                    }
+                    if (!node->m_lock.upgrade(version)){
+                        m_root_lock.unlock();
+                        continue;
+                    }
+                    node_type* sibling = split(node, height, spare_leaf, spare_internal);
+                    node_type::insert_at(*spare_root, 0, key_type(node->m_keys[0]), std::move(node));
+                    node_type::insert_at(*spare_root, 1, key_type(sibling->m_keys[0]), std::move(sibling));
+                    m_root = std::exchange(spare_root, nullptr);
+                    ++m_height;
+                    node->m_lock.unlock();
+                    m_root_lock.unlock();
+                    continue;
+                }
+
+                bool restart = false;
+                for (; !restart && height > 0; --height){
+                    auto internal = static_cast<internal_type*>(node);
+                    version_type child_version;
+                    node_type* child = step(internal, version, key, index, child_version);
+                    if (child == nullptr){
+                        restart = true;
+                    }
+                    else if (child->m_key_counter == N){
+                        // a full node is split before entering it, into its parent, which the descent left not full
+                        reserve(height - 1, spare_leaf, spare_internal);
+                        restart = true;
+                        if (!internal->m_lock.upgrade(version)){
+                            break;
+                        }
+                        if (!child->m_lock.upgrade(child_version)){
+                            internal->m_lock.unlock();
+                            break;
+                        }
+                        node_type* sibling = split(child, height - 1, spare_leaf, spare_internal);
+                        if (index == 0){
+                            // keys smaller than the unused first key may have gone into the first subnode since it was
+                            // set, so it is lowered to keep the keys sorted for the search
+                            internal->m_keys[0] = child->m_keys[0];
+                        }
+                        node_type::insert_at(*internal, index + 1, key_type(sibling->m_keys[0]), std::move(sibling));
+                        child->m_lock.unlock();
+                        internal->m_lock.unlock();
+                    }
+                    else{
+                        node = child;
+                        version = child_version;
+                    }
+                }
+                if (restart || !node->m_lock.upgrade(version)){
+                    continue;
+                }
+
+                // the leaf kept its version since the descent noted it, so it still covers the key and is not full
+                auto leaf = static_cast<leaf_type*>(node);
+                index = leaf->find_smallest_bigger_key_index(key);
+                if (index != 0 && leaf->m_keys[index - 1] == key){
+                    if constexpr(Assign){
+                        std::swap(leaf->m_data[index - 1], slot);
+                        assigned = true;
+                    }
+                }
+                else{
+                    node_type::insert_at(*leaf, index, std::move(key), std::move(slot));
+                    m_size.fetch_add(1, std::memory_order_relaxed);
+                    inserted = true;
+                }
+                leaf->m_lock.unlock();
+                done = true;
+            }
+        }
+        catch(std::bad_alloc& e){
+        }
+
+        if constexpr(!leaf_type::stores_inline){
+            if (assigned){
+                retire(slot);                       // the value that was replaced
+            }
+            else if (!inserted && slot != nullptr){
+                std::destroy_at(slot);              // never linked, so no reader can have seen it
+                m_val_alloc.deallocate(slot);
+            }
+        }
+        if (spare_leaf != nullptr){
+            std::destroy_at(spare_leaf);
+            m_leaf_alloc.deallocate(spare_leaf);
+        }
+        for (internal_type* spare : {spare_internal, spare_root}){
+            if (spare != nullptr){
+                std::destroy_at(spare);
+                m_internal_alloc.deallocate(spare);
+            }
+        }
+        return inserted;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                           ConcurrentBPlusTree Erase                          //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <ConcurrentKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    bool ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::erase(const key_type& key)
+    {
+        EpochReclaimer::Guard guard(m_reclaimer);
+        for (;;){
+            version_type root_version, version;
+            size_type height, index;
+            node_type* node = enter(root_version, version, height);
+            if (node == nullptr){
+                continue;
+            }
+            if (height > 0 && node->m_key_counter == 1){
+                // a root left with a single subnode is dropped under the root lock
+                if (!m_root_lock.upgrade(root_version)){
+                    continue;
+                }
+                if (!node->m_lock.upgrade(version)){
+                    m_root_lock.unlock();
+                    continue;
+                }
+                m_root = static_cast<internal_type*>(node)->m_data[0];
+                --m_height;
+                node->m_lock.unlock_obsolete();
+                m_root_lock.unlock();
+                retire(node, height);
+                continue;
+            }
+
+            bool restart = false;
+            for (; !restart && height > 0; --height){
+                auto internal = static_cast<internal_type*>(node);
+                version_type child_version;
+                node_type* child = step(internal, version, key, index, child_version);
+                if (child == nullptr){
+                    restart = true;
+                }
+                else if (child->m_key_counter <= min_fill && internal->m_key_counter > 1){
+                    // a node a removal could leave underfull is refilled from a sibling before entering it. The
+                    // descent left its parent above min_fill, so the parent may lose a subnode to a merge
+                    restart = true;
+                    if (!internal->m_lock.upgrade(version)){
+                        break;
+                    }
+                    if (!child->m_lock.upgrade(child_version)){
+                        internal->m_lock.unlock();
+                        break;
+                    }
+                    // the sibling cannot be unlinked while its parent is locked, and whoever holds it never waits
+                    // for another lock, so waiting for it cannot deadlock
+                    size_type lower = (index != 0) ? index - 1 : index;
+                    internal->m_data[(index != 0) ? lower : index + 1]->m_lock.lock();
+                    refill(internal, lower, height - 1);
+                }
+                else{
+                    node = child;
+                    version = child_version;
+                }
+            }
+            if (restart || !node->m_lock.upgrade(version)){
+                continue;
+            }
+
+            auto leaf = static_cast<leaf_type*>(node);
+            index = leaf->find_smallest_bigger_key_index(key);
+            if (index == 0 || !(leaf->m_keys[index - 1] == key)){
+                leaf->m_lock.unlock();
+                return false;
+            }
+            slot_type slot = std::move(leaf->m_data[index - 1]);
+            node_type::erase_at(*leaf, index - 1);
+            m_size.fetch_sub(1, std::memory_order_relaxed);
+            leaf->m_lock.unlock();
+            if constexpr(!leaf_type::stores_inline){
+                retire(slot);
+            }
+            return true;
+        }
+    }
+
+    template <ConcurrentKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    void ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::refill(internal_type* node, size_type index, size_type height)
+    {
+        node_type* lower = node->m_data[index];
+        node_type* higher = node->m_data[index + 1];
+        bool merged = node->refill(index, height);
+        lower->m_lock.unlock();
+        if (merged){
+            higher->m_lock.unlock_obsolete();
+        }
+        else{
+            higher->m_lock.unlock();
+        }
+        node->m_lock.unlock();
+        if (merged){
+            retire(higher, height);
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                         ConcurrentBPlusTree Releasing                        //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <ConcurrentKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    void ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::retire(node_type* node, size_type height)
+    {
+        if (height == 0){
+            m_reclaimer.retire(static_cast<leaf_type*>(node), sizeof(leaf_type), &release_retired<leaf_type>, this);
+        }
+        else{
+            m_reclaimer.retire(static_cast<internal_type*>(node), sizeof(internal_type), &release_retired<internal_type>, this);
+        }
+    }
+
+    template <ConcurrentKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    void ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::retire(pointer value)
+    {
+        m_reclaimer.retire(value, sizeof(mapped_type), &release_retired<mapped_type>, this);
+    }
+
+    template <ConcurrentKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    template <class Object>
+    void ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::release_retired(void* tree, void* object)
+    {
+        auto self = static_cast<ConcurrentBPlusTree*>(tree);
+        std::destroy_at(static_cast<Object*>(object));
+        if constexpr(std::is_same_v<Object, leaf_type>){
+            self->m_leaf_alloc.deallocate(static_cast<leaf_type*>(object));
+        }
+        else if constexpr(std::is_same_v<Object, internal_type>){
+            self->m_internal_alloc.deallocate(static_cast<internal_type*>(object));
+        }
+        else{
+            self->m_val_alloc.deallocate(static_cast<pointer>(object));
+        }
+    }
+
+    template <ConcurrentKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    void ConcurrentBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::release(node_type* node, size_type height)
+    {
+        if (height == 0){
+            auto leaf = static_cast<leaf_type*>(node);
+            if constexpr(!leaf_type::stores_inline){
+                for (size_type i = 0; i < leaf->m_key_counter; ++i){
+                    std::destroy_at(leaf->m_data[i]);
+                    m_val_alloc.deallocate(leaf->m_data[i]);
+                }
+            }
+            std::destroy_at(leaf);
+            m_leaf_alloc.deallocate(leaf);
+            return;
+        }
+        auto internal = static_cast<internal_type*>(node);
+        for (size_type i = 0; i < internal->m_key_counter; ++i){
+            release(internal->m_data[i], height - 1);
+        }
+        std::destroy_at(internal);
+        m_internal_alloc.deallocate(internal);
+    }
+};
+
+#endif
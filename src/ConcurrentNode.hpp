@@ -0,0 +1,38 @@
+#ifndef CONCURRENT_NODE_CLASS_DEFINED
+#define CONCURRENT_NODE_CLASS_DEFINED
+
+#include "LooseNode.hpp"
+#include "OptimisticLock.hpp"
+
+namespace csaur{
+    /// @brief The version lock word every node of a ConcurrentBPlusTree starts with.
+    struct ConcurrentNodeLock{
+        OptimisticLock m_lock;
+    };
+
+    /// @brief The traits of the loose nodes of a ConcurrentBPlusTree, see LooseNode.hpp.
+    struct ConcurrentNodeTraits{
+        using header_type = ConcurrentNodeLock;
+
+        template<Storable Mapped>
+        using value_holder = Mapped;
+    };
+
+    /// @brief The part shared by the nodes of a ConcurrentBPlusTree: the keys of a BPlusNode and a version lock word.
+    /// @note Readers read the fields of a node while writers may be changing them, and only trust what they read once
+    ///       the version lock validates it. The key, counter and layout fields are therefore never read past `N`.
+    template<ConcurrentKey Key, Storable Mapped, std::size_t N, class Search = DefaultSearch>
+    using ConcurrentNode = LooseNode<ConcurrentNodeTraits, Key, Mapped, N, Search>;
+
+    /// @brief A leaf of a ConcurrentBPlusTree. Values that are not inline are never changed once linked into a leaf:
+    ///        assigning to a key links a new value, so that a reader may still copy the old one.
+    template<ConcurrentKey Key, Storable Mapped, std::size_t N, class Search = DefaultSearch>
+    using ConcurrentLeaf = LooseLeaf<ConcurrentNodeTraits, Key, Mapped, N, Search>;
+
+    /// @brief An internal node of a ConcurrentBPlusTree. Its separators are loose, so that erasing the first key of
+    ///        a leaf does not have to lock the nodes above it.
+    template<ConcurrentKey Key, Storable Mapped, std::size_t N, class Search = DefaultSearch>
+    using ConcurrentInternal = LooseInternal<ConcurrentNodeTraits, Key, Mapped, N, Search>;
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define CONSTRAINTS_HEADER_DEFINED
 
 #include <concepts>
+#include <type_traits>
 
 /// @brief A concept that ensures a type is move-constructible, copy-constructible, and destructible.
 ///
@@ -24,6 +25,24 @@ concept Storable = std::destructible<T> && requires (){
 template<typename Key>
 concept OrderedKey = Storable<Key> && std::totally_ordered<Key>;
 
+/// @brief A concept that ensures a key can be searched while another thread may be overwriting it, as the optimistic
+///        readers of a ConcurrentBPlusTree do. Whatever they read is discarded unless it turns out consistent.
+///
+/// @requirements:
+/// * `Key` must be an `OrderedKey`.
+/// * `Key` must be trivially copyable, so that reading it halfway through a write is harmless.
+template<typename Key>
+concept ConcurrentKey = OrderedKey<Key> && std::is_trivially_copyable_v<Key>;
+
+/// @brief A concept that marks a type as cheap enough to be stored directly inside leaf nodes.
+///
+/// @requirements:
+/// * `T` must be trivially copyable.
+/// * `T` must be default-initializable.
+/// * `T` must be no larger than 32 bytes.
+template<typename T>
+concept InlineStorable = Storable<T> && std::is_trivially_copyable_v<T> && std::default_initializable<T> && (sizeof(T) <= 32);
+
 /// @brief A concept that ensures a type has a method named allocate.
 ///
 /// @requirements:
@@ -52,4 +71,21 @@ concept has_deallocate = requires (Allocator a, typename Allocator::pointer p){
 template<typename Alloc>
 concept SingleElementAllocator = has_deallocate<Alloc> && has_allocate<Alloc>;
 
+/// @brief The allocator to use for objects of type `T`, given an allocator `Alloc` meant for them.
+///
+/// If `Alloc` provides a member template `rebind<T>`, as `DefaultAllocator` does, the result is `Alloc::rebind<T>`.
+/// Otherwise the result is `Alloc` itself, which must then already allocate objects of type `T`.
+template<typename Alloc, typename T>
+struct rebind_allocator{
+    using type = Alloc;
+};
+
+template<typename Alloc, typename T> requires requires { typename Alloc::template rebind<T>; }
+struct rebind_allocator<Alloc, T>{
+    using type = typename Alloc::template rebind<T>;
+};
+
+template<typename Alloc, typename T>
+using rebind_allocator_t = typename rebind_allocator<Alloc, T>::type;
+
 #endif
@@ -10,6 +10,8 @@ namespace csaur{
         using const_reference = const value_type&;
         using pointer = value_type*;
         using const_pointer = const value_type*;
+        template<class U>
+        using rebind = DefaultAllocator<U>;
 
         DefaultAllocator(){}
         DefaultAllocator(const DefaultAllocator&) = delete;
@@ -0,0 +1,379 @@
+#ifndef EPOCH_RECLAIMER_CLASS_DEFINED
+#define EPOCH_RECLAIMER_CLASS_DEFINED
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace csaur{
+    /// @brief Epoch-based reclamation of the objects a concurrent structure unlinks while lock-free readers may still
+    ///        be on them. Threads pin the reclaimer for the length of an operation. An unlinked object is retired
+    ///        rather than released, and is released once every thread that was pinned when it was retired has unpinned.
+    /// @note A global epoch only moves forward once every pinned thread has seen it, so an object retired in epoch e
+    ///       is unreachable by everyone when the global epoch reaches e + 2. Each thread keeps its own retire list, and
+    ///       releases the expired part of it in batches when it unpins. Readers only write their own epoch word, once
+    ///       per operation rather than once per node as with hazard pointers.
+    /// @note Garbage is bounded: a thread whose retire list holds `limit` objects waits, when it unpins, until enough of
+    ///       them expire. A thread that stays pinned for long therefore holds up the writers. A thread that exits hands
+    ///       what it had not released yet to a shared orphan list, which the remaining threads release as it expires.
+    /// @note Bookkeeping is bounded too: an exiting thread leaves every reclaimer it used, and a thread forgets the
+    ///       reclaimers that were destroyed the next time it registers with a new one.
+    class EpochReclaimer{
+        struct Participant;
+        struct Registry;
+        #ifdef DEBUGGING_B_PLUS_TREE
+            friend class ::BPlusTest;
+        #endif
+    public:
+        using size_type = std::size_t;
+        using epoch_type = std::uint64_t;
+
+        /// @brief Releases a retired object, given the context it was retired with.
+        using release_function = void (*)(void* context, void* object);
+
+        /// @brief Keeps the calling thread pinned for as long as it lives. Guards may nest.
+        class Guard{
+        public:
+            explicit Guard(EpochReclaimer& reclaimer);
+            Guard(const Guard&) = delete;
+            Guard& operator= (const Guard&) = delete;
+            ~Guard();
+        private:
+            EpochReclaimer& m_reclaimer;
+            Participant& m_participant;
+        };
+
+        /// @param batch The number of retired objects a thread gathers before it tries to release them.
+        /// @param limit The number of retired objects past which a thread waits for them to expire when it unpins.
+        explicit EpochReclaimer(size_type batch = 64, size_type limit = 4096);
+
+        EpochReclaimer(const EpochReclaimer&) = delete;
+        EpochReclaimer& operator= (const EpochReclaimer&) = delete;
+
+        /// @brief Releases every object still retired, and the bookkeeping of the threads that used the reclaimer.
+        ///        No thread may be pinned.
+        ~EpochReclaimer();
+
+        /// @brief Pins the calling thread until the returned guard is destroyed.
+        Guard pin();
+
+        /// @brief Retires an object that was just unlinked, to be released by `release(context, object)` once no
+        ///        thread can reach it anymore. The calling thread must be pinned.
+        /// @param bytes The size of the object, as reported by `pending_bytes`.
+        void retire(void* object, size_type bytes, release_function release, void* context);
+
+        /// @brief Releases every retired object at once, expired or not. No thread may be pinned.
+        void release_all();
+
+        /// @brief Returns the number of bytes retired but not released yet, over every thread.
+        size_type pending_bytes() const noexcept;
+
+        /// @brief Returns the number of objects retired but not released yet, over every thread.
+        size_type pending_count() const noexcept;
+
+        /// @brief Returns the number of bytes released so far.
+        size_type released_bytes() const noexcept;
+    private:
+        struct Retired{
+            void* m_object;
+            release_function m_release;
+            void* m_context;
+            size_type m_bytes;
+            epoch_type m_epoch;         // the global epoch when the object was retired
+        };
+
+        /// @brief The state of one thread: its epoch word, and the objects it retired.
+        struct alignas(64) Participant{
+            std::atomic<epoch_type> m_state;        // twice the epoch the thread is pinned in, plus one, or 0 if unpinned
+            size_type m_nesting;
+            std::vector<Retired> m_retired;
+            size_type m_first;                      // the retired objects before this index were released
+            std::atomic<size_type> m_pending_bytes;
+            std::atomic<size_type> m_pending_count;
+        };
+
+        /// @brief What a reclaimer shares with the threads registered with it, which may outlive it.
+        struct Registry{
+            std::mutex m_lock;
+            EpochReclaimer* m_reclaimer;            // nullptr once the reclaimer is destroyed
+        };
+
+        /// @brief The reclaimers a thread is registered with. Leaves every one still alive when the thread exits.
+        struct ThreadRecord{
+            struct Registration{
+                std::shared_ptr<Registry> m_registry;
+                Participant* m_participant;
+            };
+            std::vector<Registration> m_registrations;
+
+            ~ThreadRecord();
+        };
+
+        /// @brief Returns the record of the calling thread.
+        static ThreadRecord& thread_record();
+
+        /// @brief Finds the participant of the calling thread, registering the thread on first use.
+        Participant& participant();
+
+        /// @brief Unregisters a participant whose thread exits, handing what it retired to the orphans.
+        ///        Called with the registry locked.
+        void depart(Participant*);
+
+        /// @brief Pins and unpins a thread. Unpinning releases the expired objects the thread retired, once there are enough.
+        void enter(Participant&);
+        void leave(Participant&);
+
+        /// @brief Moves the global epoch forward if every pinned thread has seen it.
+        void try_advance();
+
+        /// @brief Releases the retired objects of a participant that expired, and the orphans that expired.
+        void collect(Participant&);
+
+        /// @brief Releases the orphans that expired by `epoch`, or every orphan if `all` is set. Called with `m_lock` held.
+        void collect_orphans(epoch_type epoch, bool all);
+
+        std::atomic<epoch_type> m_epoch;
+        std::shared_ptr<Registry> m_registry;
+        mutable std::mutex m_lock;                  // guards m_participants and m_orphans
+        std::vector<Participant*> m_participants;   // the threads registered and not exited yet
+        std::vector<Retired> m_orphans;             // what exited threads had not released yet
+        std::atomic<size_type> m_orphan_bytes;
+        std::atomic<size_type> m_orphan_count;
+        std::atomic<size_type> m_released_bytes;
+        size_type m_batch;
+        size_type m_limit;
+    };
+
+    inline EpochReclaimer::Guard::Guard(EpochReclaimer& reclaimer) : m_reclaimer(reclaimer), m_participant(reclaimer.participant())
+    {
+        m_reclaimer.enter(m_participant);
+    }
+
+    inline EpochReclaimer::Guard::~Guard()
+    {
+        m_reclaimer.leave(m_participant);
+    }
+
+    inline EpochReclaimer::EpochReclaimer(size_type batch, size_type limit)
+    {
+        m_epoch.store(1, std::memory_order_relaxed);
+        m_registry = std::make_shared<Registry>();
+        m_registry->m_reclaimer = this;
+        m_orphan_bytes.store(0, std::memory_order_relaxed);
+        m_orphan_count.store(0, std::memory_order_relaxed);
+        m_released_bytes.store(0, std::memory_order_relaxed);
+        m_batch = batch;
+        m_limit = (limit > batch) ? limit : batch;
+    }
+
+    inline EpochReclaimer::~EpochReclaimer()
+    {
+        // threads exiting from now on find the registry empty and leave the participants to us
+        std::lock_guard registry_lock(m_registry->m_lock);
+        m_registry->m_reclaimer = nullptr;
+        release_all();
+        for (Participant* participant : m_participants){
+            delete participant;
+        }
+    }
+
+    inline EpochReclaimer::ThreadRecord::~ThreadRecord()
+    {
+        for (Registration& registration : m_registrations){
+            std::lock_guard registry_lock(registration.m_registry->m_lock);
+            if (registration.m_registry->m_reclaimer != nullptr){
+                registration.m_registry->m_reclaimer->depart(registration.m_participant);
+            }
+        }
+    }
+
+    inline EpochReclaimer::Guard EpochReclaimer::pin()
+    {
+        return Guard(*this);
+    }
+
+    inline EpochReclaimer::ThreadRecord& EpochReclaimer::thread_record()
+    {
+        thread_local ThreadRecord record;
+        return record;
+    }
+
+    inline EpochReclaimer::Participant& EpochReclaimer::participant()
+    {
+        auto& registrations = thread_record().m_registrations;
+        // a registry lives as long as some thread is registered with it, so its address tells reclaimers apart
+        for (auto registration = registrations.rbegin(); registration != registrations.rend(); ++registration){
+            if (registration->m_registry == m_registry){
+                return *registration->m_participant;
+            }
+        }
+        std::erase_if(registrations, [](auto& registration){
+            std::lock_guard registry_lock(registration.m_registry->m_lock);
+            return registration.m_registry->m_reclaimer == nullptr;
+        });
+        Participant* fresh = new Participant();
+        fresh->m_state.store(0, std::memory_order_relaxed);
+        fresh->m_nesting = 0;
+        fresh->m_first = 0;
+        fresh->m_pending_bytes.store(0, std::memory_order_relaxed);
+        fresh->m_pending_count.store(0, std::memory_order_relaxed);
+        {
+            std::lock_guard lock(m_lock);
+            m_participants.push_back(fresh);
+        }
+        registrations.push_back({m_registry, fresh});
+        return *fresh;
+    }
+
+    inline void EpochReclaimer::depart(Participant* self)
+    {
+        std::lock_guard lock(m_lock);
+        for (size_type i = self->m_first; i < self->m_retired.size(); ++i){
+            m_orphans.push_back(self->m_retired[i]);
+        }
+        m_orphan_bytes.fetch_add(self->m_pending_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        m_orphan_count.fetch_add(self->m_pending_count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        std::erase(m_participants, self);
+        delete self;
+    }
+
+    inline void EpochReclaimer::enter(Participant& self)
+    {
+        if (self.m_nesting++ == 0){
+            self.m_state.store(2 * m_epoch.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            // the announcement must be visible before the thread reads anything it could find retired
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+    inline void EpochReclaimer::leave(Participant& self)
+    {
+        if (--self.m_nesting != 0){
+            return;
+        }
+        self.m_state.store(0, std::memory_order_release);
+        size_type pending = self.m_retired.size() - self.m_first;
+        if (pending >= m_batch){
+            collect(self);
+        }
+        while (self.m_retired.size() - self.m_first >= m_limit){
+            std::this_thread::yield();
+            collect(self);
+        }
+    }
+
+    inline void EpochReclaimer::retire(void* object, size_type bytes, release_function release, void* context)
+    {
+        Participant& self = participant();
+        // the unlinking must be visible before the epoch is read, see enter
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        self.m_retired.push_back({object, release, context, bytes, m_epoch.load(std::memory_order_relaxed)});
+        self.m_pending_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        self.m_pending_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    inline void EpochReclaimer::try_advance()
+    {
+        std::lock_guard lock(m_lock);
+        epoch_type epoch = m_epoch.load(std::memory_order_acquire);
+        for (Participant* current : m_participants){
+            epoch_type state = current->m_state.load(std::memory_order_acquire);
+            if (state != 0 && state != 2 * epoch + 1){
+                return;
+            }
+        }
+        m_epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_acq_rel, std::memory_order_relaxed);
+    }
+
+    inline void EpochReclaimer::collect(Participant& self)
+    {
+        try_advance();
+        epoch_type epoch = m_epoch.load(std::memory_order_acquire);
+        size_type bytes = 0, count = 0;
+        // objects are retired in epoch order, so the expired ones come first
+        for (; self.m_first < self.m_retired.size() && self.m_retired[self.m_first].m_epoch + 2 <= epoch; ++self.m_first, ++count){
+            Retired& retired = self.m_retired[self.m_first];
+            retired.m_release(retired.m_context, retired.m_object);
+            bytes += retired.m_bytes;
+        }
+        if (self.m_first == self.m_retired.size() || self.m_first >= m_batch){
+            self.m_retired.erase(self.m_retired.begin(), self.m_retired.begin() + self.m_first);
+            self.m_first = 0;
+        }
+        self.m_pending_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+        self.m_pending_count.fetch_sub(count, std::memory_order_relaxed);
+        m_released_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        if (m_orphan_count.load(std::memory_order_relaxed) != 0){
+            std::lock_guard lock(m_lock);
+            collect_orphans(epoch, false);
+        }
+    }
+
+    inline void EpochReclaimer::collect_orphans(epoch_type epoch, bool all)
+    {
+        size_type bytes = 0, count = 0;
+        // orphans come from many threads, so they are not in epoch order
+        std::erase_if(m_orphans, [&](Retired& retired){
+            if (!all && retired.m_epoch + 2 > epoch){
+                return false;
+            }
+            retired.m_release(retired.m_context, retired.m_object);
+            bytes += retired.m_bytes;
+            ++count;
+            return true;
+        });
+        m_orphan_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+        m_orphan_count.fetch_sub(count, std::memory_order_relaxed);
+        m_released_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    inline void EpochReclaimer::release_all()
+    {
+        std::lock_guard lock(m_lock);
+        collect_orphans(0, true);
+        size_type bytes = 0;
+        for (Participant* current : m_participants){
+            for (size_type i = current->m_first; i < current->m_retired.size(); ++i){
+                Retired& retired = current->m_retired[i];
+                retired.m_release(retired.m_context, retired.m_object);
+                bytes += retired.m_bytes;
+            }
+            current->m_retired.clear();
+            current->m_first = 0;
+            current->m_pending_bytes.store(0, std::memory_order_relaxed);
+            current->m_pending_count.store(0, std::memory_order_relaxed);
+        }
+        m_released_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    inline EpochReclaimer::size_type EpochReclaimer::pending_bytes() const noexcept
+    {
+        std::lock_guard lock(m_lock);
+        size_type bytes = m_orphan_bytes.load(std::memory_order_relaxed);
+        for (Participant* current : m_participants){
+            bytes += current->m_pending_bytes.load(std::memory_order_relaxed);
+        }
+        return bytes;
+    }
+
+    inline EpochReclaimer::size_type EpochReclaimer::pending_count() const noexcept
+    {
+        std::lock_guard lock(m_lock);
+        size_type count = m_orphan_count.load(std::memory_order_relaxed);
+        for (Participant* current : m_participants){
+            count += current->m_pending_count.load(std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    inline EpochReclaimer::size_type EpochReclaimer::released_bytes() const noexcept
+    {
+        return m_released_bytes.load(std::memory_order_relaxed);
+    }
+};
+
+#endif
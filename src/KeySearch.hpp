@@ -0,0 +1,214 @@
+#ifndef KEY_SEARCH_HEADER_DEFINED
+#define KEY_SEARCH_HEADER_DEFINED
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <array>
+#include <bit>
+#if defined(__AVX2__) || defined(__SSE4_2__)
+    #include <immintrin.h>
+#endif
+
+namespace csaur{
+    /// @brief Whether keys of type `T` are searched inside nodes by the vectorized kernel.
+    /// @note True for 32 and 64 bit integers and for `float` and `double`, when the target supports AVX2 or SSE4.2.
+    template<typename T>
+    inline constexpr bool simd_searchable =
+        #if defined(__AVX2__) || defined(__SSE4_2__)
+            (std::is_integral_v<T> && !std::is_same_v<T, bool> && (sizeof(T) == 4 || sizeof(T) == 8)) ||
+            std::is_same_v<T, float> || std::is_same_v<T, double>;
+        #else
+            false;
+        #endif
+
+    #if defined(__AVX2__) || defined(__SSE4_2__)
+    namespace simd_detail{
+        #if defined(__AVX2__)
+            using ivec = __m256i;
+            inline constexpr std::size_t vector_bytes = 32;
+            inline ivec load(const void* p){return _mm256_loadu_si256((const __m256i*)p);}
+            inline ivec broadcast32(std::int32_t x){return _mm256_set1_epi32(x);}
+            inline ivec broadcast64(std::int64_t x){return _mm256_set1_epi64x(x);}
+            inline ivec greater32(ivec a, ivec b){return _mm256_cmpgt_epi32(a, b);}
+            inline ivec greater64(ivec a, ivec b){return _mm256_cmpgt_epi64(a, b);}
+            inline ivec bias32(ivec a){return _mm256_xor_si256(a, _mm256_set1_epi32(INT32_MIN));}
+            inline ivec bias64(ivec a){return _mm256_xor_si256(a, _mm256_set1_epi64x(INT64_MIN));}
+            inline unsigned mask32(ivec a){return _mm256_movemask_ps(_mm256_castsi256_ps(a));}
+            inline unsigned mask64(ivec a){return _mm256_movemask_pd(_mm256_castsi256_pd(a));}
+            inline unsigned not_greater(const float* p, float x){return _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(p), _mm256_set1_ps(x), _CMP_LE_OQ));}
+            inline unsigned not_greater(const double* p, double x){return _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(p), _mm256_set1_pd(x), _CMP_LE_OQ));}
+        #else
+            using ivec = __m128i;
+            inline constexpr std::size_t vector_bytes = 16;
+            inline ivec load(const void* p){return _mm_loadu_si128((const __m128i*)p);}
+            inline ivec broadcast32(std::int32_t x){return _mm_set1_epi32(x);}
+            inline ivec broadcast64(std::int64_t x){return _mm_set1_epi64x(x);}
+            inline ivec greater32(ivec a, ivec b){return _mm_cmpgt_epi32(a, b);}
+            inline ivec greater64(ivec a, ivec b){return _mm_cmpgt_epi64(a, b);}
+            inline ivec bias32(ivec a){return _mm_xor_si128(a, _mm_set1_epi32(INT32_MIN));}
+            inline ivec bias64(ivec a){return _mm_xor_si128(a, _mm_set1_epi64x(INT64_MIN));}
+            inline unsigned mask32(ivec a){return _mm_movemask_ps(_mm_castsi128_ps(a));}
+            inline unsigned mask64(ivec a){return _mm_movemask_pd(_mm_castsi128_pd(a));}
+            inline unsigned not_greater(const float* p, float x){return _mm_movemask_ps(_mm_cmple_ps(_mm_loadu_ps(p), _mm_set1_ps(x)));}
+            inline unsigned not_greater(const double* p, double x){return _mm_movemask_pd(_mm_cmple_pd(_mm_loadu_pd(p), _mm_set1_pd(x)));}
+        #endif
+
+        /// @brief Returns a bit mask with one bit per lane of `keys[0..lanes)`, set where the lane is not greater than `key`.
+        template<typename T>
+        inline unsigned not_greater_mask(const T* keys, T key){
+            constexpr std::size_t lanes = vector_bytes / sizeof(T);
+            constexpr unsigned all = (1u << lanes) - 1;
+            if constexpr(std::is_floating_point_v<T>){
+                return not_greater(keys, key);
+            }
+            else if constexpr(sizeof(T) == 4){
+                ivec k = broadcast32((std::int32_t)key), v = load(keys);
+                if constexpr(std::is_unsigned_v<T>){ // signed comparison of biased values orders unsigned values
+                    k = bias32(k);
+                    v = bias32(v);
+                }
+                return ~mask32(greater32(v, k)) & all;
+            }
+            else{
+                ivec k = broadcast64((std::int64_t)key), v = load(keys);
+                if constexpr(std::is_unsigned_v<T>){
+                    k = bias64(k);
+                    v = bias64(v);
+                }
+                return ~mask64(greater64(v, k)) & all;
+            }
+        }
+    };
+    #endif
+
+    /// @brief Finds the index of the first key strictly greater than `key` in a sorted array, by comparing whole
+    ///        vectors of keys against a broadcast `key` and counting the lanes that are not greater.
+    /// @param keys A sorted array of keys.
+    /// @param count The number of keys in the array.
+    /// @note Time Complexity: O(x / lanes), where x is `count`. A linear scan of a node-sized array has no
+    ///       data-dependent branches apart from the exit, so it does not suffer the mispredictions of a binary search.
+    template<typename T> requires simd_searchable<T>
+    inline std::size_t simd_upper_bound(const T* keys, std::size_t count, T key){
+        std::size_t index = 0;
+        #if defined(__AVX2__) || defined(__SSE4_2__)
+            constexpr std::size_t lanes = simd_detail::vector_bytes / sizeof(T);
+            constexpr unsigned all = (1u << lanes) - 1;
+            for (; index + lanes <= count; index += lanes){
+                unsigned mask = simd_detail::not_greater_mask(keys + index, key);
+                if (mask != all){ // the keys are sorted, so the first greater lane ends the search
+                    return index + std::popcount(mask);
+                }
+            }
+        #endif
+        for (; index < count && !(key < keys[index]); ++index){}
+        return index;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                           In-Node Search Policies                            //
+    //////////////////////////////////////////////////////////////////////////////////
+    //
+    // A search policy decides how `BPlusNode::find_smallest_bigger_key_index` searches the sorted keys of a node.
+    // Each policy provides:
+    // * `layout<Key, N>` - extra state kept in every node, rebuilt by `rebuild(keys, count)` whenever the keys change.
+    // * `upper_bound(keys, count, layout, key)` - the index of the first of the `count` keys strictly greater than `key`.
+
+    /// @brief A search policy whose nodes keep no extra state.
+    struct StatelessSearch{
+        template<typename Key, std::size_t N>
+        struct layout{
+            void rebuild(const std::array<Key, N>&, std::size_t){}
+        };
+    };
+
+    /// @brief Searches nodes with a branchy binary search.
+    struct BinarySearch : StatelessSearch{
+        template<typename Key, std::size_t N>
+        static std::size_t upper_bound(const std::array<Key, N>& keys, std::size_t count, const layout<Key, N>&, const Key& key){
+            std::size_t left = 0, right = (count != 0) ? count - 1 : 0, result = count;
+            // binary search, T(n) = O(log n) & S(n) = O(1)
+            while (left <= right){
+                auto mid = (left + right) / 2;
+                if (key < keys[mid]){ // comparison is permitted because Key must support 'operator<(Key, Key)'
+                    result = mid;
+                    if (mid == 0) break; // prevents out-of-range indexing
+                    right = mid - 1;
+                }
+                else{
+                    left = mid + 1;
+                }
+            }
+            return result;
+        }
+    };
+
+    /// @brief Searches nodes with a binary search whose only data-dependent choice compiles to a conditional move.
+    struct BranchlessSearch : StatelessSearch{
+        template<typename Key, std::size_t N>
+        static std::size_t upper_bound(const std::array<Key, N>& keys, std::size_t count, const layout<Key, N>&, const Key& key){
+            if (count == 0) return 0;
+            const Key* base = keys.data();
+            for (std::size_t length = count; length > 1; length -= length / 2){
+                base = (key < base[length / 2]) ? base : base + length / 2;
+            }
+            return (base - keys.data()) + !(key < *base);
+        }
+    };
+
+    /// @brief Searches vectorizable keys with `simd_upper_bound`, and all other keys with `BinarySearch`.
+    struct DefaultSearch : StatelessSearch{
+        template<typename Key, std::size_t N>
+        static std::size_t upper_bound(const std::array<Key, N>& keys, std::size_t count, const layout<Key, N>& l, const Key& key){
+            if constexpr(simd_searchable<Key>){
+                return simd_upper_bound(keys.data(), count, key);
+            }
+            else{
+                return BinarySearch::upper_bound(keys, count, l, key);
+            }
+        }
+    };
+
+    /// @brief Searches a copy of the keys kept in Eytzinger (breadth-first) order, prefetching the node's
+    ///        descendants a few levels ahead. Meant for very wide nodes, where the sorted keys span many cache lines.
+    /// @note Every node carries the copy and its sorted ranks, roughly doubling the space taken by keys.
+    struct EytzingerSearch{
+        template<typename Key, std::size_t N>
+        struct layout{
+            std::array<Key, N + 1> m_keys;              // 1-based, m_keys[k] has children m_keys[2k] and m_keys[2k + 1]
+            std::array<std::uint32_t, N + 1> m_ranks;   // the index of m_keys[k] in the sorted keys
+
+            void rebuild(const std::array<Key, N>& keys, std::size_t count){
+                std::size_t next = 0;
+                fill(keys, count, next, 1);
+            }
+
+        private:
+            void fill(const std::array<Key, N>& keys, std::size_t count, std::size_t& next, std::size_t k){
+                if (k > count) return;
+                fill(keys, count, next, 2 * k);
+                m_keys[k] = keys[next];
+                m_ranks[k] = (std::uint32_t)next++;
+                fill(keys, count, next, 2 * k + 1);
+            }
+        };
+
+        template<typename Key, std::size_t N>
+        static std::size_t upper_bound(const std::array<Key, N>&, std::size_t count, const layout<Key, N>& l, const Key& key){
+            constexpr std::size_t block = (64 / sizeof(Key)) ? 64 / sizeof(Key) : 1;  // the keys in a cache line
+            std::size_t k = 1;
+            while (k <= count){
+                #if defined(__GNUC__)
+                    if (block * k <= N){
+                        __builtin_prefetch(l.m_keys.data() + block * k); // the descendants a cache line's worth of levels below
+                    }
+                #endif
+                k = 2 * k + !(key < l.m_keys[k]);
+            }
+            k >>= std::countr_one(k) + 1;   // cancel the trailing right turns and the last left turn
+            return (k == 0) ? count : l.m_ranks[k];
+        }
+    };
+};
+
+#endif
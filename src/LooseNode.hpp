@@ -0,0 +1,201 @@
+#ifndef LOOSE_NODE_CLASS_DEFINED
+#define LOOSE_NODE_CLASS_DEFINED
+
+#include "BPlusTree.hpp"
+
+namespace csaur{
+    template<ConcurrentKey, Storable, std::size_t, SingleElementAllocator, SingleElementAllocator, SingleElementAllocator, class>
+    class ConcurrentBPlusTree;
+
+    template<OrderedKey, Storable, std::size_t, SingleElementAllocator, SingleElementAllocator, SingleElementAllocator, class>
+    class SnapshotBPlusTree;
+
+    template<class Traits, OrderedKey Key, Storable Mapped, std::size_t N, class Search>
+    class LooseLeaf;
+
+    template<class Traits, OrderedKey Key, Storable Mapped, std::size_t N, class Search>
+    class LooseInternal;
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                                 Loose Nodes                                  //
+    //////////////////////////////////////////////////////////////////////////////////
+    //
+    // The nodes of the trees whose writers never go back up the path they descended, ConcurrentBPlusTree and
+    // SnapshotBPlusTree. Their separators are loose: `m_keys[i]` of an internal node is not bigger than any key under
+    // `m_data[i]` and is bigger than every key under `m_data[i - 1]`, but unlike in a BPlusInternal it need not be the
+    // smallest key under `m_data[i]`. Erasing the first key of a leaf therefore changes nothing above the leaf.
+    // The trees tell their nodes apart by traits, which provide:
+    // * `header_type` - a word every node starts with, on the cache line of the key counter rather than after the keys.
+    // * `value_holder<Mapped>` - what the slots of a leaf point to when values are not inline, holding the value
+    //   itself or in a member `m_value`.
+
+    /// @brief The part shared by loose leaves and internal nodes: the header word and the keys of a BPlusNode.
+    template<class Traits, OrderedKey Key, Storable Mapped, std::size_t N, class Search>
+    class LooseNode : public Traits::header_type, public BPlusNode<Key, Mapped, N, Search, NoAugment>{
+        template<ConcurrentKey, Storable, std::size_t, SingleElementAllocator, SingleElementAllocator, SingleElementAllocator, class>
+        friend class csaur::ConcurrentBPlusTree;
+        template<OrderedKey, Storable, std::size_t, SingleElementAllocator, SingleElementAllocator, SingleElementAllocator, class>
+        friend class csaur::SnapshotBPlusTree;
+        #ifdef DEBUGGING_B_PLUS_TREE
+            friend class ::BPlusTest;
+        #endif
+    public:
+        using key_type = Key;
+        using size_type = std::size_t;
+    protected:
+        /// @brief Creates an empty node, with a default header
+        LooseNode() = default;
+    };
+
+    /// @brief A loose leaf. Leaves are not linked to their neighbours.
+    template<class Traits, OrderedKey Key, Storable Mapped, std::size_t N, class Search>
+    class LooseLeaf : public LooseNode<Traits, Key, Mapped, N, Search>{
+        template<ConcurrentKey, Storable, std::size_t, SingleElementAllocator, SingleElementAllocator, SingleElementAllocator, class>
+        friend class csaur::ConcurrentBPlusTree;
+        template<OrderedKey, Storable, std::size_t, SingleElementAllocator, SingleElementAllocator, SingleElementAllocator, class>
+        friend class csaur::SnapshotBPlusTree;
+        friend class BPlusNode<Key, Mapped, N, Search, NoAugment>;
+        friend class LooseInternal<Traits, Key, Mapped, N, Search>;
+        #ifdef DEBUGGING_B_PLUS_TREE
+            friend class ::BPlusTest;
+        #endif
+    public:
+        using key_type = Key;
+        using mapped_type = Mapped;
+        using value_type = mapped_type;
+        using const_pointer = const value_type*;
+        using size_type = std::size_t;
+        using value_holder = typename Traits::template value_holder<Mapped>;
+
+        /// @brief Whether leaf slots hold the mapped values themselves (true) or pointers to values obtained from the value allocator (false).
+        static constexpr bool stores_inline = InlineStorable<Mapped>;
+        using slot_type = std::conditional_t<stores_inline, value_type, value_holder*>;
+        using data_type = slot_type;
+
+        /// @brief Leaves keep no summaries.
+        static constexpr bool keeps_summaries = false;
+
+        /// @brief Creates an empty leaf
+        LooseLeaf();
+    private:
+        std::array<slot_type, N> m_data;
+
+        /// @brief Returns the address of the value held by a leaf slot.
+        static const_pointer value_address(const slot_type&) noexcept;
+    };
+
+    /// @brief A loose internal node, holding pointers to its subnodes. `m_keys[0]` only keeps the keys sorted for the search.
+    template<class Traits, OrderedKey Key, Storable Mapped, std::size_t N, class Search>
+    class LooseInternal : public LooseNode<Traits, Key, Mapped, N, Search>{
+        template<ConcurrentKey, Storable, std::size_t, SingleElementAllocator, SingleElementAllocator, SingleElementAllocator, class>
+        friend class csaur::ConcurrentBPlusTree;
+        template<OrderedKey, Storable, std::size_t, SingleElementAllocator, SingleElementAllocator, SingleElementAllocator, class>
+        friend class csaur::SnapshotBPlusTree;
+        friend class BPlusNode<Key, Mapped, N, Search, NoAugment>;
+        #ifdef DEBUGGING_B_PLUS_TREE
+            friend class ::BPlusTest;
+        #endif
+    public:
+        using key_type = Key;
+        using size_type = std::size_t;
+        using node_type = LooseNode<Traits, Key, Mapped, N, Search>;
+        using leaf_type = LooseLeaf<Traits, Key, Mapped, N, Search>;
+        using data_type = node_type*;
+
+        /// @brief Internal nodes keep no summaries.
+        static constexpr bool keeps_summaries = false;
+
+        /// @brief Creates an empty internal node
+        LooseInternal();
+    private:
+        std::array<data_type, N> m_data;
+
+        /// @brief Finds the index of the subnode whose subtree may contain the given key. Stays below `N` even when
+        ///        the node is read while a writer changes it.
+        size_type child_index(const key_type& key) const;
+
+        /// @brief Refills one of the adjacent subnodes `m_data[index]` and `m_data[index + 1]` from the other, by merging
+        ///        them into the lower one if they fit in a single node, and by splitting their entries evenly otherwise.
+        ///        Both subnodes must be safe to change.
+        /// @param height The height of the subnodes, where leaves have height 0.
+        /// @return Whether they merged. The higher subnode is then unlinked and empty, and is for the caller to release.
+        bool refill(size_type index, size_type height);
+    };
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                         LooseLeaf Implementation Block                       //
+    //////////////////////////////////////////////////////////////////////////////////
+    template <class Traits, OrderedKey Key, Storable Mapped, std::size_t N, class Search>
+    LooseLeaf<Traits, Key, Mapped, N, Search>::LooseLeaf()
+    {
+        m_data = std::array<slot_type, N> ();
+    }
+
+    template <class Traits, OrderedKey Key, Storable Mapped, std::size_t N, class Search>
+    LooseLeaf<Traits, Key, Mapped, N, Search>::const_pointer LooseLeaf<Traits, Key, Mapped, N, Search>::value_address(const slot_type& slot) noexcept
+    {
+        if constexpr(stores_inline){
+            return &slot;
+        }
+        else if constexpr(std::is_same_v<value_holder, Mapped>){
+            return slot;
+        }
+        else{
+            return &slot->m_value;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                       LooseInternal Implementation Block                     //
+    //////////////////////////////////////////////////////////////////////////////////
+    template <class Traits, OrderedKey Key, Storable Mapped, std::size_t N, class Search>
+    LooseInternal<Traits, Key, Mapped, N, Search>::LooseInternal()
+    {
+        m_data = std::array<data_type, N> ();
+    }
+
+    template <class Traits, OrderedKey Key, Storable Mapped, std::size_t N, class Search>
+    LooseInternal<Traits, Key, Mapped, N, Search>::size_type LooseInternal<Traits, Key, Mapped, N, Search>::child_index(const key_type& key) const
+    {
+        size_type index = std::min(this->find_smallest_bigger_key_index(key), N);
+        return index - (index != 0);
+    }
+
+    template <class Traits, OrderedKey Key, Storable Mapped, std::size_t N, class Search>
+    bool LooseInternal<Traits, Key, Mapped, N, Search>::refill(size_type index, size_type height)
+    {
+        using base_type = BPlusNode<Key, Mapped, N, Search, NoAugment>;
+        node_type* lower = m_data[index];
+        node_type* higher = m_data[index + 1];
+        if (height != 0){
+            // the first key of an internal node may be below the keys under it. It becomes a separator below, so it
+            // takes the one from this node, which is not
+            higher->m_keys[0] = this->m_keys[index + 1];
+        }
+        if (lower->m_key_counter + higher->m_key_counter <= N){
+            if (height == 0){
+                base_type::append(*static_cast<leaf_type*>(lower), *static_cast<leaf_type*>(higher));
+            }
+            else{
+                base_type::append(*static_cast<LooseInternal*>(lower), *static_cast<LooseInternal*>(higher));
+            }
+            base_type::erase_at(*this, index + 1);
+            return true;
+        }
+        size_type lower_size = (lower->m_key_counter + higher->m_key_counter) / 2;
+        if (height == 0){
+            base_type::redistribute(*static_cast<leaf_type*>(lower), *static_cast<leaf_type*>(higher), lower_size);
+        }
+        else{
+            base_type::redistribute(*static_cast<LooseInternal*>(lower), *static_cast<LooseInternal*>(higher), lower_size);
+        }
+        this->m_keys[index + 1] = higher->m_keys[0];
+        if (index == 0){
+            this->m_keys[0] = lower->m_keys[0];     // kept at or below the keys under the first subnode
+        }
+        this->update_layout();
+        return false;
+    }
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef OPTIMISTIC_LOCK_CLASS_DEFINED
+#define OPTIMISTIC_LOCK_CLASS_DEFINED
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace csaur{
+    /// @brief A version word guarding a node under optimistic lock coupling. Readers take no lock: they note the
+    ///        version, read the node, and validate that the version did not change. Writers lock the word, which makes
+    ///        every reader that overlaps them fail its validation and restart.
+    /// @note The lowest bit marks a node that was unlinked from the tree, the next one marks a locked node, and the
+    ///       rest count the writes. Unlocking bumps the count, so a version is never seen twice.
+    class OptimisticLock{
+    public:
+        using version_type = std::uint64_t;
+
+        /// @brief Creates an unlocked word at version 0.
+        OptimisticLock();
+
+        OptimisticLock(const OptimisticLock&) = delete;
+        OptimisticLock& operator= (const OptimisticLock&) = delete;
+
+        /// @brief Waits until no writer holds the word, then notes its version.
+        /// @return False if the node was unlinked from the tree, in which case the reader must restart.
+        bool read_lock(version_type& version) const;
+
+        /// @brief Checks that no writer changed the node since its version was noted. Everything read from the node
+        ///        before a successful validation is consistent.
+        bool validate(version_type version) const;
+
+        /// @brief Turns a noted version into a write lock, if no writer changed the node since.
+        /// @return False if the version changed, in which case the writer must restart.
+        bool upgrade(version_type version);
+
+        /// @brief Waits for the word and locks it.
+        /// @note Only used on a node whose parent the caller holds, so the node cannot be unlinked meanwhile.
+        void lock();
+
+        /// @brief Releases the write lock and bumps the version.
+        void unlock();
+
+        /// @brief Releases the write lock and marks the node as unlinked, so every reader still on it restarts.
+        void unlock_obsolete();
+    private:
+        static constexpr version_type obsolete_bit = 1;
+        static constexpr version_type locked_bit = 2;
+
+        std::atomic<version_type> m_word;
+    };
+
+    inline OptimisticLock::OptimisticLock()
+    {
+        m_word.store(0, std::memory_order_relaxed);
+    }
+
+    inline bool OptimisticLock::read_lock(version_type& version) const
+    {
+        version = m_word.load(std::memory_order_acquire);
+        while (version & locked_bit){
+            std::this_thread::yield();
+            version = m_word.load(std::memory_order_acquire);
+        }
+        return !(version & obsolete_bit);
+    }
+
+    inline bool OptimisticLock::validate(version_type version) const
+    {
+        // the fence keeps the reads of the node from being reordered after the second look at the version
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return m_word.load(std::memory_order_relaxed) == version;
+    }
+
+    inline bool OptimisticLock::upgrade(version_type version)
+    {
+        return m_word.compare_exchange_strong(version, version + locked_bit, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    inline void OptimisticLock::lock()
+    {
+        for (;;){
+            version_type version = m_word.load(std::memory_order_relaxed);
+            if (!(version & locked_bit) && m_word.compare_exchange_weak(version, version + locked_bit, std::memory_order_acquire, std::memory_order_relaxed)){
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    inline void OptimisticLock::unlock()
+    {
+        // adding the locked bit again carries it into the count
+        m_word.fetch_add(locked_bit, std::memory_order_release);
+    }
+
+    inline void OptimisticLock::unlock_obsolete()
+    {
+        m_word.fetch_add(locked_bit | obsolete_bit, std::memory_order_release);
+    }
+};
+
+#endif
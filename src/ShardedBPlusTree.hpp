@@ -0,0 +1,419 @@
+#ifndef SHARDED_BPLUS_TREE_CLASS_DEFINED
+#define SHARDED_BPLUS_TREE_CLASS_DEFINED
+
+#include "BPlusTree.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+
+namespace csaur{
+    /// @brief A map split over several BPlusTrees, or shards, holding disjoint ranges of keys. Each shard has a lock
+    ///        of its own, so writes to different shards run in parallel, and batches are routed to their shards and
+    ///        worked on by a thread pool, one task per shard.
+    /// @note A routing table of split keys bounds the shards: shard i holds the keys in [bounds[i - 1], bounds[i]).
+    ///       Operations read the table under a shared lock, and `rebalance` changes it under an exclusive one.
+    /// @note `rebalance` moves the boundary between the busiest shard and its quieter neighbour, by splitting the busy
+    ///       shard at its median and joining one part into the neighbour. It needs a counting augmentation, which finds
+    ///       the median and the sizes of both parts in O(log n) node operations, where counting the entries of a part
+    ///       would walk its leaves. Nodes then change trees, so, as with BPlusTree moves, the allocators must be able to
+    ///       release them.
+    /// @note The nodes, allocators, search policies and augmentations are those of BPlusTree, but the augmentation
+    ///       defaults to OrderStatistics, so that the shards can be rebalanced.
+    template<OrderedKey Key,
+             Storable Mapped,
+             std::size_t N,
+             SingleElementAllocator ValueAlloc = DefaultAllocator<Mapped>,
+             SingleElementAllocator LeafAlloc = DefaultAllocator<BPlusLeaf<Key, Mapped, N>>,
+             SingleElementAllocator InternalAlloc = DefaultAllocator<BPlusInternal<Key, Mapped, N>>,
+             class Search = DefaultSearch,
+             class Augment = OrderStatistics
+            >
+    class ShardedBPlusTree{
+    public:
+        using tree_type = BPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>;
+        using key_type = Key;
+        using mapped_type = Mapped;
+        using value_type = mapped_type;
+        using entry_type = std::pair<key_type, mapped_type>;
+        using size_type = std::size_t;
+
+        /// @brief How many times the operations of its quieter neighbour a shard must take to be rebalanced.
+        static constexpr size_type hot_factor = 2;
+    private:
+        #ifdef DEBUGGING_B_PLUS_TREE
+            friend class ::BPlusTest;
+        #endif
+
+        struct alignas(64) Shard{
+            tree_type m_tree;
+            mutable std::shared_mutex m_mutex;
+            mutable std::atomic<size_type> m_load = 0;  // the operations routed to the shard since the last `rebalance`
+        };
+
+        /// @brief Returns the index of the shard whose range holds a key. The routing lock must be held.
+        size_type route(const key_type&) const;
+
+        /// @brief Groups the positions of a batch by the shard their keys route to, the positions of shard s ending up
+        ///        in `positions[offsets[s]]` to `positions[offsets[s + 1] - 1]`, in batch order. The routing lock must be held.
+        template<class KeyOf>
+        void route_batch(size_type count, KeyOf key_of, std::vector<size_type>& positions, std::vector<size_type>& offsets) const;
+
+        /// @brief Runs `func(shard, first, last)` on the pool for every shard that some positions of a batch route to,
+        ///        and rethrows the first exception a task threw once all of them have finished.
+        template<class Function>
+        void for_each_routed(const std::vector<size_type>& offsets, Function func) const;
+
+        mutable std::shared_mutex m_routing;
+        std::vector<key_type> m_bounds;
+        std::vector<std::unique_ptr<Shard>> m_shards;
+        mutable ThreadPool m_pool;
+    public:
+        /// @brief Creates an empty tree, with a shard for every range the split keys bound.
+        /// @param bounds The split keys, in ascending order. No keys make a single shard.
+        /// @param workers The number of threads working on batches besides the one submitting them.
+        /// @exception std::invalid_argument if the split keys are not in strictly ascending order.
+        explicit ShardedBPlusTree(std::vector<key_type> bounds = {}, size_type workers = std::max<size_type>(std::thread::hardware_concurrency(), 1) - 1);
+
+        ShardedBPlusTree(const ShardedBPlusTree&) = delete;
+        ShardedBPlusTree& operator= (const ShardedBPlusTree&) = delete;
+
+        /// @brief Returns the number of entries over every shard.
+        size_type size() const;
+
+        /// @brief Checks if every shard is empty.
+        bool is_empty() const;
+
+        /// @brief Returns the number of shards.
+        size_type shard_count() const;
+
+        /// @brief Returns the split keys bounding the shards.
+        std::vector<key_type> bounds() const;
+
+        /// @brief Inserts a key and its associated data into the shard holding it, unless the key is already there.
+        /// @return Whether the entry was inserted.
+        /// @note At failure, does not change contents.
+        bool insert(key_type&&, mapped_type&&);
+
+        /// @brief Erases a key and its associated data.
+        /// @return Whether the key was in the tree.
+        bool erase(const key_type&);
+
+        /// @brief Returns a copy of the value associated with a key, or nothing if the key is not in the tree.
+        /// @note A copy, since a reference would outlive the shard's lock.
+        std::optional<mapped_type> get(const key_type&) const;
+
+        /// @brief Checks if a key is in the tree.
+        bool contains(const key_type&) const;
+
+        /// @brief Inserts a batch of entries, moving them out of the span. Each shard inserts its part of the batch
+        ///        as a task of the pool, under a single acquisition of its lock.
+        /// @return The number of inserted entries. Entries whose keys were already in the tree, or came earlier in
+        ///         the batch, are not inserted.
+        /// @note At failure to allocate, the entries that could not be inserted are left out, as with `insert`.
+        size_type multi_insert(std::span<entry_type> entries);
+
+        /// @brief Looks up a batch of keys. Each shard looks up its part of the batch with `BPlusTree::multi_get`, as
+        ///        a task of the pool, under a single acquisition of its lock.
+        /// @param results Receives a copy of the value of `keys[i]` at `results[i]`, or nothing if the key is not in the tree.
+        /// @return The number of keys found.
+        /// @exception std::invalid_argument if there are fewer results than keys.
+        size_type multi_get(std::span<const key_type> keys, std::span<std::optional<mapped_type>> results) const;
+
+        /// @brief Calls `func(key, mapped)` on every entry, in ascending key order. Each shard is locked while it is read.
+        template<class Function> requires std::invocable<Function&, const key_type&, const mapped_type&>
+        void for_each(Function func) const;
+
+        /// @brief Moves half of the busiest shard into its quieter neighbour, if it took more than `hot_factor` times as
+        ///        many operations as that neighbour since the previous call. Blocks every other operation while it runs.
+        /// @return Whether a boundary moved.
+        /// @note At failure to split, does not change contents. Should the join fail after the split, the split part is
+        ///       kept as a shard of its own, which adds a shard.
+        bool rebalance() requires Augment::enabled;
+    };
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                           ShardedBPlusTree Routing                           //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    ShardedBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::ShardedBPlusTree(std::vector<key_type> bounds, size_type workers) : m_pool(workers)
+    {
+        for (size_type i = 1; i < bounds.size(); ++i){
+            if (!(bounds[i - 1] < bounds[i])){
+                throw std::invalid_argument("ShardedBPlusTree::ShardedBPlusTree: The split keys are not in strictly ascending order.\n");
+            }
+        }
+        m_bounds = std::move(bounds);
+        m_shards.reserve(m_bounds.size() + 1);
+        for (size_type i = 0; i <= m_bounds.size(); ++i){
+            m_shards.push_back(std::make_unique<Shard>());
+        }
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    ShardedBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type ShardedBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::route(const key_type& key) const
+    {
+        return std::upper_bound(m_bounds.begin(), m_bounds.end(), key) - m_bounds.begin();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <class KeyOf>
+    void ShardedBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::route_batch(size_type count, KeyOf key_of, std::vector<size_type>& positions, std::vector<size_type>& offsets) const
+    {
+        // a counting sort over the shards, which keeps the batch order within each of them
+        std::vector<size_type> shard_of(count);
+        offsets.assign(m_shards.size() + 1, 0);
+        for (size_type i = 0; i < count; ++i){
+            shard_of[i] = route(key_of(i));
+            ++offsets[shard_of[i] + 1];
+        }
+        for (size_type s = 1; s < offsets.size(); ++s){
+            offsets[s] += offsets[s - 1];
+        }
+        positions.resize(count);
+        std::vector<size_type> next(offsets.begin(), offsets.end() - 1);
+        for (size_type i = 0; i < count; ++i){
+            positions[next[shard_of[i]]++] = i;
+        }
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <class Function>
+    void ShardedBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::for_each_routed(const std::vector<size_type>& offsets, Function func) const
+    {
+        std::vector<size_type> busy;
+        for (size_type s = 0; s + 1 < offsets.size(); ++s){
+            if (offsets[s] != offsets[s + 1]){
+                busy.push_back(s);
+            }
+        }
+        std::vector<std::exception_ptr> failures(busy.size());
+        m_pool.for_each_task(busy.size(), [&](size_type task){
+            size_type shard = busy[task];
+            try{
+                func(*m_shards[shard], offsets[shard], offsets[shard + 1]);
+            }
+            catch(...){
+                failures[task] = std::current_exception();
+            }
+        });
+        for (std::exception_ptr& failure : failures){
+            if (failure){
+                std::rethrow_exception(failure);
+            }
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                          ShardedBPlusTree Observers                          //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    ShardedBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type ShardedBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size() const
+    {
+        std::shared_lock routing(m_routing);
+        size_type size = 0;
+        for (const auto& shard : m_shards){
+            std::shared_lock lock(shard->m_mutex);
+            size += shard->m_tree.size();
+        }
+        return size;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    bool ShardedBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::is_empty() const
+    {
+        return size() == 0;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    ShardedBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type ShardedBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::shard_count() const
+    {
+        std::shared_lock routing(m_routing);
+        return m_shards.size();
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    std::vector<Key> ShardedBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::bounds() const
+    {
+        std::shared_lock routing(m_routing);
+        return m_bounds;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                       ShardedBPlusTree Single Operations                     //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    bool ShardedBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::insert(key_type&& key, mapped_type&& mapped)
+    {
+        std::shared_lock routing(m_routing);
+        Shard& shard = *m_shards[route(key)];
+        shard.m_load.fetch_add(1, std::memory_order_relaxed);
+        std::unique_lock lock(shard.m_mutex);
+        size_type before = shard.m_tree.size();
+        shard.m_tree.insert(std::move(key), std::move(mapped));
+        return shard.m_tree.size() != before;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    bool ShardedBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::erase(const key_type& key)
+    {
+        std::shared_lock routing(m_routing);
+        Shard& shard = *m_shards[route(key)];
+        shard.m_load.fetch_add(1, std::memory_order_relaxed);
+        std::unique_lock lock(shard.m_mutex);
+        return shard.m_tree.erase(key);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    std::optional<Mapped> ShardedBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::get(const key_type& key) const
+    {
+        std::shared_lock routing(m_routing);
+        const Shard& shard = *m_shards[route(key)];
+        shard.m_load.fetch_add(1, std::memory_order_relaxed);
+        std::shared_lock lock(shard.m_mutex);
+        auto entry = shard.m_tree.find(key);
+        if (entry == shard.m_tree.end()){
+            return std::nullopt;
+        }
+        return *entry;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    bool ShardedBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::contains(const key_type& key) const
+    {
+        std::shared_lock routing(m_routing);
+        const Shard& shard = *m_shards[route(key)];
+        shard.m_load.fetch_add(1, std::memory_order_relaxed);
+        std::shared_lock lock(shard.m_mutex);
+        return shard.m_tree.contains(key);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                       ShardedBPlusTree Batch Operations                      //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    ShardedBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type ShardedBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::multi_insert(std::span<entry_type> entries)
+    {
+        std::shared_lock routing(m_routing);
+        std::vector<size_type> positions, offsets;
+        route_batch(entries.size(), [&](size_type i)->const key_type& { return entries[i].first; }, positions, offsets);
+        std::atomic<size_type> inserted = 0;
+        for_each_routed(offsets, [&](Shard& shard, size_type first, size_type last){
+            shard.m_load.fetch_add(last - first, std::memory_order_relaxed);
+            std::unique_lock lock(shard.m_mutex);
+            size_type before = shard.m_tree.size();
+            for (size_type i = first; i < last; ++i){
+                entry_type& entry = entries[positions[i]];
+                shard.m_tree.insert(std::move(entry.first), std::move(entry.second));
+            }
+            inserted.fetch_add(shard.m_tree.size() - before, std::memory_order_relaxed);
+        });
+        return inserted.load(std::memory_order_relaxed);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    ShardedBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::size_type ShardedBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::multi_get(std::span<const key_type> keys, std::span<std::optional<mapped_type>> results) const
+    {
+        if (results.size() < keys.size()){
+            throw std::invalid_argument("ShardedBPlusTree::multi_get: There are fewer results than keys.\n");
+        }
+        std::shared_lock routing(m_routing);
+        std::vector<size_type> positions, offsets;
+        route_batch(keys.size(), [&](size_type i)->const key_type& { return keys[i]; }, positions, offsets);
+        // the keys of each shard are gathered next to each other, as BPlusTree::multi_get takes them
+        std::vector<key_type> routed_keys;
+        routed_keys.reserve(keys.size());
+        for (size_type position : positions){
+            routed_keys.push_back(keys[position]);
+        }
+        std::vector<const mapped_type*> found(keys.size());
+        std::atomic<size_type> found_count = 0;
+        for_each_routed(offsets, [&](const Shard& shard, size_type first, size_type last){
+            shard.m_load.fetch_add(last - first, std::memory_order_relaxed);
+            std::shared_lock lock(shard.m_mutex);
+            std::span<const key_type> shard_keys(routed_keys.data() + first, last - first);
+            found_count.fetch_add(shard.m_tree.multi_get(shard_keys, std::span<const mapped_type*>(found.data() + first, last - first)), std::memory_order_relaxed);
+            for (size_type i = first; i < last; ++i){
+                if (found[i] != nullptr){
+                    results[positions[i]] = *found[i];
+                }
+                else{
+                    results[positions[i]].reset();
+                }
+            }
+        });
+        return found_count.load(std::memory_order_relaxed);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    template <class Function> requires std::invocable<Function&, const Key&, const Mapped&>
+    void ShardedBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::for_each(Function func) const
+    {
+        std::shared_lock routing(m_routing);
+        for (const auto& shard : m_shards){
+            std::shared_lock lock(shard->m_mutex);
+            for (auto entry = shard->m_tree.begin(); entry != shard->m_tree.end(); ++entry){
+                func(entry.key(), *entry);
+            }
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                         ShardedBPlusTree Rebalancing                         //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search, class Augment>
+    bool ShardedBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search, Augment>::rebalance() requires Augment::enabled
+    {
+        // with the routing table held exclusively, no operation holds or waits for a shard lock
+        std::unique_lock routing(m_routing);
+        size_type count = m_shards.size();
+        std::vector<size_type> loads(count);
+        for (size_type s = 0; s < count; ++s){
+            loads[s] = m_shards[s]->m_load.exchange(0, std::memory_order_relaxed);
+        }
+        size_type hot = std::max_element(loads.begin(), loads.end()) - loads.begin();
+        if (count < 2){
+            return false;
+        }
+        bool to_right = hot == 0 || (hot + 1 < count && loads[hot + 1] < loads[hot - 1]);
+        size_type cold = to_right ? hot + 1 : hot - 1;
+        tree_type& hot_tree = m_shards[hot]->m_tree;
+        if (loads[hot] <= hot_factor * loads[cold] || hot_tree.size() < 2){
+            return false;
+        }
+        tree_type& cold_tree = m_shards[cold]->m_tree;
+        // everything a failed join needs to keep the split part as a shard of its own is allocated up front
+        auto spare = std::make_unique<Shard>();
+        m_shards.reserve(count + 1);
+        m_bounds.reserve(count);
+        key_type middle = hot_tree.select(hot_tree.size() / 2).key();
+        tree_type upper = hot_tree.split(middle);
+        try{
+            if (to_right){
+                upper.join(std::move(cold_tree));
+                cold_tree = std::move(upper);
+                m_bounds[hot] = std::move(middle);
+            }
+            else{
+                cold_tree.join(std::move(hot_tree));
+                hot_tree = std::move(upper);
+                m_bounds[cold] = std::move(middle);
+            }
+        }
+        catch(const std::bad_alloc&){
+            spare->m_tree = std::move(upper);
+            m_shards.insert(m_shards.begin() + hot + 1, std::move(spare));
+            m_bounds.insert(m_bounds.begin() + hot, std::move(middle));
+        }
+        return true;
+    }
+};
+
+#endif
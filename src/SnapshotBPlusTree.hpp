@@ -0,0 +1,706 @@
+#ifndef SNAPSHOT_BPLUS_TREE_CLASS_DEFINED
+#define SNAPSHOT_BPLUS_TREE_CLASS_DEFINED
+
+#include "SnapshotNode.hpp"
+#include "DefaultAllocator.hpp"
+#include <atomic>
+#include <concepts>
+#include <new>
+#include <utility>
+
+namespace csaur{
+    /// @brief A B+ tree whose snapshots are taken in O(1) and stay unchanged while the tree is written to. Nodes and
+    ///        values are reference counted and shared between the tree and its snapshots. A write copies the nodes on
+    ///        its path that are shared, and changes the copies, so a snapshot costs memory only in proportion to the
+    ///        nodes written to after it was taken.
+    /// @note The tree is written to from one thread at a time, which also takes the snapshots. Snapshots may be read,
+    ///       copied and released from any thread meanwhile, since the nodes they reach are never changed. Releasing
+    ///       one returns its nodes to the allocators of the tree, so they must be thread-safe, as DefaultAllocator is.
+    /// @note Leaves are not chained, since a leaf may be shared by trees whose neighbouring leaves differ, so scans
+    ///       descend from the root. Values are only handed out as pointers to const, since they may be shared.
+    /// @tparam Search The policy used to search the keys within a node, see KeySearch.hpp.
+    template<OrderedKey Key,
+             Storable Mapped,
+             std::size_t N,
+             SingleElementAllocator ValueAlloc = DefaultAllocator<Mapped>,
+             SingleElementAllocator LeafAlloc = DefaultAllocator<SnapshotLeaf<Key, Mapped, N>>,
+             SingleElementAllocator InternalAlloc = DefaultAllocator<SnapshotInternal<Key, Mapped, N>>,
+             class Search = DefaultSearch
+            >
+    class SnapshotBPlusTree{
+        #ifdef DEBUGGING_B_PLUS_TREE
+            friend class ::BPlusTest;
+        #endif
+    public:
+        using key_type = Key;
+        using mapped_type = Mapped;
+        using value_type = mapped_type;
+        using const_pointer = const value_type*;
+        using size_type = std::size_t;
+        using node_type = SnapshotNode<Key, Mapped, N, Search>;
+        using leaf_type = SnapshotLeaf<Key, Mapped, N, Search>;
+        using internal_type = SnapshotInternal<Key, Mapped, N, Search>;
+        using shared_value_type = SnapshotValue<Mapped>;
+        using value_allocator = rebind_allocator_t<ValueAlloc, shared_value_type>;
+        using leaf_allocator = rebind_allocator_t<LeafAlloc, leaf_type>;
+        using internal_allocator = rebind_allocator_t<InternalAlloc, internal_type>;
+        using search_policy = Search;
+
+        /// @brief A read-only view of the tree as it was when the snapshot was taken, which later writes to the tree
+        ///        do not change. It refers to the root of the tree at the time, rather than copying anything.
+        /// @note A snapshot must be released before the tree it was taken from.
+        class Snapshot{
+            friend class SnapshotBPlusTree;
+            #ifdef DEBUGGING_B_PLUS_TREE
+                friend class ::BPlusTest;
+            #endif
+        public:
+            /// @brief Shares the view of another snapshot, in O(1).
+            Snapshot(const Snapshot&);
+            Snapshot(Snapshot&&) noexcept;
+
+            /// @brief Releases the view held, and shares the one of another snapshot instead.
+            Snapshot& operator= (const Snapshot&);
+            Snapshot& operator= (Snapshot&&) noexcept;
+
+            /// @brief Releases the nodes and values only this snapshot still refers to.
+            ~Snapshot();
+
+            /// @brief Returns the number of entries the tree had when the snapshot was taken.
+            size_type size() const noexcept;
+
+            /// @brief Checks if the tree was empty when the snapshot was taken.
+            bool is_empty() const noexcept;
+
+            /// @brief Returns the value mapped to a key, or nullptr if the key is not in the snapshot. The value lives
+            ///        as long as the snapshot.
+            const_pointer find(const key_type&) const;
+
+            /// @brief Checks if a key is in the snapshot.
+            bool contains(const key_type&) const;
+
+            /// @brief Calls `func(key, mapped)` on every entry whose key is in the range [lo, hi), in ascending key order.
+            template<class Function> requires std::invocable<Function&, const key_type&, const mapped_type&>
+            void for_each_in_range(const key_type& lo, const key_type& hi, Function func) const;
+
+            /// @brief Calls `func(key, mapped)` on every entry, in ascending key order.
+            template<class Function> requires std::invocable<Function&, const key_type&, const mapped_type&>
+            void for_each(Function func) const;
+        private:
+            /// @brief Takes a snapshot of a tree, referring to its root once more.
+            explicit Snapshot(const SnapshotBPlusTree&);
+
+            const SnapshotBPlusTree* m_tree;
+            node_type* m_root;                      // nullptr once moved from
+            size_type m_height;
+            size_type m_size;
+        };
+
+        /// @brief Creates an empty tree.
+        SnapshotBPlusTree();
+
+        SnapshotBPlusTree(const SnapshotBPlusTree&) = delete;
+        SnapshotBPlusTree& operator= (const SnapshotBPlusTree&) = delete;
+
+        /// @brief Releases the nodes and values only the tree still refers to. Every snapshot taken from the tree must
+        ///        have been released before.
+        ~SnapshotBPlusTree();
+
+        /// @brief Returns the number of entries.
+        size_type size() const noexcept;
+
+        /// @brief Checks if the tree holds no entries.
+        bool is_empty() const noexcept;
+
+        /// @brief Takes a snapshot of the tree in O(1), by sharing its root.
+        /// @note Until written to again, the tree shares every node with the snapshot. The first write after copies the
+        ///       nodes on its path, about log(n) of them, and later writes copy the nodes they reach that are still shared.
+        Snapshot snapshot() const;
+
+        /// @brief Returns the value mapped to a key, or nullptr if the key is not in the tree. The value lives until the
+        ///        next write to the tree.
+        const_pointer find(const key_type&) const;
+
+        /// @brief Checks if a key is in the tree.
+        bool contains(const key_type&) const;
+
+        /// @brief Calls `func(key, mapped)` on every entry whose key is in the range [lo, hi), in ascending key order.
+        template<class Function> requires std::invocable<Function&, const key_type&, const mapped_type&>
+        void for_each_in_range(const key_type& lo, const key_type& hi, Function func) const;
+
+        /// @brief Calls `func(key, mapped)` on every entry, in ascending key order.
+        template<class Function> requires std::invocable<Function&, const key_type&, const mapped_type&>
+        void for_each(Function func) const;
+
+        /// @brief Inserts an entry, unless its key is already in the tree.
+        /// @return Whether the entry was inserted.
+        /// @note At failure, does not change contents and returns false.
+        bool insert(key_type&&, mapped_type&&) noexcept;
+
+        /// @brief Inserts an entry, or maps its key to the new value if the key is already in the tree. The snapshots
+        ///        that hold the old value keep it.
+        /// @return Whether a new entry was inserted.
+        /// @note At failure, does not change contents and returns false.
+        bool insert_or_assign(key_type&&, mapped_type&&) noexcept;
+
+        /// @brief Erases the entry with a given key.
+        /// @return Whether there was such an entry.
+        /// @exception std::bad_alloc if a shared node the erasure changes cannot be copied. Contents are not changed then.
+        bool erase(const key_type&);
+    private:
+        using slot_type = typename leaf_type::slot_type;
+
+        /// @brief An upper bound on the height of any tree, since every non-root internal node has at least two subnodes.
+        static constexpr size_type max_height = 8 * sizeof(size_type);
+
+        /// @brief Finds the value mapped to a key in a subtree, or nullptr if the key is not in it.
+        /// @param height The height of the subtree's root, where leaves have height 0.
+        static const_pointer find_in(const node_type* node, size_type height, const key_type& key);
+
+        /// @brief Calls `func(key, mapped)` on every entry of a subtree whose key is in the range [*lo, *hi).
+        /// @param lo The lower bound of the range, or nullptr if the range is unbounded below.
+        /// @param hi The upper bound of the range, or nullptr if the range is unbounded above.
+        template<class Function>
+        static void scan(const node_type* node, size_type height, const key_type* lo, const key_type* hi, Function& func);
+
+        /// @brief Makes the node a link points to referred to by that link alone, so that it may be changed. A shared
+        ///        node is copied, its subnodes or values are shared by the copy, and the link is set to the copy.
+        /// @param height The height of the node, where leaves have height 0.
+        /// @return The node the link points to afterwards.
+        /// @note At failure, does not change contents, since the copy would hold the same entries.
+        node_type* own(node_type*& link, size_type height);
+
+        /// @brief The common part of insert and insert_or_assign.
+        /// @tparam Assign Whether to map an existing key to the new value.
+        template<bool Assign>
+        bool insert_impl(key_type&&, mapped_type&&) noexcept;
+
+        /// @brief Merges two adjacent subnodes of a node, or evens out their entries if they do not fit in one. All
+        ///        three nodes must be referred to once.
+        /// @param index The index of the lower of the two subnodes.
+        /// @param height The height of the subnodes, where leaves have height 0.
+        void refill(internal_type* node, size_type index, size_type height);
+
+        /// @brief Drops a reference to a subtree, releasing its root, and the subnodes and values only it referred to,
+        ///        if that was the last one. Called by snapshots from any thread.
+        /// @param height The height of the subtree's root, where leaves have height 0.
+        void release(node_type* node, size_type height) const;
+
+        /// @brief Drops a reference to a value that is not stored inline, releasing it if that was the last one.
+        void release(slot_type slot) const;
+
+        /// @brief Returns a node to its allocator, leaving alone what it refers to.
+        /// @param height The height of the node, where leaves have height 0.
+        void deallocate(node_type* node, size_type height) const;
+
+        node_type* m_root;
+        size_type m_height;
+        size_type m_size;
+        // snapshots of a const tree release what they refer to through it
+        [[no_unique_address]] mutable leaf_allocator m_leaf_alloc;
+        [[no_unique_address]] mutable internal_allocator m_internal_alloc;
+        [[no_unique_address]] mutable value_allocator m_val_alloc;
+    };
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                           SnapshotBPlusTree Snapshot                         //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::Snapshot::Snapshot(const SnapshotBPlusTree& tree)
+    {
+        m_tree = &tree;
+        m_root = tree.m_root;
+        m_height = tree.m_height;
+        m_size = tree.m_size;
+        m_root->m_references.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::Snapshot::Snapshot(const Snapshot& other)
+    {
+        m_tree = other.m_tree;
+        m_root = other.m_root;
+        m_height = other.m_height;
+        m_size = other.m_size;
+        if (m_root != nullptr){
+            m_root->m_references.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::Snapshot::Snapshot(Snapshot&& other) noexcept
+    {
+        m_tree = other.m_tree;
+        m_root = std::exchange(other.m_root, nullptr);
+        m_height = other.m_height;
+        m_size = std::exchange(other.m_size, 0);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::Snapshot& SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::Snapshot::operator= (const Snapshot& other)
+    {
+        return *this = Snapshot(other);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::Snapshot& SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::Snapshot::operator= (Snapshot&& other) noexcept
+    {
+        std::swap(m_tree, other.m_tree);
+        std::swap(m_root, other.m_root);
+        std::swap(m_height, other.m_height);
+        std::swap(m_size, other.m_size);
+        return *this;                               // the view held before goes with `other`
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::Snapshot::~Snapshot()
+    {
+        if (m_root != nullptr){
+            m_tree->release(m_root, m_height);
+        }
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::size_type SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::Snapshot::size() const noexcept
+    {
+        return m_size;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    bool SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::Snapshot::is_empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::const_pointer SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::Snapshot::find(const key_type& key) const
+    {
+        return (m_root != nullptr) ? find_in(m_root, m_height, key) : nullptr;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    bool SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::Snapshot::contains(const key_type& key) const
+    {
+        return find(key) != nullptr;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    template <class Function> requires std::invocable<Function&, const Key&, const Mapped&>
+    void SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::Snapshot::for_each_in_range(const key_type& lo, const key_type& hi, Function func) const
+    {
+        if (m_root != nullptr){
+            scan(m_root, m_height, &lo, &hi, func);
+        }
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    template <class Function> requires std::invocable<Function&, const Key&, const Mapped&>
+    void SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::Snapshot::for_each(Function func) const
+    {
+        if (m_root != nullptr){
+            scan(m_root, m_height, nullptr, nullptr, func);
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                          SnapshotBPlusTree CTOR & DTOR                       //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::SnapshotBPlusTree()
+    {
+        m_root = std::construct_at(m_leaf_alloc.allocate());
+        m_height = 0;
+        m_size = 0;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::~SnapshotBPlusTree()
+    {
+        release(m_root, m_height);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                          SnapshotBPlusTree Observers                         //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::size_type SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::size() const noexcept
+    {
+        return m_size;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    bool SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::is_empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::Snapshot SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::snapshot() const
+    {
+        return Snapshot(*this);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                           SnapshotBPlusTree Lookup                           //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::const_pointer SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::find_in(const node_type* node, size_type height, const key_type& key)
+    {
+        for (; height > 0; --height){
+            auto internal = static_cast<const internal_type*>(node);
+            node = internal->m_data[internal->child_index(key)];
+        }
+        auto leaf = static_cast<const leaf_type*>(node);
+        size_type index = leaf->find_smallest_bigger_key_index(key);
+        if (index == 0 || !(leaf->m_keys[index - 1] == key)){
+            return nullptr;
+        }
+        return leaf_type::value_address(leaf->m_data[index - 1]);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    template <class Function>
+    void SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::scan(const node_type* node, size_type height, const key_type* lo, const key_type* hi, Function& func)
+    {
+        if (height == 0){
+            auto leaf = static_cast<const leaf_type*>(node);
+            for (size_type i = (lo != nullptr) ? leaf->find_smallest_not_smaller_key_index(*lo) : 0; i < leaf->m_key_counter && (hi == nullptr || leaf->m_keys[i] < *hi); ++i){
+                func(leaf->m_keys[i], *leaf_type::value_address(leaf->m_data[i]));
+            }
+            return;
+        }
+        // only the subnodes holding the ends of the range need the bounds, the ones between lie inside it
+        auto internal = static_cast<const internal_type*>(node);
+        size_type first = (lo != nullptr) ? internal->child_index(*lo) : 0;
+        size_type last = (hi != nullptr) ? internal->child_index(*hi) : internal->m_key_counter - 1;
+        for (size_type i = first; i <= last; ++i){
+            scan(internal->m_data[i], height - 1, (i == first) ? lo : nullptr, (i == last) ? hi : nullptr, func);
+        }
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::const_pointer SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::find(const key_type& key) const
+    {
+        return find_in(m_root, m_height, key);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    bool SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::contains(const key_type& key) const
+    {
+        return find(key) != nullptr;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    template <class Function> requires std::invocable<Function&, const Key&, const Mapped&>
+    void SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::for_each_in_range(const key_type& lo, const key_type& hi, Function func) const
+    {
+        scan(m_root, m_height, &lo, &hi, func);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    template <class Function> requires std::invocable<Function&, const Key&, const Mapped&>
+    void SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::for_each(Function func) const
+    {
+        scan(m_root, m_height, nullptr, nullptr, func);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                           SnapshotBPlusTree Insert                           //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::node_type* SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::own(node_type*& link, size_type height)
+    {
+        node_type* node = link;
+        // acquiring what the other holders did with the node before letting go of it, so it may be changed now
+        if (node->m_references.load(std::memory_order_acquire) == 1){
+            return node;
+        }
+        node_type* copy;
+        if (height == 0){
+            auto source = static_cast<const leaf_type*>(node);
+            leaf_type* leaf = std::construct_at(m_leaf_alloc.allocate());
+            try{
+                std::copy(source->m_keys.begin(), source->m_keys.begin() + source->m_key_counter, leaf->m_keys.begin());
+            }
+            catch(...){
+                deallocate(leaf, 0);
+                throw;
+            }
+            std::copy(source->m_data.begin(), source->m_data.begin() + source->m_key_counter, leaf->m_data.begin());
+            if constexpr(!leaf_type::stores_inline){
+                for (size_type i = 0; i < source->m_key_counter; ++i){
+                    leaf->m_data[i]->m_references.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            copy = leaf;
+        }
+        else{
+            auto source = static_cast<const internal_type*>(node);
+            internal_type* internal = std::construct_at(m_internal_alloc.allocate());
+            try{
+                std::copy(source->m_keys.begin(), source->m_keys.begin() + source->m_key_counter, internal->m_keys.begin());
+            }
+            catch(...){
+                deallocate(internal, height);
+                throw;
+            }
+            std::copy(source->m_data.begin(), source->m_data.begin() + source->m_key_counter, internal->m_data.begin());
+            for (size_type i = 0; i < source->m_key_counter; ++i){
+                internal->m_data[i]->m_references.fetch_add(1, std::memory_order_relaxed);
+            }
+            copy = internal;
+        }
+        copy->m_key_counter = node->m_key_counter;
+        copy->update_layout();
+        link = copy;
+        release(node, height);                      // the last holder may have let go of it meanwhile
+        return copy;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    bool SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::insert(key_type&& key, mapped_type&& mapped) noexcept
+    {
+        return insert_impl<false>(std::move(key), std::move(mapped));
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    bool SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::insert_or_assign(key_type&& key, mapped_type&& mapped) noexcept
+    {
+        return insert_impl<true>(std::move(key), std::move(mapped));
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    template <bool Assign>
+    bool SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::insert_impl(key_type&& key, mapped_type&& mapped) noexcept
+    {
+        if (!Assign && find(key) != nullptr){
+            return false;                           // without copying the shared nodes on the way
+        }
+        slot_type slot = slot_type();
+        bool linked = false, inserted = false;
+        // one spare node per split, from the leaf up, and one for a new root
+        std::array<node_type*, max_height + 1> spares = {};
+        size_type splits = 0;
+        try{
+            if constexpr(leaf_type::stores_inline){
+                slot = std::move(mapped);
+            }
+            else{
+                shared_value_type* value = m_val_alloc.allocate();
+                try{
+                    slot = std::construct_at(value, std::move(mapped));
+                }
+                catch(...){
+                    m_val_alloc.deallocate(value);
+                    throw;
+                }
+            }
+
+            std::array<internal_type*, max_height> path;
+            std::array<size_type, max_height> indices;
+            node_type* node = own(m_root, m_height);
+            for (size_type level = 0; level < m_height; ++level){
+                auto internal = static_cast<internal_type*>(node);
+                size_type index = internal->child_index(key);
+                if (key < internal->m_keys[index]){
+                    // only possible in the first subnode. Its key is lowered, so that it stays below the separator
+                    // of a sibling the subnode may split into
+                    internal->m_keys[index] = key;
+                    internal->update_layout();
+                }
+                path[level] = internal;
+                indices[level] = index;
+                node = own(internal->m_data[index], m_height - level - 1);
+            }
+
+            auto leaf = static_cast<leaf_type*>(node);
+            size_type index = leaf->find_smallest_bigger_key_index(key);
+            if (index != 0 && leaf->m_keys[index - 1] == key){
+                if constexpr(Assign){
+                    std::swap(leaf->m_data[index - 1], slot);
+                    linked = true;
+                }
+            }
+            else{
+                // the nodes the splits take are allocated before any node is split, so a failure leaves the tree intact
+                if (leaf->m_key_counter == N){
+                    splits = 1;
+                    while (splits <= m_height && path[m_height - splits]->m_key_counter == N){
+                        ++splits;
+                    }
+                }
+                for (size_type s = 0; s < splits; ++s){
+                    spares[s] = (s == 0) ? static_cast<node_type*>(std::construct_at(m_leaf_alloc.allocate()))
+                                         : static_cast<node_type*>(std::construct_at(m_internal_alloc.allocate()));
+                }
+                if (splits > m_height){
+                    spares[splits] = std::construct_at(m_internal_alloc.allocate());
+                }
+
+                if (splits == 0){
+                    node_type::insert_at(*leaf, index, std::move(key), std::move(slot));
+                }
+                else{
+                    auto sibling = static_cast<leaf_type*>(spares[0]);
+                    node_type::split_insert(*leaf, *sibling, index, std::move(key), std::move(slot));
+                    node_type* lower = leaf, * higher = sibling;
+                    for (size_type s = 1; ; ++s){
+                        if (s > m_height){
+                            auto root = static_cast<internal_type*>(spares[s]);
+                            node_type::insert_at(*root, 0, key_type(lower->m_keys[0]), std::move(lower));
+                            node_type::insert_at(*root, 1, key_type(higher->m_keys[0]), std::move(higher));
+                            m_root = root;
+                            ++m_height;
+                            break;
+                        }
+                        internal_type* parent = path[m_height - s];
+                        size_type at = indices[m_height - s] + 1;
+                        if (s == splits){
+                            node_type::insert_at(*parent, at, key_type(higher->m_keys[0]), std::move(higher));
+                            break;
+                        }
+                        auto parent_sibling = static_cast<internal_type*>(spares[s]);
+                        node_type::split_insert(*parent, *parent_sibling, at, key_type(higher->m_keys[0]), std::move(higher));
+                        lower = parent;
+                        higher = parent_sibling;
+                    }
+                }
+                spares = {};
+                ++m_size;
+                linked = inserted = true;
+            }
+        }
+        catch(std::bad_alloc& e){
+        }
+
+        for (size_type s = 0; s <= splits; ++s){
+            if (spares[s] != nullptr){
+                deallocate(spares[s], s == 0 ? 0 : 1);
+            }
+        }
+        if constexpr(!leaf_type::stores_inline){
+            // the value that was replaced, or the new one if it was not linked
+            if ((!inserted && linked) || (!linked && slot != nullptr)){
+                release(slot);
+            }
+        }
+        return inserted;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                            SnapshotBPlusTree Erase                           //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    bool SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::erase(const key_type& key)
+    {
+        if (find(key) == nullptr){
+            return false;                           // without copying the shared nodes on the way
+        }
+        std::array<internal_type*, max_height> path;
+        std::array<size_type, max_height> indices;
+        node_type* node = own(m_root, m_height);
+        for (size_type level = 0; level < m_height; ++level){
+            auto internal = static_cast<internal_type*>(node);
+            path[level] = internal;
+            indices[level] = internal->child_index(key);
+            node = own(internal->m_data[indices[level]], m_height - level - 1);
+        }
+        // the siblings the refills will change are owned before anything changes, since copying them may throw.
+        // A node left underfull merges with its sibling if they fit in one, which may leave their parent underfull
+        for (size_type level = m_height, count = node->m_key_counter - 1; level-- > 0 && count < node_type::min_keys; ){
+            internal_type* parent = path[level];
+            size_type sibling = (indices[level] != 0) ? indices[level] - 1 : indices[level] + 1;
+            node_type* other = own(parent->m_data[sibling], m_height - level - 1);
+            count = (count + other->m_key_counter <= N) ? parent->m_key_counter - 1 : node_type::min_keys;
+        }
+
+        auto leaf = static_cast<leaf_type*>(node);
+        size_type index = leaf->find_smallest_bigger_key_index(key) - 1;
+        slot_type slot = std::move(leaf->m_data[index]);
+        node_type::erase_at(*leaf, index);
+        --m_size;
+        if constexpr(!leaf_type::stores_inline){
+            release(slot);
+        }
+        for (size_type level = m_height; level-- > 0 && path[level]->m_data[indices[level]]->m_key_counter < node_type::min_keys; ){
+            refill(path[level], (indices[level] != 0) ? indices[level] - 1 : indices[level], m_height - level - 1);
+        }
+        if (m_height > 0 && m_root->m_key_counter == 1){
+            // the root's only subnode becomes the root, taking over the reference the root held to it
+            node_type* root = m_root;
+            m_root = static_cast<internal_type*>(root)->m_data[0];
+            deallocate(root, m_height--);
+        }
+        return true;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    void SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::refill(internal_type* node, size_type index, size_type height)
+    {
+        node_type* higher = node->m_data[index + 1];
+        if (node->refill(index, height)){
+            deallocate(higher, height);             // its entries moved to the lower node, along with its references
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                          SnapshotBPlusTree Releasing                         //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    void SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::release(node_type* node, size_type height) const
+    {
+        // releasing, so that another holder that finds itself the last one may change the node, and acquiring, so
+        // that the last holder sees what the others did with it before releasing it
+        if (node->m_references.fetch_sub(1, std::memory_order_acq_rel) != 1){
+            return;
+        }
+        if (height == 0){
+            if constexpr(!leaf_type::stores_inline){
+                auto leaf = static_cast<leaf_type*>(node);
+                for (size_type i = 0; i < leaf->m_key_counter; ++i){
+                    release(leaf->m_data[i]);
+                }
+            }
+        }
+        else{
+            auto internal = static_cast<internal_type*>(node);
+            for (size_type i = 0; i < internal->m_key_counter; ++i){
+                release(internal->m_data[i], height - 1);
+            }
+        }
+        deallocate(node, height);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    void SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::release(slot_type slot) const
+    {
+        if constexpr(!leaf_type::stores_inline){
+            if (slot->m_references.fetch_sub(1, std::memory_order_acq_rel) == 1){
+                std::destroy_at(slot);
+                m_val_alloc.deallocate(slot);
+            }
+        }
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator ValueAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    void SnapshotBPlusTree<Key, Mapped, N, ValueAlloc, LeafAlloc, InternalAlloc, Search>::deallocate(node_type* node, size_type height) const
+    {
+        if (height == 0){
+            std::destroy_at(static_cast<leaf_type*>(node));
+            m_leaf_alloc.deallocate(static_cast<leaf_type*>(node));
+        }
+        else{
+            std::destroy_at(static_cast<internal_type*>(node));
+            m_internal_alloc.deallocate(static_cast<internal_type*>(node));
+        }
+    }
+};
+
+#endif
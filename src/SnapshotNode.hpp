@@ -0,0 +1,48 @@
+#ifndef SNAPSHOT_NODE_CLASS_DEFINED
+#define SNAPSHOT_NODE_CLASS_DEFINED
+
+#include "LooseNode.hpp"
+#include <atomic>
+
+namespace csaur{
+    /// @brief The number of trees, snapshots and nodes that refer to a node or a value of a SnapshotBPlusTree.
+    struct SnapshotReferences{
+        std::atomic<std::size_t> m_references = 1;
+    };
+
+    /// @brief A value of a SnapshotBPlusTree that is not stored inline. It is shared by every leaf copied from the leaf
+    ///        it was linked into, and is never changed once linked: assigning to a key links a new value.
+    template<Storable Mapped>
+    struct SnapshotValue : SnapshotReferences{
+        Mapped m_value;
+
+        template<typename ... Args>
+        explicit SnapshotValue(Args&& ... args) : m_value(std::forward<Args>(args)...) {}
+    };
+
+    /// @brief The traits of the loose nodes of a SnapshotBPlusTree, see LooseNode.hpp.
+    struct SnapshotNodeTraits{
+        using header_type = SnapshotReferences;
+
+        template<Storable Mapped>
+        using value_holder = SnapshotValue<Mapped>;
+    };
+
+    /// @brief The part shared by the nodes of a SnapshotBPlusTree: the keys of a BPlusNode and a reference count.
+    /// @note A node referred to more than once may be read by snapshots from other threads, so it is never changed.
+    ///       The tree copies it first, and changes the copy.
+    template<OrderedKey Key, Storable Mapped, std::size_t N, class Search = DefaultSearch>
+    using SnapshotNode = LooseNode<SnapshotNodeTraits, Key, Mapped, N, Search>;
+
+    /// @brief A leaf of a SnapshotBPlusTree. Leaves are not linked to their neighbours, since a leaf may be shared by
+    ///        trees whose neighbouring leaves differ.
+    template<OrderedKey Key, Storable Mapped, std::size_t N, class Search = DefaultSearch>
+    using SnapshotLeaf = LooseLeaf<SnapshotNodeTraits, Key, Mapped, N, Search>;
+
+    /// @brief An internal node of a SnapshotBPlusTree. Its separators are loose, so that erasing the first key of a
+    ///        leaf does not have to copy the nodes above it that are not on its path.
+    template<OrderedKey Key, Storable Mapped, std::size_t N, class Search = DefaultSearch>
+    using SnapshotInternal = LooseInternal<SnapshotNodeTraits, Key, Mapped, N, Search>;
+};
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef THREAD_POOL_CLASS_DEFINED
+#define THREAD_POOL_CLASS_DEFINED
+
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace csaur{
+    /// @brief A fixed set of worker threads that run batches of numbered tasks. The thread submitting a batch works on
+    ///        it too, and returns once every task of it has finished, so a pool without workers runs batches inline.
+    /// @note Tasks are claimed one at a time from a shared counter, so uneven tasks balance over the threads. The
+    ///       workers take one batch at a time: a batch submitted while they are busy with another is run by its
+    ///       submitter alone, rather than waiting for its turn, so that concurrent submitters never queue up.
+    /// @note Tasks must not throw, since nothing would be there to catch it on a worker.
+    class ThreadPool{
+    public:
+        using size_type = std::size_t;
+
+        /// @brief Runs the task with the given number, given the context its batch was submitted with.
+        using task_function = void (*)(void* context, size_type task);
+
+        /// @param workers The number of threads started besides the ones submitting batches.
+        explicit ThreadPool(size_type workers);
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator= (const ThreadPool&) = delete;
+
+        /// @brief Stops and joins the workers. No batch may be running.
+        ~ThreadPool();
+
+        /// @brief Returns the number of worker threads.
+        size_type worker_count() const noexcept;
+
+        /// @brief Runs `task(context, i)` for every i in [0, tasks), and waits for all of them to finish. Runs them all
+        ///        on the calling thread if the workers are busy with another batch.
+        void run(size_type tasks, task_function task, void* context);
+
+        /// @brief Runs `func(i)` for every i in [0, tasks), and waits for all of them to finish.
+        template<class Function> requires std::invocable<Function&, std::size_t>
+        void for_each_task(size_type tasks, Function func);
+    private:
+        /// @brief Runs tasks of the current batch until none is left to claim.
+        void work();
+
+        /// @brief The loop of a worker: waits for a batch, works on it, and starts over until the pool stops.
+        void serve();
+
+        std::vector<std::thread> m_workers;
+        std::mutex m_submission;                    // held for the whole of the batch the workers are on
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_idle;
+        task_function m_task;
+        void* m_context;
+        size_type m_tasks;
+        std::atomic<size_type> m_next;              // the next task to claim
+        size_type m_active;                         // the workers on the current batch
+        std::uint64_t m_batch;                      // the number of batches submitted, which workers watch
+        bool m_stopping;
+    };
+
+    inline ThreadPool::ThreadPool(size_type workers)
+    {
+        m_task = nullptr;
+        m_context = nullptr;
+        m_tasks = 0;
+        m_next.store(0, std::memory_order_relaxed);
+        m_active = 0;
+        m_batch = 0;
+        m_stopping = false;
+        m_workers.reserve(workers);
+        for (size_type i = 0; i < workers; ++i){
+            m_workers.emplace_back([this](){ serve(); });
+        }
+    }
+
+    inline ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        for (std::thread& worker : m_workers){
+            worker.join();
+        }
+    }
+
+    inline ThreadPool::size_type ThreadPool::worker_count() const noexcept
+    {
+        return m_workers.size();
+    }
+
+    inline void ThreadPool::run(size_type tasks, task_function task, void* context)
+    {
+        if (tasks == 0){
+            return;
+        }
+        std::unique_lock turn(m_submission, std::try_to_lock);
+        if (!turn.owns_lock()){
+            for (size_type i = 0; i < tasks; ++i){
+                task(context, i);
+            }
+            return;
+        }
+        {
+            // a worker that woke up late for the previous batch may still be looking at it
+            std::unique_lock lock(m_mutex);
+            m_idle.wait(lock, [&](){ return m_active == 0; });
+            m_task = task;
+            m_context = context;
+            m_tasks = tasks;
+            m_next.store(0, std::memory_order_relaxed);
+            ++m_batch;
+        }
+        if (tasks > 1){
+            m_wake.notify_all();
+        }
+        work();
+        // every task is claimed by now, and the workers still running theirs are active
+        std::unique_lock lock(m_mutex);
+        m_idle.wait(lock, [&](){ return m_active == 0; });
+    }
+
+    template<class Function> requires std::invocable<Function&, std::size_t>
+    void ThreadPool::for_each_task(size_type tasks, Function func)
+    {
+        run(tasks, [](void* context, size_type task){ (*static_cast<Function*>(context))(task); }, &func);
+    }
+
+    inline void ThreadPool::work()
+    {
+        for (size_type task = m_next.fetch_add(1, std::memory_order_relaxed); task < m_tasks; task = m_next.fetch_add(1, std::memory_order_relaxed)){
+            m_task(m_context, task);
+        }
+    }
+
+    inline void ThreadPool::serve()
+    {
+        std::uint64_t seen = 0;
+        std::unique_lock lock(m_mutex);
+        for (;;){
+            m_wake.wait(lock, [&](){ return m_stopping || m_batch != seen; });
+            if (m_stopping){
+                return;
+            }
+            seen = m_batch;
+            ++m_active;
+            lock.unlock();
+            work();
+            lock.lock();
+            if (--m_active == 0){
+                m_idle.notify_all();
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,526 @@
+#ifndef VERSIONED_BPLUS_TREE_CLASS_DEFINED
+#define VERSIONED_BPLUS_TREE_CLASS_DEFINED
+
+#include "BPlusTree.hpp"
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <optional>
+
+namespace csaur{
+    /// @brief One committed version of the value of a key in a VersionedBPlusTree, linked to the version it replaced.
+    ///        A version without a value records that the key was erased.
+    template<Storable Mapped>
+    struct BPlusVersion{
+        std::uint64_t m_commit;
+        BPlusVersion* m_older;
+        std::optional<Mapped> m_value;
+
+        template<typename ... Args>
+        BPlusVersion(std::uint64_t commit, BPlusVersion* older, Args&& ... args) : m_commit(commit), m_older(older), m_value(std::forward<Args>(args)...) {}
+    };
+
+    /// @brief A tree keeping the versions of every value, so that it can be read as it was at any recent timestamp.
+    ///        Every write carries the timestamp it commits at. The leaf slot of a key holds a chain of versions, newest
+    ///        first, and a read at a timestamp takes the newest version committed at or before it.
+    /// @note Versions nobody can read anymore are released by `collect_garbage`, which keeps, for every key, the newest
+    ///       version at the horizon and the ones after it. The horizon is the timestamp of the oldest open ReadView, or
+    ///       the latest commit if none is open. Writes also release the old versions of the chain they add to, so a
+    ///       tree read by no view keeps a single version per key.
+    /// @note The tree is not synchronized: writes, reads and collection must not overlap, as in a BPlusTree.
+    ///       `collect_garbage` works in bounded steps, so a maintenance task may run it between writes.
+    /// @note The nodes, allocators and search policies are those of BPlusTree, whose mapped values are the chains.
+    template<OrderedKey Key,
+             Storable Mapped,
+             std::size_t N,
+             SingleElementAllocator VersionAlloc = DefaultAllocator<BPlusVersion<Mapped>>,
+             SingleElementAllocator LeafAlloc = DefaultAllocator<BPlusLeaf<Key, BPlusVersion<Mapped>*, N>>,
+             SingleElementAllocator InternalAlloc = DefaultAllocator<BPlusInternal<Key, BPlusVersion<Mapped>*, N>>,
+             class Search = DefaultSearch
+            >
+    class VersionedBPlusTree{
+    public:
+        using key_type = Key;
+        using mapped_type = Mapped;
+        using value_type = mapped_type;
+        using const_pointer = const value_type*;
+        using size_type = std::size_t;
+        using timestamp_type = std::uint64_t;
+        using version_type = BPlusVersion<Mapped>;
+        using version_allocator = rebind_allocator_t<VersionAlloc, version_type>;
+        using tree_type = BPlusTree<Key, version_type*, N, DefaultAllocator<version_type*>, LeafAlloc, InternalAlloc, Search>;
+
+        /// @brief A reader of the tree as it was at a timestamp. The versions it reads are not collected while it is open.
+        class ReadView{
+            friend class VersionedBPlusTree;
+        public:
+            ReadView(const ReadView&) = delete;
+            ReadView& operator= (const ReadView&) = delete;
+            ReadView(ReadView&&) noexcept;
+            ReadView& operator= (ReadView&&) noexcept;
+
+            /// @brief Closes the view, letting the versions only it could read be collected.
+            ~ReadView();
+
+            /// @brief Returns the timestamp the view reads at.
+            timestamp_type timestamp() const noexcept;
+
+            /// @brief Returns the value a key had at the timestamp of the view, or nullptr if it had none.
+            const_pointer get(const key_type&) const;
+
+            /// @brief Calls `func(key, mapped)` on every entry the tree had at the timestamp of the view whose key is in
+            ///        the range [lo, hi), in ascending key order.
+            template<class Function> requires std::invocable<Function&, const key_type&, const mapped_type&>
+            void for_each_in_range(const key_type& lo, const key_type& hi, Function func) const;
+        private:
+            /// @brief Opens a view, registering its timestamp with the tree.
+            ReadView(const VersionedBPlusTree&, timestamp_type);
+
+            const VersionedBPlusTree* m_tree;       // nullptr once moved from
+            timestamp_type m_timestamp;
+        };
+    private:
+        #ifdef DEBUGGING_B_PLUS_TREE
+            friend class ::BPlusTest;
+        #endif
+
+        /// @brief Returns the version of a chain that is visible at a timestamp, or nullptr if there is none.
+        static const version_type* visible(const version_type* head, timestamp_type read_ts);
+
+        /// @brief Returns the timestamp of the oldest version a reader may still ask for.
+        timestamp_type oldest_readable() const noexcept;
+
+        /// @brief Releases the versions of a chain older than the one visible at a timestamp, and that one too if it
+        ///        records an erasure. Sets the chain to nullptr if nothing is left of it.
+        /// @return The number of released versions.
+        size_type prune(version_type*& head, timestamp_type horizon);
+
+        /// @brief Allocates a version.
+        template<typename ... Args>
+        version_type* make_version(timestamp_type commit, version_type* older, Args&& ...);
+
+        /// @brief Releases a version, but not the ones it is linked to.
+        void release(version_type*);
+
+        /// @brief Throws std::invalid_argument if a write cannot commit at a timestamp, because it is before the latest
+        ///        commit or a view is open at it.
+        void check_commit(timestamp_type commit_ts, const char* function) const;
+
+        /// @brief Throws std::out_of_range if the versions visible at a timestamp may have been collected.
+        void check_readable(timestamp_type read_ts, const char* function) const;
+
+        tree_type m_tree;
+        size_type m_size;                           // the number of keys whose newest version holds a value
+        size_type m_versions;
+        timestamp_type m_now;                       // the timestamp of the latest commit
+        timestamp_type m_horizon;                   // reads before it may miss collected versions
+        mutable std::map<timestamp_type, size_type> m_readers;  // the number of open views at each timestamp
+        std::optional<key_type> m_sweep;            // where the next `collect_garbage` resumes, if not at the start
+        [[no_unique_address]] version_allocator m_version_alloc;
+    public:
+        /// @brief Creates an empty tree, whose latest commit is at timestamp 0.
+        VersionedBPlusTree();
+
+        VersionedBPlusTree(const VersionedBPlusTree&) = delete;
+        VersionedBPlusTree& operator= (const VersionedBPlusTree&) = delete;
+
+        /// @brief Releases every version. Every view must have been closed before.
+        ~VersionedBPlusTree();
+
+        /// @brief Returns the number of keys the tree holds as of the latest commit.
+        size_type size() const noexcept;
+
+        /// @brief Checks if the tree holds no keys as of the latest commit.
+        bool is_empty() const noexcept;
+
+        /// @brief Returns the number of versions kept, including the ones recording erasures.
+        size_type version_count() const noexcept;
+
+        /// @brief Returns the timestamp of the latest commit.
+        timestamp_type now() const noexcept;
+
+        /// @brief Returns the oldest timestamp the tree can still be read at.
+        timestamp_type horizon() const noexcept;
+
+        /// @brief Opens a view of the tree at a timestamp. Until it is closed, writes must commit after its timestamp.
+        /// @exception std::out_of_range if the timestamp is older than `horizon()`.
+        /// @exception std::invalid_argument if the timestamp is after `now()`, since later commits would change what it reads.
+        ReadView read_view(timestamp_type read_ts) const;
+
+        /// @brief Returns the value a key has as of the latest commit, or nullptr if it has none.
+        const_pointer get(const key_type&) const;
+
+        /// @brief Returns the value a key had at a timestamp, or nullptr if it had none.
+        /// @note A read outside of a view is only stable until the next write or collection, which may move the horizon past it.
+        /// @exception std::out_of_range if the timestamp is older than `horizon()`.
+        const_pointer get(const key_type&, timestamp_type read_ts) const;
+
+        /// @brief Checks if a key has a value as of the latest commit.
+        bool contains(const key_type&) const;
+
+        /// @brief Calls `func(key, mapped)` on every entry the tree had at a timestamp whose key is in the range [lo, hi),
+        ///        in ascending key order.
+        /// @exception std::out_of_range if the timestamp is older than `horizon()`.
+        template<class Function> requires std::invocable<Function&, const key_type&, const mapped_type&>
+        void for_each_in_range(const key_type& lo, const key_type& hi, timestamp_type read_ts, Function func) const;
+
+        /// @brief Commits a new value for a key at a timestamp. Writes committing at the same timestamp, such as those
+        ///        of one transaction, replace each other's values rather than adding versions.
+        /// @return Whether the key had no value before.
+        /// @exception std::invalid_argument if the timestamp is older than `now()`, or a view is open at it.
+        /// @note At failure, does not change contents.
+        bool insert_or_assign(key_type&&, mapped_type&&, timestamp_type commit_ts);
+
+        /// @brief Commits the erasure of a key at a timestamp. Views at earlier timestamps still read its old value.
+        /// @return Whether the key had a value before.
+        /// @exception std::invalid_argument if the timestamp is older than `now()`, or a view is open at it.
+        /// @note At failure, does not change contents.
+        bool erase(const key_type&, timestamp_type commit_ts);
+
+        /// @brief Releases the versions no reader can ask for anymore, from the chains of at most `max_keys` keys.
+        ///        Each call resumes after the last key the previous one went through, and starts over past the end.
+        /// @return The number of released versions.
+        size_type collect_garbage(size_type max_keys = std::numeric_limits<size_type>::max());
+    };
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                          VersionedBPlusTree ReadView                         //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::ReadView::ReadView(const VersionedBPlusTree& tree, timestamp_type read_ts)
+    {
+        ++tree.m_readers[read_ts];
+        m_tree = &tree;
+        m_timestamp = read_ts;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::ReadView::ReadView(ReadView&& other) noexcept
+    {
+        m_tree = std::exchange(other.m_tree, nullptr);
+        m_timestamp = other.m_timestamp;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::ReadView& VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::ReadView::operator= (ReadView&& other) noexcept
+    {
+        // the view this one held is closed when `other` is
+        std::swap(m_tree, other.m_tree);
+        std::swap(m_timestamp, other.m_timestamp);
+        return *this;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::ReadView::~ReadView()
+    {
+        if (m_tree != nullptr){
+            auto readers = m_tree->m_readers.find(m_timestamp);
+            if (--readers->second == 0){
+                m_tree->m_readers.erase(readers);
+            }
+        }
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::timestamp_type VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::ReadView::timestamp() const noexcept
+    {
+        return m_timestamp;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::const_pointer VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::ReadView::get(const key_type& key) const
+    {
+        return m_tree->get(key, m_timestamp);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    template <class Function> requires std::invocable<Function&, const Key&, const Mapped&>
+    void VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::ReadView::for_each_in_range(const key_type& lo, const key_type& hi, Function func) const
+    {
+        m_tree->for_each_in_range(lo, hi, m_timestamp, std::move(func));
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                         VersionedBPlusTree CTOR & DTOR                       //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::VersionedBPlusTree()
+    {
+        m_size = 0;
+        m_versions = 0;
+        m_now = 0;
+        m_horizon = 0;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::~VersionedBPlusTree()
+    {
+        for (version_type* head : m_tree){
+            while (head != nullptr){
+                release(std::exchange(head, head->m_older));
+            }
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                         VersionedBPlusTree Observers                         //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::size_type VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::size() const noexcept
+    {
+        return m_size;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    bool VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::is_empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::size_type VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::version_count() const noexcept
+    {
+        return m_versions;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::timestamp_type VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::now() const noexcept
+    {
+        return m_now;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::timestamp_type VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::horizon() const noexcept
+    {
+        return m_horizon;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::timestamp_type VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::oldest_readable() const noexcept
+    {
+        // views are never opened after the latest commit
+        return m_readers.empty() ? m_now : m_readers.begin()->first;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                           VersionedBPlusTree Reads                           //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::ReadView VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::read_view(timestamp_type read_ts) const
+    {
+        check_readable(read_ts, "read_view");
+        if (read_ts > m_now){
+            throw std::invalid_argument("VersionedBPlusTree::read_view: the timestamp is after the latest commit.\n");
+        }
+        return ReadView(*this, read_ts);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    const typename VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::version_type* VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::visible(const version_type* head, timestamp_type read_ts)
+    {
+        while (head != nullptr && head->m_commit > read_ts){
+            head = head->m_older;
+        }
+        return (head != nullptr && head->m_value.has_value()) ? head : nullptr;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::const_pointer VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::get(const key_type& key) const
+    {
+        return get(key, m_now);
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::const_pointer VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::get(const key_type& key, timestamp_type read_ts) const
+    {
+        check_readable(read_ts, "get");
+        auto entry = m_tree.find(key);
+        if (entry == m_tree.end()){
+            return nullptr;
+        }
+        const version_type* version = visible(*entry, read_ts);
+        return (version != nullptr) ? &*version->m_value : nullptr;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    bool VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::contains(const key_type& key) const
+    {
+        return get(key) != nullptr;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    template <class Function> requires std::invocable<Function&, const Key&, const Mapped&>
+    void VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::for_each_in_range(const key_type& lo, const key_type& hi, timestamp_type read_ts, Function func) const
+    {
+        check_readable(read_ts, "for_each_in_range");
+        m_tree.for_each_in_range(lo, hi, [&](const key_type& key, const version_type* head){
+            if (const version_type* version = visible(head, read_ts)){
+                func(key, *version->m_value);
+            }
+        });
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                           VersionedBPlusTree Writes                          //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    bool VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::insert_or_assign(key_type&& key, mapped_type&& mapped, timestamp_type commit_ts)
+    {
+        check_commit(commit_ts, "insert_or_assign");
+        bool had_value = false;
+        version_type* created = nullptr;
+        auto make = [&](){
+            return created = make_version(commit_ts, nullptr, std::move(mapped));
+        };
+        auto update = [&](version_type*& head){
+            had_value = head->m_value.has_value();
+            if (head->m_commit == commit_ts){
+                head->m_value = std::move(mapped);
+            }
+            else{
+                head = make_version(commit_ts, head, std::move(mapped));
+            }
+        };
+        auto [entry, inserted] = m_tree.upsert(key_type(key), make, update);
+        if (entry == m_tree.end()){
+            if (created != nullptr){
+                release(created);                   // the tree could not make room for it
+            }
+            throw std::bad_alloc();
+        }
+        m_now = commit_ts;
+        m_size += !had_value;
+        m_horizon = oldest_readable();
+        prune(*entry, m_horizon);                   // never the whole chain, since its newest version holds a value
+        return !had_value;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    bool VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::erase(const key_type& key, timestamp_type commit_ts)
+    {
+        check_commit(commit_ts, "erase");
+        auto entry = m_tree.find(key);
+        if (entry == m_tree.end() || !(*entry)->m_value.has_value()){
+            return false;
+        }
+        version_type*& head = *entry;
+        if (head->m_commit == commit_ts){
+            head->m_value.reset();
+        }
+        else{
+            head = make_version(commit_ts, head);
+        }
+        m_now = commit_ts;
+        --m_size;
+        m_horizon = oldest_readable();
+        prune(head, m_horizon);
+        if (head == nullptr){
+            m_tree.erase(key);                      // no reader can see the key anymore
+        }
+        return true;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                     VersionedBPlusTree Garbage Collection                    //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::size_type VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::prune(version_type*& head, timestamp_type horizon)
+    {
+        version_type** link = &head;
+        while (*link != nullptr && (*link)->m_commit > horizon){
+            link = &(*link)->m_older;
+        }
+        if (*link == nullptr){
+            return 0;
+        }
+        // the version visible at the horizon is the oldest anyone may read. An erasure reads the same as no version
+        version_type* stale = (*link)->m_value.has_value() ? std::exchange((*link)->m_older, nullptr) : std::exchange(*link, nullptr);
+        size_type released = 0;
+        for (; stale != nullptr; ++released){
+            release(std::exchange(stale, stale->m_older));
+        }
+        return released;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::size_type VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::collect_garbage(size_type max_keys)
+    {
+        m_horizon = oldest_readable();
+        auto entry = m_sweep ? m_tree.lower_bound(*m_sweep) : m_tree.begin();
+        std::vector<key_type> emptied;
+        size_type released = 0;
+        for (size_type swept = 0; entry != m_tree.end() && swept < max_keys; ++entry, ++swept){
+            released += prune(*entry, m_horizon);
+            if (*entry == nullptr){
+                emptied.push_back(entry.key());
+            }
+        }
+        if (entry != m_tree.end()){
+            m_sweep = entry.key();
+        }
+        else{
+            m_sweep.reset();
+        }
+        for (const key_type& key : emptied){
+            m_tree.erase(key);
+        }
+        return released;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////
+    //                          VersionedBPlusTree Helpers                          //
+    //////////////////////////////////////////////////////////////////////////////////
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    template <typename ... Args>
+    VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::version_type* VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::make_version(timestamp_type commit, version_type* older, Args&& ... args)
+    {
+        version_type* version = m_version_alloc.allocate();
+        try{
+            std::construct_at(version, commit, older, std::forward<Args>(args)...);
+        }
+        catch(...){
+            m_version_alloc.deallocate(version);
+            throw;
+        }
+        ++m_versions;
+        return version;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    void VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::release(version_type* version)
+    {
+        std::destroy_at(version);
+        m_version_alloc.deallocate(version);
+        --m_versions;
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    void VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::check_commit(timestamp_type commit_ts, const char* function) const
+    {
+        if (commit_ts < m_now){
+            throw std::invalid_argument(std::string("VersionedBPlusTree::") + function + ": the timestamp is before the latest commit.\n");
+        }
+        // views are never opened after the latest commit, so only one at it can be changed under. A write at its
+        // timestamp would replace the version it reads in place, or add a key it did not see when it was opened
+        if (!m_readers.empty() && commit_ts <= m_readers.rbegin()->first){
+            throw std::invalid_argument(std::string("VersionedBPlusTree::") + function + ": a view is open at the timestamp.\n");
+        }
+    }
+
+    template <OrderedKey Key, Storable Mapped, std::size_t N, SingleElementAllocator VersionAlloc, SingleElementAllocator LeafAlloc, SingleElementAllocator InternalAlloc, class Search>
+    void VersionedBPlusTree<Key, Mapped, N, VersionAlloc, LeafAlloc, InternalAlloc, Search>::check_readable(timestamp_type read_ts, const char* function) const
+    {
+        if (read_ts < m_horizon){
+            throw std::out_of_range(std::string("VersionedBPlusTree::") + function + ": the versions at the timestamp were collected.\n");
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,326 @@
+#include "BPlusTest.hpp"
+#include <string>
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+// sums the lengths of string values
+struct TotalLength{
+    using value_type = std::size_t;
+    static value_type identity(){ return 0; }
+    static value_type combine(value_type lower, value_type higher){ return lower + higher; }
+    static value_type lift(const std::string& mapped){ return mapped.size(); }
+};
+
+template<class Mapped, class Augment>
+using AugmentedTree = csaur::BPlusTree<int, Mapped, 3, csaur::DefaultAllocator<Mapped>, csaur::DefaultAllocator<Mapped>, csaur::DefaultAllocator<Mapped>, csaur::DefaultSearch, Augment>;
+
+// whether multi_get hands out writable pointers to the mapped values of a tree
+template<class Tree>
+concept WritesThroughLookups = requires (Tree& tree, typename Tree::mapped_type** results){
+    tree.multi_get(std::span<const typename Tree::key_type>(), std::span<typename Tree::mapped_type*>(results, 1));
+};
+
+// whether for_each_in_range hands out writable references to the mapped values of a tree
+template<class Tree>
+concept WritesThroughScans = requires (Tree& tree, void (*func)(const typename Tree::key_type&, typename Tree::mapped_type&)){
+    tree.for_each_in_range(typename Tree::key_type(), typename Tree::key_type(), func);
+};
+
+void BPlusTest::test_augmentations()
+{
+    // checks that every summary kept by an internal node matches the subtree under it
+    auto summaries_valid = [&]<class Tree>(const Tree& tree)->bool {
+        auto check = [&](auto& self, const typename Tree::node_type* node, std::size_t height, bool& valid)->typename Tree::internal_type::summary_type {
+            if (height == 0){
+                return static_cast<const typename Tree::leaf_type*>(node)->summary();
+            }
+            auto internal = static_cast<const typename Tree::internal_type*>(node);
+            for (std::size_t i = 0; i < internal->m_key_counter; ++i){
+                valid = valid && (self(self, internal->m_data[i], height - 1, valid) == internal->m_summaries[i]);
+            }
+            return internal->summary();
+        };
+        bool valid = true;
+        check(check, tree.m_root, tree.m_height, valid);
+        return valid;
+    };
+
+    tester("1. counts follow insertions and erasures", [&](){
+        AugmentedTree<int, csaur::OrderStatistics> tree;
+        constexpr int count = BPlusTest::num_inserted * 4;
+        for (int i = 0; i < count; ++i){
+            tree.insert((i * 37) % count, i);
+            _ASSERT(summaries_valid(tree));
+        }
+        for (int i = 0; i < count; i += 3){
+            tree.erase((i * 11) % count);
+            _ASSERT(summaries_valid(tree));
+        }
+        for (int i = 0; i < count; ++i){
+            tree.erase(i);
+            _ASSERT(summaries_valid(tree));
+        }
+        _ASSERT(tree.size() == 0);
+        return passed;
+    });
+
+    tester("2. rank, select and count_range", [&](){
+        AugmentedTree<std::string, csaur::OrderStatistics> tree;
+        std::vector<int> keys;
+        for (int i = 0; i < BPlusTest::num_inserted * 4; ++i){
+            tree.insert(3 * i, std::to_string(i));
+            keys.push_back(3 * i);
+        }
+        for (std::size_t k = 0; k < keys.size(); ++k){
+            auto selected = tree.select(k);
+            _ASSERT(selected.key() == keys[k]);
+            _ASSERT(tree.rank(keys[k]) == k);
+            _ASSERT(tree.rank(keys[k] + 1) == k + 1);
+        }
+        for (int lo = -2; lo < 3 * (int)keys.size() + 2; lo += 5){
+            for (int hi = lo - 2; hi < 3 * (int)keys.size() + 2; hi += 7){
+                std::size_t expected = 0;
+                for (int key : keys){
+                    expected += (lo <= key && key < hi);
+                }
+                _ASSERT(tree.count_range(lo, hi) == expected);
+            }
+        }
+        bool thrown = false;
+        try{
+            tree.select(keys.size());
+        }
+        catch(std::out_of_range&){
+            thrown = true;
+        }
+        _ASSERT(thrown);
+        return passed;
+    });
+
+    tester("3. copies keep their counts", [&](){
+        AugmentedTree<int, csaur::OrderStatistics> tree;
+        for (int i = 0; i < BPlusTest::num_inserted; ++i){
+            tree.insert(i, i);
+        }
+        auto copied = tree;
+        tree.erase_all();
+        _ASSERT(summaries_valid(copied) && summaries_valid(tree));
+        _ASSERT(copied.rank(BPlusTest::num_inserted) == (std::size_t)BPlusTest::num_inserted);
+        _ASSERT(tree.rank(BPlusTest::num_inserted) == 0);
+        return passed;
+    });
+
+    tester("4. trees without augmentation keep no summaries", [&](){
+        using plain = csaur::BPlusInternal<int, int, 8>;
+        using counted = csaur::BPlusInternal<int, int, 8, csaur::DefaultSearch, csaur::OrderStatistics>;
+        _ASSERT(!plain::keeps_summaries && counted::keeps_summaries);
+        _ASSERT(sizeof(counted) == sizeof(plain) + 8 * sizeof(std::size_t));
+        return passed;
+    });
+
+    tester("5. monoid aggregates", [&](){
+        AugmentedTree<int, csaur::MonoidAugment<csaur::Sum<long>>> sums;
+        AugmentedTree<int, csaur::MonoidAugment<csaur::Max<int>>> maxima;
+        constexpr int count = BPlusTest::num_inserted * 4;
+        std::vector<int> values(count, -1);
+        for (int i = 0; i < count; ++i){
+            int key = (i * 37) % count;
+            values[key] = (key * 13) % 29;
+            sums.insert(key, values[key]);
+            maxima.insert(key, values[key]);
+        }
+        for (int i = 0; i < count; i += 5){
+            sums.erase(i);
+            maxima.erase(i);
+            values[i] = -1;
+        }
+        _ASSERT(summaries_valid(sums) && summaries_valid(maxima));
+        for (int lo = -1; lo <= count; lo += 3){
+            for (int hi = lo; hi <= count + 1; hi += 4){
+                long sum = 0;
+                int max = std::numeric_limits<int>::lowest();
+                for (int key = std::max(lo, 0); key < std::min(hi, count); ++key){
+                    if (values[key] == -1) continue;
+                    sum += values[key];
+                    max = std::max(max, values[key]);
+                }
+                _ASSERT(sums.aggregate(lo, hi) == sum);
+                _ASSERT(maxima.aggregate(lo, hi) == max);
+            }
+        }
+        return passed;
+    });
+
+    tester("6. aggregates follow replaced values", [&](){
+        AugmentedTree<std::string, csaur::MonoidAugment<TotalLength>> tree;
+        for (int i = 0; i < BPlusTest::num_inserted; ++i){
+            tree.insert(i, std::string(i, 'x'));
+        }
+        _ASSERT(tree.aggregate(0, BPlusTest::num_inserted) == (std::size_t)(BPlusTest::num_inserted * (BPlusTest::num_inserted - 1) / 2));
+        for (int i = 0; i < BPlusTest::num_inserted; ++i){
+            tree.try_emplace(int(i), "ab");
+        }
+        _ASSERT(summaries_valid(tree));
+        _ASSERT(tree.aggregate(0, BPlusTest::num_inserted) == (std::size_t)(BPlusTest::num_inserted * 2));
+        _ASSERT(tree.aggregate(5, 9) == 8 && tree.count_range(5, 9) == 4);
+        _ASSERT(tree.aggregate(9, 5) == 0);
+        return passed;
+    });
+
+    tester("7. bulk loaded trees keep summaries", [&](){
+        std::vector<std::pair<int, int>> entries;
+        for (int i = 0; i < BPlusTest::num_inserted * 4; ++i){
+            entries.emplace_back(2 * i, i);
+        }
+        AugmentedTree<int, csaur::MonoidAugment<csaur::Sum<long>>> tree;
+        tree.bulk_load(entries.begin(), entries.end(), 0.7);
+        _ASSERT(summaries_valid(tree));
+        _ASSERT(tree.count_range(0, 20) == 10 && tree.aggregate(0, 20) == 45);
+        tree.insert(1, 1000);
+        tree.erase(4);
+        _ASSERT(summaries_valid(tree));
+        _ASSERT(tree.aggregate(0, 20) == 1043);
+        return passed;
+    });
+
+    tester("8. appends keep summaries", [&](){
+        AugmentedTree<int, csaur::MonoidAugment<csaur::Sum<long>>> tree;
+        for (int i = 0; i < BPlusTest::num_inserted * 4; ++i){
+            tree.insert(i, i);
+            _ASSERT(summaries_valid(tree));
+        }
+        tree.try_emplace(BPlusTest::num_inserted * 4 - 1, 0);
+        _ASSERT(summaries_valid(tree));
+        _ASSERT(tree.rank(BPlusTest::num_inserted) == (std::size_t)BPlusTest::num_inserted);
+        _ASSERT(tree.aggregate(0, BPlusTest::num_inserted * 4) == (long)(BPlusTest::num_inserted * 4) * (BPlusTest::num_inserted * 4 - 1) / 2 - (BPlusTest::num_inserted * 4 - 1));
+        return passed;
+    });
+
+    tester("9. batches keep summaries", [&](){
+        AugmentedTree<int, csaur::MonoidAugment<csaur::Sum<long>>> tree;
+        std::vector<std::pair<int, int>> batch;
+        long sum = 0;
+        for (int i = 0; i < BPlusTest::num_inserted * 4; ++i){
+            batch.emplace_back((i * 37) % (BPlusTest::num_inserted * 4), i);
+            sum += i;
+        }
+        tree.insert_batch(batch);
+        _ASSERT(summaries_valid(tree));
+        _ASSERT(tree.aggregate(0, BPlusTest::num_inserted * 4) == sum);
+        batch = {{0, 1000}, {3, 1000}};
+        tree.insert_batch<true>(batch);
+        _ASSERT(summaries_valid(tree));
+        _ASSERT(tree.count_range(0, 4) == 4);
+        return passed;
+    });
+
+    tester("10. range erasures keep summaries", [&](){
+        constexpr int count = BPlusTest::num_inserted * 8;
+        AugmentedTree<int, csaur::MonoidAugment<csaur::Sum<long>>> tree;
+        for (int i = 0; i < count; ++i){
+            tree.insert((i * 37) % count, 1);
+        }
+        tree.erase_range(5, count / 2);
+        _ASSERT(summaries_valid(tree));
+        tree.erase(tree.find(count / 2 + 3), tree.end());
+        _ASSERT(summaries_valid(tree));
+        _ASSERT(tree.aggregate(0, count) == 8 && tree.rank(count / 2 + 1) == 6);
+        return passed;
+    });
+
+    tester("11. predicate erasures keep summaries", [&](){
+        constexpr int count = BPlusTest::num_inserted * 8;
+        AugmentedTree<int, csaur::MonoidAugment<csaur::Sum<long>>> tree;
+        std::size_t expected = 0;
+        for (int i = 0; i < count; ++i){
+            tree.insert(i, i % 10);
+            expected += (i % 10 < 8 || i < count / 4);
+        }
+        _ASSERT(tree.erase_if([](const int& key, const int& value){ return value < 8 || key < count / 4; }) == expected);
+        _ASSERT(summaries_valid(tree));
+        _ASSERT(tree.count_range(0, count) == tree.size() && tree.aggregate(0, count) == 17 * (long)tree.size() / 2);
+        return passed;
+    });
+
+    tester("12. split and joined trees keep summaries", [&](){
+        constexpr int count = BPlusTest::num_inserted * 8;
+        AugmentedTree<int, csaur::MonoidAugment<csaur::Sum<long>>> tree;
+        for (int i = 0; i < count; ++i){
+            tree.insert((i * 37) % count, 1);
+        }
+        auto higher = tree.split(count / 3);
+        _ASSERT(summaries_valid(tree) && summaries_valid(higher));
+        _ASSERT(tree.size() == count / 3 && higher.size() == count - count / 3);
+        _ASSERT(higher.aggregate(0, count) == count - count / 3 && higher.rank(count / 2) == (std::size_t)(count / 2 - count / 3));
+        higher.join(std::move(tree));
+        _ASSERT(summaries_valid(higher) && higher.aggregate(0, count) == count && higher.rank(count / 2) == count / 2);
+        return passed;
+    });
+
+    tester("13. merged trees keep summaries", [&](){
+        constexpr int count = BPlusTest::num_inserted * 8;
+        AugmentedTree<int, csaur::MonoidAugment<csaur::Sum<long>>> base, delta;
+        for (int i = 0; i < count; ++i){
+            base.insert(2 * i, 1);
+            delta.insert(3 * i, 10);
+        }
+        base.merge_from<true>(std::move(delta));
+        _ASSERT(summaries_valid(base));
+        _ASSERT(base.count_range(0, 6 * count) == base.size() && base.aggregate(0, 6) == 22 && base.aggregate(0, 3 * count) == 10 * count + 2 * count / 3);
+        return passed;
+    });
+
+    tester("14. upserted and modified values keep summaries", [&](){
+        AugmentedTree<int, csaur::MonoidAugment<csaur::Sum<long>>> tree;
+        for (int i = 0; i < BPlusTest::num_inserted * 4; ++i){
+            tree.upsert(i % BPlusTest::num_inserted, [](){ return 1; }, [](int& value){ ++value; });
+            _ASSERT(summaries_valid(tree));
+        }
+        _ASSERT(tree.aggregate(0, BPlusTest::num_inserted) == BPlusTest::num_inserted * 4);
+        for (int i = 0; i < BPlusTest::num_inserted; i += 2){
+            tree.modify(i, [](int& value){ value *= 10; });
+        }
+        _ASSERT(summaries_valid(tree));
+        _ASSERT(tree.aggregate(0, 4) == 88);
+        return passed;
+    });
+
+    tester("15. extracted and inserted entries keep summaries", [&](){
+        constexpr int count = BPlusTest::num_inserted * 8;
+        AugmentedTree<int, csaur::MonoidAugment<csaur::Sum<long>>> hot, cold;
+        for (int i = 0; i < count; ++i){
+            hot.insert(i, i);
+        }
+        for (int i = count - 1; i >= 0; i -= 3){
+            cold.insert(hot.extract(i));
+            _ASSERT(summaries_valid(hot) && summaries_valid(cold));
+        }
+        _ASSERT(hot.aggregate(0, count) + cold.aggregate(0, count) == (long)count * (count - 1) / 2);
+        _ASSERT(cold.count_range(0, count) == (std::size_t)count / 3 && cold.rank(count - 1) == (std::size_t)count / 3 - 1);
+        return passed;
+    });
+
+    tester("16. summarized values are read-only outside of modifiers", [&](){
+        using SumTree = AugmentedTree<int, csaur::MonoidAugment<csaur::Sum<long>>>;
+        using CountTree = AugmentedTree<int, csaur::OrderStatistics>;
+        auto writable = [](int& value){ ++value; };
+        static_assert(std::is_same_v<decltype(std::declval<SumTree&>().at(0)), const int&>);
+        static_assert(std::is_same_v<decltype(*std::declval<SumTree&>().begin()), const int&>);
+        static_assert(std::is_same_v<decltype(*std::declval<SumTree&>().rbegin()), const int&>);
+        static_assert(std::is_same_v<decltype(*std::declval<SumTree&>().upsert(0, [](){ return 0; }, writable).first), const int&>);
+        static_assert(!WritesThroughLookups<SumTree> && !WritesThroughScans<SumTree>);
+        static_assert(WritesThroughLookups<CountTree> && WritesThroughScans<CountTree>);
+        static_assert(std::is_same_v<decltype(std::declval<CountTree&>().at(0)), int&>);
+        static_assert(std::is_same_v<decltype(*std::declval<CountTree&>().begin()), int&>);
+        SumTree tree;
+        for (int i = 0; i < BPlusTest::num_inserted; ++i){
+            tree.insert(i, i);
+        }
+        long total = 0;
+        tree.for_each_in_range(0, BPlusTest::num_inserted, [&](const int&, const int& value){ total += value; });
+        _ASSERT(total == tree.aggregate(0, BPlusTest::num_inserted));
+        _ASSERT(tree.at(3) == 3 && tree.find(3).key() == 3);
+        return passed;
+    });
+}
@@ -1,5 +1,8 @@
 #include "BPlusTest.hpp"
+#include <vector>
+#include <string>
 #include <random>
+#include <algorithm>
 
 const char* crd_tester_aux (std::function<int (int)>lambda){
     csaur::BPlusTree<int,int,3> tree;
@@ -272,44 +275,50 @@ void BPlusTest::test_crud(){
     });
 
     tester("10. value bad_alloc", [&](){
-        csaur::BPlusTree<int,int,3, FourMaxAllocator<int>> tree;
-        tree.insert(0,0);
-        tree.insert(1,1);
-        tree.insert(2,2);
-        tree.insert(3,3);
-        tree.insert(4,4);
+        csaur::BPlusTree<int,std::string,3, FourMaxAllocator<std::string>> tree;
+        tree.insert(0,"0");
+        tree.insert(1,"1");
+        tree.insert(2,"2");
+        tree.insert(3,"3");
+        tree.insert(4,"4");
 
         _ASSERT(tree.contains(0));
         _ASSERT(tree.contains(1));
         _ASSERT(tree.contains(2));
         _ASSERT(tree.contains(3));
         _ASSERT(!tree.contains(4));
+        _ASSERT(tree.at(3) == "3");
 
         tree.erase_all();
         return passed;
     });
 
     tester("11. node bad_alloc", [&](){
-        csaur::BPlusTree<int,int,3, csaur::DefaultAllocator<int>, FourMaxAllocator<csaur::BPlusNode<int,int,3>>> tree;
-        tree.insert(0,0);
-        tree.insert(1,1);
-        tree.insert(2,2);
-        tree.insert(3,3);
-        tree.insert(4,4);
-        tree.insert(5,5);
-        tree.insert(6,6);
-        tree.insert(7,7);
+        csaur::BPlusTree<int,int,3, csaur::DefaultAllocator<int>, FourMaxAllocator<csaur::BPlusLeaf<int,int,3>>> tree;
+        tree.set_append_fill(0.5);        // ascending insertions then split leaves in half, and the fourth leaf fills up
+        for (int i = 0; i < 10; ++i){
+            tree.insert(i,i);
+        }
 
-        _ASSERT(tree.contains(0));
-        _ASSERT(tree.contains(1));
-        _ASSERT(tree.contains(2));
-        _ASSERT(tree.contains(3));
-        _ASSERT(tree.contains(4));
-        _ASSERT(tree.contains(5));
-        _ASSERT(tree.contains(6));
-        _ASSERT(!tree.contains(7));
+        for (int i = 0; i < 9; ++i){
+            _ASSERT(tree.contains(i));
+        }
+        _ASSERT(!tree.contains(9));
+        _ASSERT(tree.size() == 9);
+
+        csaur::BPlusTree<int,int,3, csaur::DefaultAllocator<int>, csaur::DefaultAllocator<csaur::BPlusLeaf<int,int,3>>, FourMaxAllocator<csaur::BPlusInternal<int,int,3>>> internal_tree;
+        for (int i = 0; i < BPlusTest::num_inserted; ++i){
+            internal_tree.insert(i,i);
+        }
+        std::size_t found = 0;
+        for (int i = 0; i < BPlusTest::num_inserted; ++i){
+            found += internal_tree.contains(i);
+        }
+        _ASSERT(found == internal_tree.size());
+        _ASSERT(found < (std::size_t)BPlusTest::num_inserted);
 
         tree.erase_all();
+        internal_tree.erase_all();
         return passed;
     });
 
@@ -326,4 +335,490 @@ void BPlusTest::test_crud(){
         tree.erase_all();
         return passed;
     });
+
+    tester("13. inline values skip the value allocator", [&](){
+        csaur::BPlusTree<int,int,3, FourMaxAllocator<int>> tree;
+        for (int i = 0; i < BPlusTest::num_inserted; ++i){
+            tree.insert(i,i);
+        }
+        for (int i = 0; i < BPlusTest::num_inserted; ++i){
+            _ASSERT(tree.at(i) == i);
+        }
+        for (int i = 0; i < BPlusTest::num_inserted; i += 2){
+            tree.erase(i);
+        }
+        for (int i = 0; i < BPlusTest::num_inserted; ++i){
+            _ASSERT(tree.contains(i) == (i % 2 == 1));
+        }
+
+        tree.erase_all();
+        return passed;
+    });
+
+    tester("14. bulk load", [&](){
+        for (double fill_factor : {1.0, 0.75, 0.5, 0.1}){
+            for (int count : {0, 1, 3, 4, 5, BPlusTest::num_inserted, BPlusTest::num_inserted * 10 + 1}){
+                std::vector<std::pair<int, std::string>> entries;
+                for (int i = 0; i < count; ++i){
+                    entries.emplace_back(2 * i, std::to_string(i));
+                }
+                csaur::BPlusTree<int,std::string,4> tree;
+                tree.insert(-7, "replaced");
+                tree.bulk_load(entries.begin(), entries.end(), fill_factor);
+                _ASSERT(tree.size() == (std::size_t)count && !tree.contains(-7));
+                int expected = 0;
+                for (auto leaf = tree.m_min; leaf != nullptr; leaf = leaf->m_next){
+                    _ASSERT(leaf == tree.m_root || leaf->m_key_counter >= decltype(tree)::node_type::min_keys);
+                    _ASSERT(leaf->m_next != nullptr || leaf == tree.m_max);
+                    expected += leaf->m_key_counter;
+                }
+                _ASSERT(expected == count);
+                for (int i = 0; i < count; ++i){
+                    _ASSERT(tree.at(2 * i) == std::to_string(i));
+                    _ASSERT(!tree.contains(2 * i + 1));
+                }
+                for (int i = 0; i < count; ++i){
+                    tree.insert(2 * i + 1, "odd");
+                }
+                for (int i = 0; i < count; ++i){
+                    _ASSERT(tree.erase(2 * i));
+                }
+                _ASSERT(tree.size() == (std::size_t)count);
+            }
+        }
+        return passed;
+    });
+
+    tester("15. bulk load fills leaves", [&](){
+        std::vector<std::pair<int, int>> entries;
+        for (int i = 0; i < BPlusTest::num_inserted * 8; ++i){
+            entries.emplace_back(i, i);
+        }
+        csaur::BPlusTree<int,int,8> full, sparse;
+        full.bulk_load(entries.begin(), entries.end());
+        sparse.bulk_load(entries.begin(), entries.end(), 0.5);
+        for (auto leaf = full.m_min; leaf != nullptr; leaf = leaf->m_next){
+            _ASSERT(leaf->m_key_counter == 8);
+        }
+        for (auto leaf = sparse.m_min; leaf != nullptr; leaf = leaf->m_next){
+            _ASSERT(leaf->m_key_counter == 4);
+        }
+        _ASSERT(full.min_key() == 0 && full.max_key() == BPlusTest::num_inserted * 8 - 1);
+        return passed;
+    });
+
+    tester("16. bulk load rejects unsorted input", [&](){
+        std::vector<std::pair<int, int>> unsorted = {{1, 1}, {3, 3}, {2, 2}}, repeated = {{1, 1}, {1, 1}};
+        csaur::BPlusTree<int,int,3> tree;
+        tree.insert(5, 5);
+        int thrown = 0;
+        for (auto* entries : {&unsorted, &repeated}){
+            try{
+                tree.bulk_load(entries->begin(), entries->end());
+            }
+            catch(std::invalid_argument&){
+                ++thrown;
+            }
+        }
+        try{
+            tree.bulk_load(unsorted.begin(), unsorted.begin(), 0.0);
+        }
+        catch(std::invalid_argument&){
+            ++thrown;
+        }
+        _ASSERT(thrown == 3);
+        _ASSERT(tree.size() == 1 && tree.at(5) == 5);
+        return passed;
+    });
+
+    tester("17. bulk load bad_alloc", [&](){
+        std::vector<std::pair<int, std::string>> entries;
+        for (int i = 0; i < BPlusTest::num_inserted; ++i){
+            entries.emplace_back(i, std::to_string(i));
+        }
+        csaur::BPlusTree<int,std::string,3,FourMaxAllocator<std::string>> tree;
+        tree.insert(-1, "kept");
+        bool thrown = false;
+        try{
+            tree.bulk_load(entries.begin(), entries.end());
+        }
+        catch(std::bad_alloc&){
+            thrown = true;
+        }
+        _ASSERT(thrown);
+        _ASSERT(tree.size() == 1 && tree.at(-1) == "kept");
+        entries.resize(3);
+        tree.bulk_load(entries.begin(), entries.end());
+        _ASSERT(tree.size() == 3 && tree.at(2) == "2" && !tree.contains(-1));
+        return passed;
+    });
+
+    tester("18. multi_get", [&](){
+        csaur::BPlusTree<int,std::string,3> tree;
+        for (int i = 0; i < BPlusTest::num_inserted * 4; i += 2){
+            tree.insert(i, std::to_string(i));
+        }
+        std::vector<int> keys;
+        for (int i = 0; i < BPlusTest::num_inserted * 4 + 3; ++i){
+            keys.push_back((i * 37) % (BPlusTest::num_inserted * 4 + 3) - 1);
+        }
+        std::vector<std::string*> results(keys.size());
+        _ASSERT(tree.multi_get(keys, results) == (std::size_t)BPlusTest::num_inserted * 2);
+        for (std::size_t i = 0; i < keys.size(); ++i){
+            bool present = keys[i] >= 0 && keys[i] < BPlusTest::num_inserted * 4 && keys[i] % 2 == 0;
+            _ASSERT(present ? (results[i] != nullptr && *results[i] == std::to_string(keys[i])) : results[i] == nullptr);
+        }
+        const auto& const_tree = tree;
+        std::vector<const std::string*> const_results(keys.size());
+        _ASSERT(const_tree.multi_get(std::span(keys).first(5), const_results) == tree.multi_get(std::span(keys).first(5), results));
+        _ASSERT(std::equal(const_results.begin(), const_results.begin() + 5, results.begin()));
+        bool thrown = false;
+        try{
+            tree.multi_get(keys, std::span(results).first(keys.size() - 1));
+        }
+        catch(std::invalid_argument&){
+            thrown = true;
+        }
+        _ASSERT(thrown);
+        csaur::BPlusTree<int,std::string,3> empty;
+        _ASSERT(empty.multi_get(keys, results) == 0 && results[0] == nullptr);
+        return passed;
+    });
+
+    tester("19. appends fill nodes", [&](){
+        for (double fill_factor : {1.0, 0.75, 0.5}){
+            csaur::BPlusTree<int,int,4> tree;
+            tree.set_append_fill(fill_factor);
+            for (int i = 0; i < BPlusTest::num_inserted * 4; ++i){
+                tree.insert(i, i);
+            }
+            std::size_t expected = (fill_factor == 1.0) ? 4 : (fill_factor == 0.75) ? 3 : 2;
+            int key = 0;
+            for (auto leaf = tree.m_min; leaf != nullptr; leaf = leaf->m_next){
+                _ASSERT(leaf == tree.m_max || leaf->m_key_counter == expected);
+                for (std::size_t i = 0; i < leaf->m_key_counter; ++i){
+                    _ASSERT(leaf->m_keys[i] == key++);
+                }
+            }
+            _ASSERT(key == BPlusTest::num_inserted * 4);
+            for (int i = 0; i < BPlusTest::num_inserted * 4; i += 3){
+                _ASSERT(tree.erase(i));
+            }
+            for (int i = 0; i < BPlusTest::num_inserted * 4; ++i){
+                _ASSERT(tree.contains(i) == (i % 3 != 0));
+            }
+        }
+        csaur::BPlusTree<int,int,4> tree;
+        bool thrown = false;
+        try{
+            tree.set_append_fill(0.4);
+        }
+        catch(std::invalid_argument&){
+            thrown = true;
+        }
+        _ASSERT(thrown && tree.append_fill() == 1.0);
+        return passed;
+    });
+
+    tester("20. hinted insertion and lookup", [&](){
+        csaur::BPlusTree<int,std::string,4> tree;
+        for (int i = 0; i < BPlusTest::num_inserted * 4; i += 4){
+            tree.insert(i, std::to_string(i));
+        }
+        auto hint = tree.cbegin();
+        for (int i = 1; i < BPlusTest::num_inserted * 4; i += 2){
+            auto inserted = tree.emplace_hint(hint, int(i), std::to_string(i));
+            _ASSERT(inserted != tree.end() && inserted.key() == i && *inserted == std::to_string(i));
+            hint = inserted;
+        }
+        auto existing = tree.emplace_hint(tree.cbegin(), 8, "replaced");
+        _ASSERT(existing.key() == 8 && *existing == "8");
+        _ASSERT(tree.emplace_hint(tree.cend(), -5, "-5").key() == -5 && tree.min_key() == -5);
+        _ASSERT(tree.size() == (std::size_t)BPlusTest::num_inserted * 3 + 1);
+        int previous = -6;
+        for (auto it = tree.begin(); it != tree.end(); ++it){
+            _ASSERT(previous < it.key() && *it == std::to_string(it.key()));
+            previous = it.key();
+        }
+        for (int i = 0; i < BPlusTest::num_inserted * 4; i += 3){
+            tree.erase(i);
+        }
+        hint = tree.cbegin();
+        for (int i = -6; i < BPlusTest::num_inserted * 4 + 2; ++i){
+            bool present = (i == -5) || (i >= 0 && i < BPlusTest::num_inserted * 4 && i % 3 != 0 && (i % 2 == 1 || i % 4 == 0));
+            auto found = tree.find_from(hint, i);
+            _ASSERT(present ? (found != tree.end() && found.key() == i) : found == tree.end());
+            _ASSERT(tree.find_from(tree.cend(), i) == found);
+            if (present){
+                hint = found;
+            }
+        }
+        return passed;
+    });
+
+    tester("21. batch insertion", [&](){
+        csaur::BPlusTree<int,std::string,4> tree;
+        for (int i = 0; i < BPlusTest::num_inserted * 4; i += 3){
+            tree.insert(i, "old");
+        }
+        std::vector<std::pair<int, std::string>> batch;
+        for (int i = BPlusTest::num_inserted * 8 - 1; i >= 0; --i){
+            batch.emplace_back(i / 2, std::to_string(i));
+        }
+        std::size_t before = tree.size();
+        std::size_t added = tree.insert_batch(batch);
+        _ASSERT(added == (std::size_t)BPlusTest::num_inserted * 4 - before);
+        _ASSERT(tree.size() == before + added);
+        int expected = 0;
+        for (auto it = tree.begin(); it != tree.end(); ++it, ++expected){
+            _ASSERT(it.key() == expected);
+            _ASSERT(*it == ((expected % 3 == 0) ? "old" : std::to_string(2 * expected + 1)));
+        }
+        _ASSERT(expected == BPlusTest::num_inserted * 4);
+
+        std::vector<std::pair<int, std::string>> replacements = {{5, "a"}, {-10, "b"}, {5, "c"}, {BPlusTest::num_inserted * 9, "d"}};
+        _ASSERT(tree.insert_batch<true>(replacements) == 2);
+        _ASSERT(tree.at(5) == "c" && tree.at(-10) == "b" && tree.at(BPlusTest::num_inserted * 9) == "d");
+        _ASSERT(tree.min_key() == -10 && tree.find(-10) == tree.begin());
+        _ASSERT(tree.insert_batch({}) == 0);
+        return passed;
+    });
+
+    tester("22. range erasure", [&](){
+        constexpr int count = BPlusTest::num_inserted * 8;
+        for (auto [lo, hi] : {std::pair{10, 20}, {0, 1}, {3, count - 3}, {-5, count / 2}, {count / 2, count + 5}, {count / 3, count / 3}, {7, 5}}){
+            csaur::BPlusTree<int,std::string,3> tree;
+            for (int i = 0; i < count; ++i){
+                tree.insert(i, std::to_string(i));
+            }
+            std::size_t expected = std::max(0, std::min(hi, count) - std::max(lo, 0));
+            _ASSERT(tree.erase_range(lo, hi) == expected);
+            _ASSERT(tree.size() == count - expected);
+            auto it = tree.begin();
+            for (int key = 0; key < count; ++key){
+                if (key < lo || key >= hi){
+                    _ASSERT(it != tree.end() && it.key() == key && *it == std::to_string(key));
+                    ++it;
+                }
+            }
+            _ASSERT(it == tree.end());
+            for (auto leaf = tree.m_min; leaf != nullptr; leaf = leaf->m_next){
+                _ASSERT(leaf == tree.m_max || leaf->m_key_counter >= decltype(tree)::node_type::min_keys);
+            }
+            for (int i = -1; i <= count; ++i){
+                _ASSERT(tree.contains(i) == (i >= 0 && i < count && (i < lo || i >= hi)));
+            }
+            tree.try_emplace(int(lo), "back");
+            _ASSERT(tree.at(lo) == "back");
+        }
+        csaur::BPlusTree<int,int,4> tree;
+        for (int i = 0; i < count; ++i){
+            tree.insert(i, i);
+        }
+        auto after = tree.erase(tree.find(5), tree.find(count - 5));
+        _ASSERT(after.key() == count - 5 && tree.size() == 10);
+        after = tree.erase(tree.begin(), tree.begin());
+        _ASSERT(after == tree.begin());
+        after = tree.erase(tree.begin(), tree.end());
+        _ASSERT(after == tree.end() && tree.is_empty());
+        return passed;
+    });
+
+    tester("23. predicate erasure", [&](){
+        constexpr int count = BPlusTest::num_inserted * 8;
+        for (int modulus : {2, 3, 7, count}){
+            csaur::BPlusTree<int,std::string,3> tree;
+            for (int i = 0; i < count; ++i){
+                tree.insert((i * 37) % count, std::to_string((i * 37) % count));
+            }
+            std::size_t expected = (count + modulus - 1) / modulus;
+            _ASSERT(tree.erase_if([&](const int& key, const std::string& value){ return key % modulus == 0 && value == std::to_string(key); }) == expected);
+            _ASSERT(tree.size() == count - expected);
+            auto it = tree.begin();
+            for (int key = 0; key < count; ++key){
+                _ASSERT(tree.contains(key) == (key % modulus != 0));
+                if (key % modulus != 0){
+                    _ASSERT(it != tree.end() && it.key() == key && *it == std::to_string(key));
+                    ++it;
+                }
+            }
+            _ASSERT(it == tree.end());
+            for (auto leaf = tree.m_min; leaf != nullptr; leaf = leaf->m_next){
+                _ASSERT(leaf == tree.m_root || leaf->m_key_counter >= decltype(tree)::node_type::min_keys);
+            }
+            for (int key = 0; key < count; key += modulus){
+                tree.insert(key, "back");
+            }
+            _ASSERT(tree.size() == (std::size_t)count && tree.at(0) == "back");
+        }
+        csaur::BPlusTree<int,int,4> tree;
+        for (int i = 0; i < count; ++i){
+            tree.insert(i, i);
+        }
+        _ASSERT(tree.erase_if([](const int&, const int&){ return false; }) == 0 && tree.size() == (std::size_t)count);
+        int calls = 0;
+        bool thrown = false;
+        try{
+            tree.erase_if([&](const int& key, const int&){
+                if (++calls == count / 2){
+                    throw std::runtime_error("stop");
+                }
+                return key % 2 == 0;
+            });
+        }
+        catch(std::runtime_error&){
+            thrown = true;
+        }
+        _ASSERT(thrown && tree.size() == (std::size_t)(count - count / 4));
+        _ASSERT(!tree.contains(0) && tree.contains(count / 2 - 1) && tree.contains(count / 2) && tree.contains(count - 2));
+        std::size_t left = tree.size();
+        _ASSERT(tree.erase_if([](const int&, const int&){ return true; }) == left && tree.is_empty());
+        return passed;
+    });
+
+    tester("24. split and join", [&](){
+        constexpr int count = BPlusTest::num_inserted * 8;
+        // checks that a tree holds the keys [lo, hi) in order, with every leaf but the last at least half full
+        auto holds = [&]<class Tree>(const Tree& tree, int lo, int hi)->bool {
+            bool valid = tree.size() == (std::size_t)std::max(0, hi - lo);
+            auto it = tree.begin();
+            for (int key = lo; key < hi && valid; ++key, ++it){
+                valid = it != tree.end() && it.key() == key && tree.contains(key);
+            }
+            for (auto leaf = tree.m_min; leaf != nullptr && valid; leaf = leaf->m_next){
+                valid = leaf == tree.m_max || leaf->m_key_counter >= Tree::node_type::min_keys;
+            }
+            return valid && it == tree.end() && !tree.contains(lo - 1) && !tree.contains(hi);
+        };
+        for (int at : {-3, 0, 1, count / 3, count / 2 + 1, count - 1, count, count + 4}){
+            csaur::BPlusTree<int,std::string,3> tree;
+            for (int i = 0; i < count; ++i){
+                tree.insert((i * 37) % count, std::to_string((i * 37) % count));
+            }
+            auto higher = tree.split(at);
+            int cut = std::clamp(at, 0, count);
+            _ASSERT(holds(tree, 0, cut) && holds(higher, cut, count));
+            tree.insert(-1, "lower");
+            higher.insert(count, "higher");
+            _ASSERT(tree.at(-1) == "lower" && higher.at(count) == "higher");
+            tree.join(std::move(higher));
+            _ASSERT(higher.is_empty() && holds(tree, -1, count + 1));
+        }
+        csaur::BPlusTree<int,int,4> tall, low, high;
+        for (int i = 0; i < count; ++i){
+            tall.insert(i + 10, i + 10);
+        }
+        for (int i = 0; i < 10; ++i){
+            low.insert(i, i);
+            high.insert(count + 10 + i, 0);
+        }
+        tall.join(std::move(high));
+        low.join(std::move(tall));
+        _ASSERT(tall.is_empty() && holds(low, 0, count + 20));
+        tall.insert(5, 5);
+        bool thrown = false;
+        try{
+            low.join(std::move(tall));
+        }
+        catch(std::invalid_argument&){
+            thrown = true;
+        }
+        _ASSERT(thrown && tall.size() == 1 && low.size() == (std::size_t)count + 20);
+        return passed;
+    });
+
+    tester("25. merging overlapping trees", [&](){
+        constexpr int count = BPlusTest::num_inserted * 8;
+        for (bool replace : {false, true}){
+            csaur::BPlusTree<int,std::string,3> base, delta;
+            for (int i = 0; i < count; i += 2){
+                base.insert(i, "base");
+            }
+            for (int i = count / 2; i < count + count / 2; i += 3){
+                delta.insert(i, "delta");
+            }
+            std::size_t base_size = base.size(), delta_size = delta.size(), shared = 0;
+            for (int i = count / 2; i < count; i += 6){
+                ++shared;
+            }
+            std::size_t added = replace ? base.merge_from<true>(std::move(delta)) : base.merge_from(std::move(delta));
+            _ASSERT(added == delta_size - shared && base.size() == base_size + added && delta.is_empty());
+            auto it = base.begin();
+            for (int key = 0; key < count + count / 2; ++key){
+                bool in_base = key % 2 == 0 && key < count, in_delta = key >= count / 2 && (key - count / 2) % 3 == 0;
+                _ASSERT(base.contains(key) == (in_base || in_delta));
+                if (in_base || in_delta){
+                    _ASSERT(it != base.end() && it.key() == key);
+                    _ASSERT(*it == ((in_delta && (replace || !in_base)) ? "delta" : "base"));
+                    ++it;
+                }
+            }
+            _ASSERT(it == base.end());
+            for (auto leaf = base.m_min; leaf != base.m_max; leaf = leaf->m_next){
+                _ASSERT(leaf->m_key_counter >= 2);
+            }
+            base.insert(-1, "new");
+            base.erase(0);
+            _ASSERT(base.at(-1) == "new" && !base.contains(0));
+            delta.insert(1, "delta");
+            _ASSERT(base.merge_from(std::move(delta)) == 1 && base.at(1) == "delta");
+        }
+        return passed;
+    });
+
+    tester("26. upsert and modify", [&](){
+        constexpr int count = BPlusTest::num_inserted * 8;
+        csaur::BPlusTree<int,std::string,3> tree;
+        int made = 0;
+        for (int round = 0; round < 3; ++round){
+            for (int i = 0; i < count; ++i){
+                auto [it, inserted] = tree.upsert((i * 37) % count, [&](){ ++made; return std::string("a"); }, [](std::string& value){ value += "b"; });
+                _ASSERT(it != tree.end() && it.key() == (i * 37) % count && inserted == (round == 0));
+            }
+        }
+        _ASSERT(made == count && tree.size() == (std::size_t)count && tree.at(5) == "abb");
+        for (int i = -1; i <= count; ++i){
+            _ASSERT(tree.modify(i, [](std::string& value){ value.pop_back(); }) == (i >= 0 && i < count));
+        }
+        _ASSERT(tree.at(0) == "ab" && tree.at(count - 1) == "ab");
+        bool thrown = false;
+        try{
+            tree.modify(7, [](std::string& value){ value = "c"; throw std::runtime_error("stop"); });
+        }
+        catch(std::runtime_error&){
+            thrown = true;
+        }
+        _ASSERT(thrown && tree.at(7) == "c" && tree.size() == (std::size_t)count);
+        return passed;
+    });
+
+    tester("27. extracted entries move between trees", [&](){
+        constexpr int count = BPlusTest::num_inserted * 8;
+        csaur::BPlusTree<int,std::string,3> hot, cold;
+        for (int i = 0; i < count; ++i){
+            hot.insert(i, std::to_string(i));
+        }
+        _ASSERT(hot.extract(count).empty() && hot.size() == (std::size_t)count);
+        for (int i = 0; i < count; i += 2){
+            const std::string* address = &hot.at(i);
+            auto handle = hot.extract(i);
+            _ASSERT(!handle.empty() && handle.key() == i && &handle.mapped() == address);
+            auto [it, inserted] = cold.insert(std::move(handle));
+            _ASSERT(inserted && handle.empty() && it.key() == i && &*it == address);
+        }
+        _ASSERT(hot.size() == (std::size_t)count / 2 && cold.size() == (std::size_t)count / 2);
+        for (int i = 0; i < count; ++i){
+            _ASSERT(hot.contains(i) == (i % 2 == 1) && cold.contains(i) == (i % 2 == 0));
+            _ASSERT((i % 2 ? hot : cold).at(i) == std::to_string(i));
+        }
+        auto handle = cold.extract(0);
+        handle.key() = 2;
+        auto [it, inserted] = cold.insert(std::move(handle));
+        _ASSERT(!inserted && it.key() == 2 && *it == "2" && handle && handle.mapped() == "0");
+        handle.key() = -1;
+        _ASSERT(cold.insert(std::move(handle)).second && cold.at(-1) == "0" && cold.begin().key() == -1);
+        _ASSERT(!cold.insert(decltype(cold)::entry_handle()).second);
+        handle = hot.extract(1);                                          // dropped while holding its entry
+        return passed;
+    });
 }
@@ -0,0 +1,199 @@
+#include "BPlusTest.hpp"
+#include <atomic>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+void BPlusTest::test_concurrency()
+{
+    // checks that keys are sorted in every node, that every key lies between the separators above it, and that
+    // every node but the root holds at least min_fill entries
+    auto structure_valid = [&]<class Tree>(const Tree& tree)->bool {
+        std::size_t entries = 0;
+        auto check = [&](auto& self, const typename Tree::node_type* node, std::size_t height, const int* lo, const int* hi, bool is_root)->bool {
+            if ((!is_root && node->m_key_counter < Tree::min_fill) || !std::is_sorted(node->m_keys.begin(), node->m_keys.begin() + node->m_key_counter)){
+                return false;
+            }
+            if (height == 0){
+                entries += node->m_key_counter;
+                for (std::size_t i = 0; i < node->m_key_counter; ++i){
+                    if ((lo && node->m_keys[i] < *lo) || (hi && !(node->m_keys[i] < *hi))){
+                        return false;
+                    }
+                }
+                return true;
+            }
+            auto internal = static_cast<const typename Tree::internal_type*>(node);
+            for (std::size_t i = 0; i < internal->m_key_counter; ++i){
+                const int* sub_lo = (i == 0) ? lo : &internal->m_keys[i];
+                const int* sub_hi = (i + 1 == internal->m_key_counter) ? hi : &internal->m_keys[i + 1];
+                if (!self(self, internal->m_data[i], height - 1, sub_lo, sub_hi, false)){
+                    return false;
+                }
+            }
+            return true;
+        };
+        return check(check, tree.m_root, tree.m_height, nullptr, nullptr, true) && entries == tree.size();
+    };
+
+    tester("1. a single thread sees the tree as a map", [&](){
+        csaur::ConcurrentBPlusTree<int,std::string,5> tree;
+        std::map<int,std::string> model;
+        _ASSERT(matches_model({
+            .insert = [&](int key, std::size_t step){ return tree.insert(int(key), std::to_string(step)); },
+            .assign = [&](int key, std::size_t step){ return tree.insert_or_assign(int(key), std::to_string(step)); },
+            .erase = [&](int key, std::size_t){ return tree.erase(key); },
+            .get = [&](int key){ return tree.get(key); },
+            .size = [&](){ return tree.size(); }
+        }, model, 24, 20000, 300));
+        _ASSERT(structure_valid(tree));
+        for (int key = 0; key < 300; ++key){
+            _ASSERT(tree.contains(key) == model.contains(key));
+            tree.erase(key);
+        }
+        _ASSERT(tree.is_empty() && tree.m_height == 0 && !tree.get(0));
+        return passed;
+    });
+
+    tester("2. readers see every entry once its insert returned", [&](){
+        constexpr int writers = 4, per_writer = 20000;
+        csaur::ConcurrentBPlusTree<int,int,8> tree;
+        std::atomic<int> published[writers] = {};
+        std::atomic<bool> done = false, valid = true;
+        std::vector<std::thread> threads;
+        for (int w = 0; w < writers; ++w){
+            threads.emplace_back([&, w](){
+                for (int i = 0; i < per_writer; ++i){
+                    valid = valid && tree.insert(i * writers + w, i * writers + w);
+                    published[w].store(i + 1, std::memory_order_release);
+                }
+            });
+        }
+        for (int r = 0; r < 2; ++r){
+            threads.emplace_back([&, r](){
+                std::mt19937 random(r);
+                while (!done.load(std::memory_order_acquire)){
+                    int w = random() % writers;
+                    int count = published[w].load(std::memory_order_acquire);
+                    if (count != 0){
+                        int key = (random() % count) * writers + w;
+                        valid = valid && tree.get(key) == key;
+                    }
+                    valid = valid && !tree.contains(-1 - (int)(random() % 100));
+                }
+            });
+        }
+        for (int w = 0; w < writers; ++w){
+            threads[w].join();
+        }
+        done = true;
+        for (std::size_t t = writers; t < threads.size(); ++t){
+            threads[t].join();
+        }
+        _ASSERT(valid && tree.size() == (std::size_t)writers * per_writer && structure_valid(tree));
+        for (int key = 0; key < writers * per_writer; ++key){
+            _ASSERT(tree.get(key) == key);
+        }
+        return passed;
+    });
+
+    tester("3. concurrent inserts, assigns and erases keep the structure", [&](){
+        constexpr int threads_count = 4, keys = 400;
+        csaur::ConcurrentBPlusTree<int,std::string,5> tree;
+        std::vector<std::map<int,std::string>> models(threads_count);     // each thread owns the keys equal to it modulo threads_count
+        std::atomic<bool> valid = true;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threads_count; ++t){
+            threads.emplace_back([&, t](){
+                std::mt19937 random(t);
+                auto& model = models[t];
+                for (int i = 0; i < 40000; ++i){
+                    int key = (int)(random() % (keys / threads_count)) * threads_count + t;
+                    switch (random() % 4){
+                        case 0:
+                            valid = valid && tree.insert(int(key), std::to_string(i)) == model.emplace(key, std::to_string(i)).second;
+                            break;
+                        case 1:
+                            valid = valid && tree.insert_or_assign(int(key), std::to_string(i)) == !model.contains(key);
+                            model[key] = std::to_string(i);
+                            break;
+                        case 2:
+                            valid = valid && tree.erase(key) == (model.erase(key) == 1);
+                            break;
+                        default:
+                            valid = valid && tree.get(key) == (model.contains(key) ? std::optional<std::string>(model[key]) : std::nullopt);
+                            tree.get((int)(random() % keys));       // a key other threads change
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads){
+            thread.join();
+        }
+        std::size_t size = 0;
+        for (auto& model : models){
+            size += model.size();
+            for (auto& [key, mapped] : model){
+                _ASSERT(tree.get(key) == mapped);
+            }
+        }
+        _ASSERT(valid && tree.size() == size && structure_valid(tree));
+        return passed;
+    });
+
+    tester("4. unlinked nodes and values are released while the tree is in use", [&](){
+        constexpr int threads_count = 4, rounds = 20000;
+        csaur::ConcurrentBPlusTree<int,std::string,5> tree;
+        std::vector<std::thread> threads;
+        std::atomic<std::size_t> most_pending = 0;
+        for (int t = 0; t < threads_count; ++t){
+            threads.emplace_back([&, t](){
+                for (int i = 0; i < rounds; ++i){
+                    int key = (i % 500) * threads_count + t;
+                    tree.insert_or_assign(int(key), std::string(40, 'a' + i % 26));     // retires the value it replaces
+                    if (i % 3 == 0){
+                        tree.erase(key);
+                    }
+                    std::size_t pending = tree.pending_retired_bytes();
+                    for (std::size_t most = most_pending; pending > most && !most_pending.compare_exchange_weak(most, pending); ){
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads){
+            thread.join();
+        }
+        // every thread waits for its garbage to expire once it holds 4096 retired objects, nodes being the largest
+        std::size_t bound = threads_count * 4096 * std::max(sizeof(typename decltype(tree)::leaf_type), sizeof(typename decltype(tree)::internal_type));
+        _ASSERT(tree.released_bytes() > (std::size_t)threads_count * rounds * sizeof(std::string) / 2 && most_pending <= bound);
+        _ASSERT(structure_valid(tree));
+        return passed;
+    });
+
+    tester("5. exited threads leave the reclaimer and their garbage is released by the others", [&](){
+        constexpr int generations = 40, rounds = 2000;
+        csaur::ConcurrentBPlusTree<int,std::string,5> tree;
+        for (int g = 0; g < generations; ++g){
+            std::thread([&, g](){
+                for (int i = 0; i < rounds; ++i){
+                    tree.insert_or_assign(i % 300, std::string(40, 'a' + g % 26));    // retires the value it replaces
+                }
+            }).join();
+            _ASSERT(tree.m_reclaimer.m_participants.size() <= 1);
+        }
+        for (int i = 0; i < rounds; ++i){
+            tree.insert_or_assign(i % 300, std::string(40, 'z'));
+        }
+        _ASSERT(tree.m_reclaimer.m_orphan_count == 0 && tree.m_reclaimer.m_orphans.empty());
+        _ASSERT(tree.m_reclaimer.pending_count() < 4096);
+        for (int t = 0; t < generations; ++t){   // a thread registers with trees that come and go
+            csaur::ConcurrentBPlusTree<int,int,5> other;
+            other.insert(int(t), int(t));
+            _ASSERT(csaur::EpochReclaimer::thread_record().m_registrations.size() <= 2);
+        }
+        _ASSERT(structure_valid(tree) && tree.size() == 300);
+        return passed;
+    });
+}
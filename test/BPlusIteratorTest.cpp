@@ -0,0 +1,139 @@
+#include "BPlusTest.hpp"
+#include <string>
+#include <vector>
+
+void BPlusTest::test_iterators()
+{
+    static_assert(std::bidirectional_iterator<csaur::BPlusTree<int,int,3>::iterator>);
+    static_assert(std::bidirectional_iterator<csaur::BPlusTree<int,std::string,3>::const_iterator>);
+
+    tester("1. empty tree", [&](){
+        csaur::BPlusTree<int,int,3> tree;
+        _ASSERT(tree.begin() == tree.end());
+        _ASSERT(tree.rbegin() == tree.rend());
+        _ASSERT(tree.find(0) == tree.end());
+        _ASSERT(tree.lower_bound(0) == tree.end());
+        tree.insert(0, 0);
+        tree.erase(0);
+        _ASSERT(tree.cbegin() == tree.cend());
+        return passed;
+    });
+
+    tester("2. forward and reverse iteration", [&](){
+        csaur::BPlusTree<int,std::string,3> tree;
+        for (int i = BPlusTest::num_inserted - 1; i >= 0; --i){
+            tree.insert(i, std::to_string(i));
+        }
+        int expected = 0;
+        for (auto it = tree.begin(); it != tree.end(); ++it){
+            _ASSERT(it.key() == expected && *it == std::to_string(expected));
+            ++expected;
+        }
+        _ASSERT(expected == BPlusTest::num_inserted);
+        for (auto it = tree.rbegin(); it != tree.rend(); ++it){
+            --expected;
+            _ASSERT(it.key() == expected && *it == std::to_string(expected));
+        }
+        _ASSERT(expected == 0);
+        decltype(tree)::const_reverse_iterator reversed = tree.rbegin();
+        _ASSERT(reversed == tree.crbegin() && reversed.key() == BPlusTest::num_inserted - 1);
+        _ASSERT((++reversed).key() == BPlusTest::num_inserted - 2 && reversed.base().key() == BPlusTest::num_inserted - 1);
+        auto last = tree.end();
+        --last;
+        _ASSERT(last.key() == BPlusTest::num_inserted - 1);
+        for (auto& value : tree){
+            value += "!";
+        }
+        const auto& const_tree = tree;
+        for (auto it = const_tree.begin(); it != const_tree.end(); ++it){
+            _ASSERT(*it == std::to_string(it.key()) + "!");
+        }
+        return passed;
+    });
+
+    tester("3. lower_bound and upper_bound", [&](){
+        csaur::BPlusTree<int,int,3> tree;
+        for (int i = 0; i < BPlusTest::num_inserted; ++i){
+            tree.insert(2 * i, i);
+        }
+        for (int key = -1; key <= 2 * BPlusTest::num_inserted; ++key){
+            int lower = (key < 0) ? 0 : (key + 1) / 2, upper = (key < 0) ? 0 : key / 2 + 1;
+            auto lower_it = tree.lower_bound(key), upper_it = tree.upper_bound(key);
+            if (lower == BPlusTest::num_inserted){
+                _ASSERT(lower_it == tree.end());
+            }
+            else{
+                _ASSERT(lower_it != tree.end() && lower_it.key() == 2 * lower);
+            }
+            if (upper >= BPlusTest::num_inserted){
+                _ASSERT(upper_it == tree.end());
+            }
+            else{
+                _ASSERT(upper_it != tree.end() && upper_it.key() == 2 * upper);
+            }
+        }
+        return passed;
+    });
+
+    tester("4. half open range scan", [&](){
+        csaur::BPlusTree<int,int,4> tree;
+        for (int i = 0; i < BPlusTest::num_inserted * 4; ++i){
+            tree.insert(i, i * 10);
+        }
+        std::vector<int> scanned;
+        for (auto it = tree.lower_bound(17), last = tree.lower_bound(61); it != last; ++it){
+            scanned.push_back(*it);
+        }
+        _ASSERT(scanned.size() == 44);
+        for (std::size_t i = 0; i < scanned.size(); ++i){
+            _ASSERT(scanned[i] == (17 + (int)i) * 10);
+        }
+        return passed;
+    });
+
+    tester("5. find and equal_range", [&](){
+        csaur::BPlusTree<int,int,3> tree;
+        for (int i = 0; i < BPlusTest::num_inserted; i += 2){
+            tree.insert(i, i);
+        }
+        for (int i = 0; i < BPlusTest::num_inserted; ++i){
+            auto found = tree.find(i);
+            auto [first, last] = tree.equal_range(i);
+            if (i % 2 == 0){
+                _ASSERT(found != tree.end() && found.key() == i && *found == i);
+                _ASSERT(first == found && std::next(first) == last);
+            }
+            else{
+                _ASSERT(found == tree.end());
+                _ASSERT(first == last);
+            }
+        }
+        return passed;
+    });
+
+    tester("6. for_each_in_range", [&](){
+        csaur::BPlusTree<int,std::string,3> tree;
+        for (int i = 0; i < BPlusTest::num_inserted * 4; i += 2){
+            tree.insert(i, std::to_string(i));
+        }
+        for (bool prefetch : {true, false}){
+            std::vector<int> visited;
+            auto visit = [&](const int& key, std::string& value){
+                visited.push_back(value == std::to_string(key) ? key : -1);
+            };
+            if (prefetch) tree.for_each_in_range(7, 61, visit);
+            else tree.for_each_in_range<false>(7, 61, visit);
+            _ASSERT(visited.size() == 27);
+            for (std::size_t i = 0; i < visited.size(); ++i){
+                _ASSERT(visited[i] == 8 + 2 * (int)i);
+            }
+        }
+        int visited = 0;
+        const auto& const_tree = tree;
+        const_tree.for_each_in_range(-5, 1000, [&](const int&, const std::string&){++visited;});
+        _ASSERT(visited == BPlusTest::num_inserted * 2);
+        tree.for_each_in_range(61, 7, [&](const int&, std::string&){++visited;});
+        _ASSERT(visited == BPlusTest::num_inserted * 2);
+        return passed;
+    });
+}
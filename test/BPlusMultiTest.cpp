@@ -0,0 +1,110 @@
+#include "BPlusTest.hpp"
+#include <string>
+#include <vector>
+
+void BPlusTest::test_multimap()
+{
+    // checks that keys never decrease along the leaves and that every separator is the smallest key under it
+    auto structure_valid = [&]<class Multi>(const Multi& multi)->bool {
+        using Tree = typename Multi::tree_type;
+        auto check = [&](auto& self, const typename Tree::node_type* node, std::size_t height)->bool {
+            if (height == 0){
+                return true;
+            }
+            auto internal = static_cast<const typename Tree::internal_type*>(node);
+            for (std::size_t i = 0; i < internal->m_key_counter; ++i){
+                const typename Tree::node_type* child = internal->m_data[i];
+                if (child->m_key_counter == 0 || !(internal->m_keys[i] == child->m_keys[0]) || !self(self, child, height - 1)){
+                    return false;
+                }
+            }
+            return true;
+        };
+        std::size_t entries = 0;
+        for (auto leaf = multi.m_tree.m_min; leaf != nullptr; leaf = leaf->m_next){
+            for (std::size_t i = 0; i < leaf->m_key_counter; ++i, ++entries){
+                if ((i != 0 && leaf->m_keys[i] < leaf->m_keys[i - 1]) || (i == 0 && leaf->m_prev && leaf->m_keys[0] < leaf->m_prev->m_keys[leaf->m_prev->m_key_counter - 1])){
+                    return false;
+                }
+            }
+        }
+        return entries == multi.size() && check(check, multi.m_tree.m_root, multi.m_tree.m_height);
+    };
+
+    tester("1. repeated keys stay adjacent in insertion order", [&](){
+        constexpr int count = BPlusTest::num_inserted;
+        csaur::BPlusMultiTree<int,std::string,3> multi;
+        for (int copy = 0; copy < 8; ++copy){
+            for (int i = 0; i < count; ++i){
+                auto it = multi.insert((i * 7) % count, std::to_string(copy));
+                _ASSERT(it != multi.end() && it.key() == (i * 7) % count && *it == std::to_string(copy));
+            }
+        }
+        _ASSERT(multi.size() == (std::size_t)count * 8 && structure_valid(multi));
+        for (int i = -1; i <= count; ++i){
+            bool held = i >= 0 && i < count;
+            _ASSERT(multi.count(i) == (held ? 8u : 0u) && multi.contains(i) == held);
+            auto [first, last] = multi.equal_range(i);
+            int copy = 0;
+            for (; first != last; ++first, ++copy){
+                _ASSERT(first.key() == i && *first == std::to_string(copy));
+            }
+            _ASSERT(copy == (held ? 8 : 0));
+            _ASSERT(held ? (multi.find(i) != multi.end() && *multi.find(i) == "0") : multi.find(i) == multi.end());
+        }
+        for (int copy = 0; copy < 40; ++copy){                                  // a single run spanning many leaves
+            multi.insert(count / 2, "run");
+        }
+        _ASSERT(multi.count(count / 2) == 48u && *multi.lower_bound(count / 2) == "0" && structure_valid(multi));
+        _ASSERT(std::prev(multi.upper_bound(count / 2)).key() == count / 2 && *std::prev(multi.upper_bound(count / 2)) == "run");
+        return passed;
+    });
+
+    tester("2. erase_all_of removes runs spanning leaves", [&](){
+        constexpr int count = BPlusTest::num_inserted;
+        csaur::BPlusMultiTree<int,int,4> multi;
+        for (int i = 0; i < count; ++i){
+            for (int copy = 0; copy <= i % 5 * 4; ++copy){
+                multi.insert(i, copy);
+            }
+        }
+        std::size_t size = multi.size();
+        for (int i = 0; i < count; i += 3){
+            std::size_t run = multi.count(i);
+            _ASSERT(multi.erase_all_of(i) == run && run == (std::size_t)(i % 5 * 4 + 1));
+            size -= run;
+            _ASSERT(multi.size() == size && !multi.contains(i) && structure_valid(multi));
+        }
+        _ASSERT(multi.erase_all_of(0) == 0 && multi.erase_all_of(count) == 0);
+        for (int i = 0; i < count; ++i){
+            _ASSERT(multi.count(i) == (i % 3 == 0 ? 0u : (std::size_t)(i % 5 * 4 + 1)));
+        }
+        std::size_t inside = 0;
+        for (int i = 4; i < count - 4; ++i){
+            inside += multi.count(i);
+        }
+        _ASSERT(multi.erase_range(4, count - 4) == inside && multi.size() == size - inside && structure_valid(multi));
+        _ASSERT(multi.erase_if([](const int&, const int& value){ return value % 2 == 0; }) != 0 && structure_valid(multi));
+        multi.erase_all_of(multi.min_key());
+        multi.erase_all_of(multi.max_key());
+        _ASSERT(structure_valid(multi) && multi.begin() != multi.end());
+        return passed;
+    });
+
+    tester("3. order statistics count repeated keys", [&](){
+        constexpr int count = BPlusTest::num_inserted;
+        csaur::BPlusMultiTree<int, int, 3, csaur::DefaultAllocator<int>, csaur::DefaultAllocator<int>, csaur::DefaultAllocator<int>, csaur::DefaultSearch, csaur::MonoidAugment<csaur::Sum<long>>> multi;
+        for (int copy = 0; copy < 6; ++copy){
+            for (int i = 0; i < count; ++i){
+                multi.insert(i, 1);
+            }
+        }
+        for (int i = 0; i <= count; ++i){
+            _ASSERT(multi.rank(i) == (std::size_t)i * 6 && multi.select(i * 6 - (i == count)).key() == i - (i == count));
+            _ASSERT(multi.count_range(i, i + 2) == (std::size_t)(std::min(i + 2, count) - i) * 6 && multi.aggregate(0, i) == i * 6);
+        }
+        multi.erase_all_of(count / 2);
+        _ASSERT(multi.count_range(0, count) == (std::size_t)(count - 1) * 6 && multi.rank(count / 2 + 1) == (std::size_t)count / 2 * 6);
+        return passed;
+    });
+}
@@ -1,13 +1,22 @@
 #include "BPlusTest.hpp"
 
 void BPlusTest::test_nodes(){
+    auto leaf_insert = []<class Leaf>(Leaf& leaf, int key, int value){
+        Leaf::insert_at(leaf, leaf.find_smallest_bigger_key_index(key), int(key), int(value));
+    };
+    auto leaf_erase = []<class Leaf>(Leaf& leaf, int key){
+        Leaf::erase_at(leaf, leaf.find_smallest_bigger_key_index(key) - 1);
+    };
+
     std::cout << "LEAF TESTS:\n";
 
-    csaur::BPlusTree<int,int,4> tree4;
-    csaur::BPlusTree<int,int,5> tree5;
+    using even_tree = csaur::BPlusTree<int,int,4>;
+    using odd_tree = csaur::BPlusTree<int,int,5>;
+    even_tree tree4;
+    odd_tree tree5;
     tester("1. empty leaf", [&]{
-        typename csaur::BPlusTree<int,int,4>::node_type even_leaf (true);
-        typename csaur::BPlusTree<int,int,5>::node_type odd_leaf (true);
+        even_tree::leaf_type even_leaf;
+        odd_tree::leaf_type odd_leaf;
         _ASSERT(even_leaf.m_key_counter == 0);
         _ASSERT(odd_leaf.m_key_counter == 0);
         _ASSERT(even_leaf.m_next == nullptr);
@@ -16,43 +25,37 @@ void BPlusTest::test_nodes(){
         _ASSERT(odd_leaf.m_prev == nullptr);
         _ASSERT(even_leaf.search(0) == nullptr);
         _ASSERT(odd_leaf.search(0) == nullptr);
-        _ASSERT(even_leaf.erase(tree4,0) == false);
-        _ASSERT(odd_leaf.erase(tree5,0) == false);
         even_leaf.erase_all(tree4);
         odd_leaf.erase_all(tree5);
         return passed;
     });
 
-    tester("2. basic emplaceion", [&]{
-        typename csaur::BPlusTree<int,int,4>::node_type even_leaf (true);
-        typename csaur::BPlusTree<int,int,5>::node_type odd_leaf (true);
-        even_leaf.emplace(tree4,0,0);
-        even_leaf.emplace(tree4,10,10);
-        even_leaf.emplace(tree4,30,30);
-        even_leaf.emplace(tree4,20,20);
-        odd_leaf.emplace(tree5,20,20);
-        odd_leaf.emplace(tree5,40,40);
-        odd_leaf.emplace(tree5,30,30);
-        odd_leaf.emplace(tree5,0,0);
-        odd_leaf.emplace(tree5,10,10);
-        
-        _ASSERT(even_leaf.m_key_counter == 4);
-        _ASSERT(odd_leaf.m_key_counter == 5);
-        _ASSERT(*(even_leaf.search(0)) == 0);
-        _ASSERT(*(odd_leaf.search(0)) == 0);
-        _ASSERT(*(even_leaf.search(10)) == 10);
-        _ASSERT(*(odd_leaf.search(10)) == 10);
-        _ASSERT(*(even_leaf.search(20)) == 20);
-        _ASSERT(*(odd_leaf.search(20)) == 20);
-        _ASSERT(*(even_leaf.search(30)) == 30);
-        _ASSERT(*(odd_leaf.search(30)) == 30);
-        _ASSERT(*(odd_leaf.search(40)) == 40);
-        even_leaf.emplace(tree4,20,80);
-        odd_leaf.emplace(tree5,20,80);
+    tester("2. basic insertion", [&]{
+        even_tree::leaf_type even_leaf;
+        odd_tree::leaf_type odd_leaf;
+        leaf_insert(even_leaf, 0, 0);
+        leaf_insert(even_leaf, 10, 10);
+        leaf_insert(even_leaf, 30, 30);
+        leaf_insert(even_leaf, 20, 20);
+        leaf_insert(odd_leaf, 20, 20);
+        leaf_insert(odd_leaf, 40, 40);
+        leaf_insert(odd_leaf, 30, 30);
+        leaf_insert(odd_leaf, 0, 0);
+        leaf_insert(odd_leaf, 10, 10);
+
         _ASSERT(even_leaf.m_key_counter == 4);
         _ASSERT(odd_leaf.m_key_counter == 5);
-        _ASSERT(*(even_leaf.search(20)) == 20);
-        _ASSERT(*(odd_leaf.search(20)) == 20);
+        for (int i = 0; i < 4; ++i){
+            _ASSERT(even_leaf.m_keys[i] == 10 * i);
+            _ASSERT(*(even_leaf.search(10 * i)) == 10 * i);
+        }
+        for (int i = 0; i < 5; ++i){
+            _ASSERT(odd_leaf.m_keys[i] == 10 * i);
+            _ASSERT(*(odd_leaf.search(10 * i)) == 10 * i);
+        }
+        _ASSERT(even_leaf.search(5) == nullptr);
+        _ASSERT(odd_leaf.search(45) == nullptr);
+        _ASSERT(even_leaf.search(-5) == nullptr);
         even_leaf.erase_all(tree4);
         odd_leaf.erase_all(tree5);
         _ASSERT(even_leaf.m_key_counter == 0);
@@ -60,294 +63,78 @@ void BPlusTest::test_nodes(){
         return passed;
     });
 
-    tester("3. emplaceion above split", [&]{
-        typename csaur::BPlusTree<int,int,4>::node_type even_leaf (true);
-        typename csaur::BPlusTree<int,int,5>::node_type odd_leaf (true);
-        even_leaf.emplace(tree4,10,10);
-        even_leaf.emplace(tree4,20,20);
-        even_leaf.emplace(tree4,40,40);
-        even_leaf.emplace(tree4,0,0);
-
-        typename csaur::BPlusTree<int,int,4>::node_type* new_even_leaf = even_leaf.emplace(tree4,30,30);
-        csaur::BPlusTree<int,int,4>::node_type::restabilize(&even_leaf, new_even_leaf);
-        _ASSERT(even_leaf.m_next == new_even_leaf);
-        _ASSERT(new_even_leaf->m_prev == &even_leaf);
-        _ASSERT(*(even_leaf.search(0)) == 0);
-        _ASSERT(*(even_leaf.search(10)) == 10);
-        _ASSERT(((even_leaf.search(20) != nullptr) && (*(even_leaf.search(20)) == 20)) || (*(new_even_leaf->search(20)) == 20));
-        _ASSERT(*(new_even_leaf->search(30)) == 30);
-        _ASSERT(*(new_even_leaf->search(40)) == 40);
-        even_leaf.erase_all(tree4);
-        new_even_leaf->erase_all(tree4);
-        std::destroy_at(new_even_leaf);
-        tree4.m_node_alloc.deallocate(new_even_leaf);
-
-        odd_leaf.emplace(tree5,10,10);
-        odd_leaf.emplace(tree5,20,20);
-        odd_leaf.emplace(tree5,30,30);
-        odd_leaf.emplace(tree5,50,50);
-        odd_leaf.emplace(tree5,0,0);
-
-        typename csaur::BPlusTree<int,int,5>::node_type* new_odd_leaf = odd_leaf.emplace(tree5,40,40);
-        csaur::BPlusTree<int,int,5>::node_type::restabilize(&odd_leaf, new_odd_leaf);
-        _ASSERT(odd_leaf.m_next == new_odd_leaf);
-        _ASSERT(new_odd_leaf->m_prev == &odd_leaf);
-        _ASSERT(*(odd_leaf.search(0)) == 0);
-        _ASSERT(*(odd_leaf.search(10)) == 10);
-        _ASSERT(*(odd_leaf.search(20)) == 20);
-        _ASSERT(*(new_odd_leaf->search(30)) == 30);
-        _ASSERT(*(new_odd_leaf->search(40)) == 40);
-        _ASSERT(*(new_odd_leaf->search(50)) == 50);
-        odd_leaf.erase_all(tree5);
-        new_odd_leaf->erase_all(tree5);
-        std::destroy_at(new_odd_leaf);
-        tree5.m_node_alloc.deallocate(new_odd_leaf);
-        return passed;
-    });
-
-    tester("4. emplaceion below split", [&]{
-        typename csaur::BPlusTree<int,int,4>::node_type even_leaf (true);
-        typename csaur::BPlusTree<int,int,5>::node_type odd_leaf (true);
-        even_leaf.emplace(tree4,30,30);
-        even_leaf.emplace(tree4,20,20);
-        even_leaf.emplace(tree4,40,40);
-        even_leaf.emplace(tree4,0,0);
-
-        typename csaur::BPlusTree<int,int,4>::node_type* new_even_leaf = even_leaf.emplace(tree4,10,10);
-        csaur::BPlusTree<int,int,4>::node_type::restabilize(&even_leaf, new_even_leaf);
-        _ASSERT(even_leaf.m_next == new_even_leaf);
-        _ASSERT(new_even_leaf->m_prev == &even_leaf);
-        _ASSERT(*(even_leaf.search(0)) == 0);
-        _ASSERT(*(even_leaf.search(10)) == 10);
-        _ASSERT(((even_leaf.search(20) != nullptr) && (*(even_leaf.search(20)) == 20)) || (*(new_even_leaf->search(20)) == 20));
-        _ASSERT(*(new_even_leaf->search(30)) == 30);
-        _ASSERT(*(new_even_leaf->search(40)) == 40);
-        even_leaf.erase_all(tree4);
-        new_even_leaf->erase_all(tree4);
-        std::destroy_at(new_even_leaf);
-        tree4.m_node_alloc.deallocate(new_even_leaf);
-
-        odd_leaf.emplace(tree5,40,40);
-        odd_leaf.emplace(tree5,20,20);
-        odd_leaf.emplace(tree5,30,30);
-        odd_leaf.emplace(tree5,50,50);
-        odd_leaf.emplace(tree5,0,0);
-
-        typename csaur::BPlusTree<int,int,5>::node_type* new_odd_leaf = odd_leaf.emplace(tree5,10,10);
-        csaur::BPlusTree<int,int,5>::node_type::restabilize(&odd_leaf, new_odd_leaf);
-        _ASSERT(odd_leaf.m_next == new_odd_leaf);
-        _ASSERT(new_odd_leaf->m_prev == &odd_leaf);
-        _ASSERT(*(odd_leaf.search(0)) == 0);
-        _ASSERT(*(odd_leaf.search(10)) == 10);
-        _ASSERT(*(odd_leaf.search(20)) == 20);
-        _ASSERT(*(new_odd_leaf->search(30)) == 30);
-        _ASSERT(*(new_odd_leaf->search(40)) == 40);
-        _ASSERT(*(new_odd_leaf->search(50)) == 50);
-        odd_leaf.erase_all(tree5);
-        new_odd_leaf->erase_all(tree5);
-        std::destroy_at(new_odd_leaf);
-        tree5.m_node_alloc.deallocate(new_odd_leaf);
-        return passed;
-    });
-
-    tester("5. emplaceion near split", [&]{
-        typename csaur::BPlusTree<int,int,4>::node_type even_leaf (true);
-        typename csaur::BPlusTree<int,int,5>::node_type odd_leaf (true);
-        even_leaf.emplace(tree4,30,30);
-        even_leaf.emplace(tree4,10,10);
-        even_leaf.emplace(tree4,40,40);
-        even_leaf.emplace(tree4,0,0);
-
-        typename csaur::BPlusTree<int,int,4>::node_type* new_even_leaf = even_leaf.emplace(tree4,20,20);
-        csaur::BPlusTree<int,int,4>::node_type::restabilize(&even_leaf, new_even_leaf);
-        _ASSERT(even_leaf.m_next == new_even_leaf);
-        _ASSERT(new_even_leaf->m_prev == &even_leaf);
-        _ASSERT(*(even_leaf.search(0)) == 0);
-        _ASSERT(*(even_leaf.search(10)) == 10);
-        _ASSERT(((even_leaf.search(20) != nullptr) && (*(even_leaf.search(20)) == 20)) || (*(new_even_leaf->search(20)) == 20));
-        _ASSERT(*(new_even_leaf->search(30)) == 30);
-        _ASSERT(*(new_even_leaf->search(40)) == 40);
-        even_leaf.erase_all(tree4);
-        new_even_leaf->erase_all(tree4);
-        std::destroy_at(new_even_leaf);
-        tree4.m_node_alloc.deallocate(new_even_leaf);
-
-        odd_leaf.emplace(tree5,40,40);
-        odd_leaf.emplace(tree5,10,10);
-        odd_leaf.emplace(tree5,30,30);
-        odd_leaf.emplace(tree5,50,50);
-        odd_leaf.emplace(tree5,0,0);
-
-        typename csaur::BPlusTree<int,int,5>::node_type* new_odd_leaf = odd_leaf.emplace(tree5,20,20);
-        csaur::BPlusTree<int,int,5>::node_type::restabilize(&odd_leaf, new_odd_leaf);
-        _ASSERT(odd_leaf.m_next == new_odd_leaf);
-        _ASSERT(new_odd_leaf->m_prev == &odd_leaf);
-        _ASSERT(*(odd_leaf.search(0)) == 0);
-        _ASSERT(*(odd_leaf.search(10)) == 10);
-        _ASSERT(*(odd_leaf.search(20)) == 20);
-        _ASSERT(*(new_odd_leaf->search(30)) == 30);
-        _ASSERT(*(new_odd_leaf->search(40)) == 40);
-        _ASSERT(*(new_odd_leaf->search(50)) == 50);
-        odd_leaf.erase_all(tree5);
-        new_odd_leaf->erase_all(tree5);
-        std::destroy_at(new_odd_leaf);
-        tree5.m_node_alloc.deallocate(new_odd_leaf);
-
-        odd_leaf.m_next = nullptr; // new_odd_leaf got deleted, preventing a pointer error
-        odd_leaf.emplace(tree5,40,40);
-        odd_leaf.emplace(tree5,10,10);
-        odd_leaf.emplace(tree5,20,20);
-        odd_leaf.emplace(tree5,50,50);
-        odd_leaf.emplace(tree5,0,0);
-
-        new_odd_leaf = odd_leaf.emplace(tree5,30,30);
-        csaur::BPlusTree<int,int,5>::node_type::restabilize(&odd_leaf, new_odd_leaf);
-        _ASSERT(odd_leaf.m_next == new_odd_leaf);
-        _ASSERT(new_odd_leaf->m_prev == &odd_leaf);
-        _ASSERT(*(odd_leaf.search(0)) == 0);
-        _ASSERT(*(odd_leaf.search(10)) == 10);
-        _ASSERT(*(odd_leaf.search(20)) == 20);
-        _ASSERT(*(new_odd_leaf->search(30)) == 30);
-        _ASSERT(*(new_odd_leaf->search(40)) == 40);
-        _ASSERT(*(new_odd_leaf->search(50)) == 50);
-        odd_leaf.erase_all(tree5);
-        new_odd_leaf->erase_all(tree5);
-        std::destroy_at(new_odd_leaf);
-        tree5.m_node_alloc.deallocate(new_odd_leaf);
+    auto split_tester = [&](int inserted)->const char* {
+        even_tree::leaf_type even_leaf, new_even_leaf;
+        odd_tree::leaf_type odd_leaf, new_odd_leaf;
+        for (int key = 0; key < 50; key += 10){
+            if (key != inserted){
+                leaf_insert(even_leaf, key, key);
+            }
+            leaf_insert(odd_leaf, key, key);
+        }
+        ++inserted;  // the odd leaf already holds the multiples of ten, so it gets the successor instead
+
+        int index = even_leaf.find_smallest_bigger_key_index(inserted - 1);
+        even_tree::node_type::split_insert(even_leaf, new_even_leaf, index, int(inserted - 1), int(inserted - 1));
+        _ASSERT(even_leaf.m_key_counter >= even_tree::node_type::min_keys);
+        _ASSERT(new_even_leaf.m_key_counter >= even_tree::node_type::min_keys);
+        _ASSERT(even_leaf.m_key_counter + new_even_leaf.m_key_counter == 5);
+        _ASSERT(even_leaf.m_keys[even_leaf.m_key_counter - 1] < new_even_leaf.m_keys[0]);
+        for (int key = 0; key < 50; key += 10){
+            _ASSERT(((even_leaf.search(key) != nullptr) && (*(even_leaf.search(key)) == key)) || (*(new_even_leaf.search(key)) == key));
+        }
+
+        index = odd_leaf.find_smallest_bigger_key_index(inserted);
+        odd_tree::node_type::split_insert(odd_leaf, new_odd_leaf, index, int(inserted), int(inserted));
+        _ASSERT(odd_leaf.m_key_counter == 3);
+        _ASSERT(new_odd_leaf.m_key_counter == 3);
+        _ASSERT(odd_leaf.m_keys[2] < new_odd_leaf.m_keys[0]);
+        _ASSERT(((odd_leaf.search(inserted) != nullptr) && (*(odd_leaf.search(inserted)) == inserted)) || (*(new_odd_leaf.search(inserted)) == inserted));
+        for (int key = 0; key < 50; key += 10){
+            _ASSERT(((odd_leaf.search(key) != nullptr) && (*(odd_leaf.search(key)) == key)) || (*(new_odd_leaf.search(key)) == key));
+        }
         return passed;
-    });
+    };
 
-    tester("6. duplicate emplaceion", [&]{
-        typename csaur::BPlusTree<int,int,4>::node_type even_leaf (true);
-        typename csaur::BPlusTree<int,int,5>::node_type odd_leaf (true);
-        even_leaf.emplace(tree4,0,0);
-        odd_leaf.emplace(tree5,10,10);
-        
-        _ASSERT(*(even_leaf.search(0)) == 0);
-        _ASSERT(*(odd_leaf.search(10)) == 10);
+    tester("3. insertion above split", [&]{return split_tester(40);});
 
-        even_leaf.emplace(tree4,0,20);
-        odd_leaf.emplace(tree5,10,30);
-        _ASSERT(even_leaf.m_key_counter == 1);
-        _ASSERT(odd_leaf.m_key_counter == 1);
-        _ASSERT(*(even_leaf.search(0)) == 0);
-        _ASSERT(*(odd_leaf.search(10)) == 10);
+    tester("4. insertion below split", [&]{return split_tester(0);});
 
-        even_leaf.erase_all(tree4);
-        odd_leaf.erase_all(tree5);
-        _ASSERT(even_leaf.m_key_counter == 0);
-        _ASSERT(odd_leaf.m_key_counter == 0);
-        return passed;
-    });
+    tester("5. insertion near split", [&]{return split_tester(20);});
 
-    tester("7. deletion", [&]{
-        typename csaur::BPlusTree<int,int,4>::node_type even_leaf (true);
-        typename csaur::BPlusTree<int,int,5>::node_type odd_leaf (true);
-        even_leaf.emplace(tree4,0,0);
-        even_leaf.emplace(tree4,10,10);
-        even_leaf.emplace(tree4,30,30);
-        even_leaf.emplace(tree4,20,20);
-        odd_leaf.emplace(tree5,20,20);
-        odd_leaf.emplace(tree5,40,40);
-        odd_leaf.emplace(tree5,30,30);
-        odd_leaf.emplace(tree5,0,0);
-        odd_leaf.emplace(tree5,10,10);
-        
-        _ASSERT(even_leaf.m_key_counter == 4);
-        _ASSERT(odd_leaf.m_key_counter == 5);
-        _ASSERT(*(even_leaf.search(0)) == 0);
-        _ASSERT(*(odd_leaf.search(0)) == 0);
-        _ASSERT(*(even_leaf.search(10)) == 10);
-        _ASSERT(*(odd_leaf.search(10)) == 10);
-        _ASSERT(*(even_leaf.search(20)) == 20);
-        _ASSERT(*(odd_leaf.search(20)) == 20);
-        _ASSERT(*(even_leaf.search(30)) == 30);
-        _ASSERT(*(odd_leaf.search(30)) == 30);
-        _ASSERT(*(odd_leaf.search(40)) == 40);
+    tester("6. deletion", [&]{
+        even_tree::leaf_type even_leaf;
+        odd_tree::leaf_type odd_leaf;
+        for (int key = 0; key < 40; key += 10){
+            leaf_insert(even_leaf, key, key);
+        }
+        for (int key = 0; key < 50; key += 10){
+            leaf_insert(odd_leaf, key, key);
+        }
 
-        even_leaf.erase(tree4,0);
-        odd_leaf.erase(tree5,0);
+        leaf_erase(even_leaf, 0);
+        leaf_erase(odd_leaf, 0);
         _ASSERT(even_leaf.m_key_counter == 3);
         _ASSERT(odd_leaf.m_key_counter == 4);
         _ASSERT(even_leaf.search(0) == nullptr);
         _ASSERT(odd_leaf.search(0) == nullptr);
         _ASSERT(*(even_leaf.search(10)) == 10);
         _ASSERT(*(odd_leaf.search(10)) == 10);
-        _ASSERT(*(even_leaf.search(20)) == 20);
-        _ASSERT(*(odd_leaf.search(20)) == 20);
-        _ASSERT(*(even_leaf.search(30)) == 30);
-        _ASSERT(*(odd_leaf.search(30)) == 30);
-        _ASSERT(*(odd_leaf.search(40)) == 40);
-
-        even_leaf.erase(tree4,10);
-        odd_leaf.erase(tree5,10);
-        _ASSERT(even_leaf.m_key_counter == 2);
-        _ASSERT(odd_leaf.m_key_counter == 3);
-        _ASSERT(even_leaf.search(0) == nullptr);
-        _ASSERT(odd_leaf.search(0) == nullptr);
-        _ASSERT(even_leaf.search(10) == nullptr);
-        _ASSERT(odd_leaf.search(10) == nullptr);
-        _ASSERT(*(even_leaf.search(20)) == 20);
-        _ASSERT(*(odd_leaf.search(20)) == 20);
-        _ASSERT(*(even_leaf.search(30)) == 30);
-        _ASSERT(*(odd_leaf.search(30)) == 30);
-        _ASSERT(*(odd_leaf.search(40)) == 40);
-
-        _ASSERT(even_leaf.erase(tree4,10) == false); // already erased from the subtree
-        _ASSERT(odd_leaf.erase(tree5,10) == false);
-        _ASSERT(even_leaf.m_key_counter == 2);
-        _ASSERT(odd_leaf.m_key_counter == 3);
-        _ASSERT(even_leaf.search(0) == nullptr);
-        _ASSERT(odd_leaf.search(0) == nullptr);
-        _ASSERT(even_leaf.search(10) == nullptr);
-        _ASSERT(odd_leaf.search(10) == nullptr);
-        _ASSERT(*(even_leaf.search(20)) == 20);
-        _ASSERT(*(odd_leaf.search(20)) == 20);
         _ASSERT(*(even_leaf.search(30)) == 30);
-        _ASSERT(*(odd_leaf.search(30)) == 30);
         _ASSERT(*(odd_leaf.search(40)) == 40);
 
-        _ASSERT(even_leaf.erase(tree4,90) == false); // never was in the subtree
-        _ASSERT(odd_leaf.erase(tree5,90) == false);
+        leaf_erase(even_leaf, 30);
+        leaf_erase(odd_leaf, 20);
         _ASSERT(even_leaf.m_key_counter == 2);
         _ASSERT(odd_leaf.m_key_counter == 3);
-        _ASSERT(even_leaf.search(0) == nullptr);
-        _ASSERT(odd_leaf.search(0) == nullptr);
-        _ASSERT(even_leaf.search(10) == nullptr);
-        _ASSERT(odd_leaf.search(10) == nullptr);
-        _ASSERT(*(even_leaf.search(20)) == 20);
-        _ASSERT(*(odd_leaf.search(20)) == 20);
-        _ASSERT(*(even_leaf.search(30)) == 30);
-        _ASSERT(*(odd_leaf.search(30)) == 30);
-        _ASSERT(*(odd_leaf.search(40)) == 40);
-
-        even_leaf.erase(tree4,30);
-        odd_leaf.erase(tree5,30);
-        _ASSERT(even_leaf.m_key_counter == 1);
-        _ASSERT(odd_leaf.m_key_counter == 2);
-        _ASSERT(even_leaf.search(0) == nullptr);
-        _ASSERT(odd_leaf.search(0) == nullptr);
-        _ASSERT(even_leaf.search(10) == nullptr);
-        _ASSERT(odd_leaf.search(10) == nullptr);
-        _ASSERT(*(even_leaf.search(20)) == 20);
-        _ASSERT(*(odd_leaf.search(20)) == 20);
         _ASSERT(even_leaf.search(30) == nullptr);
-        _ASSERT(odd_leaf.search(30) == nullptr);
-        _ASSERT(*(odd_leaf.search(40)) == 40);
-
-        even_leaf.erase(tree4,20);
-        odd_leaf.erase(tree5,20);
-        _ASSERT(even_leaf.m_key_counter == 0);
-        _ASSERT(odd_leaf.m_key_counter == 1);
-        _ASSERT(even_leaf.search(0) == nullptr);
-        _ASSERT(odd_leaf.search(0) == nullptr);
-        _ASSERT(even_leaf.search(10) == nullptr);
-        _ASSERT(odd_leaf.search(10) == nullptr);
-        _ASSERT(even_leaf.search(20) == nullptr);
         _ASSERT(odd_leaf.search(20) == nullptr);
-        _ASSERT(even_leaf.search(30) == nullptr);
-        _ASSERT(odd_leaf.search(30) == nullptr);
+        _ASSERT(*(even_leaf.search(10)) == 10);
+        _ASSERT(*(even_leaf.search(20)) == 20);
+        _ASSERT(*(odd_leaf.search(10)) == 10);
+        _ASSERT(*(odd_leaf.search(30)) == 30);
         _ASSERT(*(odd_leaf.search(40)) == 40);
+        _ASSERT(odd_leaf.m_keys[0] == 10 && odd_leaf.m_keys[1] == 30 && odd_leaf.m_keys[2] == 40);
 
         even_leaf.erase_all(tree4);
         odd_leaf.erase_all(tree5);
@@ -356,935 +143,299 @@ void BPlusTest::test_nodes(){
         return passed;
     });
 
-    std::cout << "INTERNAL NODE TESTS:\n";
-    
-    tester("1. search", [&]{
-        typename csaur::BPlusTree<int,int,4>::node_type even_leaf_1 (true);
-        even_leaf_1.emplace(tree4,0,0);
-        even_leaf_1.emplace(tree4,10,10);
-        even_leaf_1.emplace(tree4,30,30);
-        even_leaf_1.emplace(tree4,20,20);
-        typename csaur::BPlusTree<int,int,4>::node_type even_leaf_2 (true);
-        even_leaf_2.emplace(tree4,40,40);
-        even_leaf_2.emplace(tree4,50,50);
-        even_leaf_2.emplace(tree4,60,60);
-        even_leaf_2.emplace(tree4,70,70);
-        typename csaur::BPlusTree<int,int,4>::node_type even_node (false);
-        even_node.m_key_counter = 2;
-        std::get<1>(even_node.m_data)[0] = &even_leaf_1;
-        std::get<1>(even_node.m_data)[1] = &even_leaf_2;
-        even_node.m_keys[0] = even_leaf_1.m_keys[0];
-        even_node.m_keys[1] = even_leaf_2.m_keys[0];
-
-        _ASSERT(even_node.m_key_counter == 2);
-        _ASSERT(even_node.m_keys[0] == 0);
-        _ASSERT(even_node.m_keys[1] == 40);
-        _ASSERT(std::get<1>(even_node.m_data)[0] == &even_leaf_1);
-        _ASSERT(std::get<1>(even_node.m_data)[1] == &even_leaf_2);
-        _ASSERT(*(even_node.search(0)) == 0);
-        _ASSERT(*(even_node.search(10)) == 10);
-        _ASSERT(*(even_node.search(20)) == 20);
-        _ASSERT(*(even_node.search(30)) == 30);
-        _ASSERT(*(even_node.search(40)) == 40);
-        _ASSERT(*(even_node.search(50)) == 50);
-        _ASSERT(*(even_node.search(60)) == 60);
-        _ASSERT(*(even_node.search(70)) == 70);
-        _ASSERT(even_node.search(-1) == nullptr);
-        even_leaf_1.erase_all(tree4);
-        even_leaf_2.erase_all(tree4);
-
-        typename csaur::BPlusTree<int,int,5>::node_type odd_leaf_1 (true);
-        odd_leaf_1.emplace(tree5,0,0);
-        odd_leaf_1.emplace(tree5,10,10);
-        odd_leaf_1.emplace(tree5,30,30);
-        odd_leaf_1.emplace(tree5,-10,-10);
-        odd_leaf_1.emplace(tree5,20,20);
-        typename csaur::BPlusTree<int,int,5>::node_type odd_leaf_2 (true);
-        odd_leaf_2.emplace(tree5,40,40);
-        odd_leaf_2.emplace(tree5,50,50);
-        odd_leaf_2.emplace(tree5,60,60);
-        odd_leaf_2.emplace(tree5,80,80);
-        odd_leaf_2.emplace(tree5,70,70);
-        typename csaur::BPlusTree<int,int,5>::node_type odd_node (false);
-        odd_node.m_key_counter = 2;
-        std::get<1>(odd_node.m_data)[0] = &odd_leaf_1;
-        std::get<1>(odd_node.m_data)[1] = &odd_leaf_2;
-        odd_node.m_keys[0] = odd_leaf_1.m_keys[0];
-        odd_node.m_keys[1] = odd_leaf_2.m_keys[0];
-
-        _ASSERT(odd_node.m_key_counter == 2);
-        _ASSERT(odd_node.m_keys[0] == -10);
-        _ASSERT(odd_node.m_keys[1] == 40);
-        _ASSERT(std::get<1>(odd_node.m_data)[0] == &odd_leaf_1);
-        _ASSERT(std::get<1>(odd_node.m_data)[1] == &odd_leaf_2);
-        _ASSERT(*(odd_node.search(-10)) == -10);
-        _ASSERT(*(odd_node.search(0)) == 0);
-        _ASSERT(*(odd_node.search(10)) == 10);
-        _ASSERT(*(odd_node.search(20)) == 20);
-        _ASSERT(*(odd_node.search(30)) == 30);
-        _ASSERT(*(odd_node.search(40)) == 40);
-        _ASSERT(*(odd_node.search(50)) == 50);
-        _ASSERT(*(odd_node.search(60)) == 60);
-        _ASSERT(*(odd_node.search(70)) == 70);
-        _ASSERT(*(odd_node.search(80)) == 80);
-        _ASSERT(odd_node.search(-1) == nullptr);
-        odd_leaf_1.erase_all(tree5);
-        odd_leaf_2.erase_all(tree5);
+    tester("7. allocated values", [&]{
+        using string_tree = csaur::BPlusTree<int,std::string,4>;
+        string_tree tree;
+        string_tree::leaf_type leaf;
+        _ASSERT(!string_tree::leaf_type::stores_inline);
+        _ASSERT(even_tree::leaf_type::stores_inline);
+        for (int key = 0; key < 4; ++key){
+            string_tree::node_type::insert_at(leaf, key, int(key), std::construct_at(tree.m_val_alloc.allocate(), std::to_string(key)));
+        }
+        _ASSERT(*(leaf.search(2)) == "2");
+        string_tree::leaf_type::destroy_slot(tree, leaf.m_data[2]);
+        string_tree::node_type::erase_at(leaf, 2);
+        _ASSERT(leaf.search(2) == nullptr);
+        _ASSERT(*(leaf.search(3)) == "3");
+        leaf.erase_all(tree);
+        _ASSERT(leaf.m_key_counter == 0);
         return passed;
     });
 
-    tester("2. basic emplaceion", [&]{
-        typename csaur::BPlusTree<int,int,4>::node_type even_leaf_1 (true);
-        even_leaf_1.emplace(tree4,0,0);
-        even_leaf_1.emplace(tree4,10,10);
-        typename csaur::BPlusTree<int,int,4>::node_type even_leaf_2 (true);
-        even_leaf_2.emplace(tree4,60,60);
-        even_leaf_2.emplace(tree4,70,70);
-        typename csaur::BPlusTree<int,int,4>::node_type even_node (false);
-        even_node.m_key_counter = 2;
-        std::get<1>(even_node.m_data)[0] = &even_leaf_1;
-        std::get<1>(even_node.m_data)[1] = &even_leaf_2;
-        even_node.m_keys[0] = even_leaf_1.m_keys[0];
-        even_node.m_keys[1] = 40;
-
-        even_node.emplace(tree4,30,30);
-        even_node.emplace(tree4,20,20);
-        even_node.emplace(tree4,40,40);
-        even_node.emplace(tree4,50,50);
-
-        _ASSERT(even_node.m_key_counter == 2);
-        _ASSERT(even_node.m_keys[0] == 0);
-        _ASSERT(even_node.m_keys[1] == 40);
-        _ASSERT(std::get<1>(even_node.m_data)[0] == &even_leaf_1);
-        _ASSERT(std::get<1>(even_node.m_data)[1] == &even_leaf_2);
-        _ASSERT(*(even_node.search(0)) == 0);
-        _ASSERT(*(even_node.search(10)) == 10);
-        _ASSERT(*(even_node.search(20)) == 20);
-        _ASSERT(*(even_node.search(30)) == 30);
-        _ASSERT(*(even_node.search(40)) == 40);
-        _ASSERT(*(even_node.search(50)) == 50);
-        _ASSERT(*(even_node.search(60)) == 60);
-        _ASSERT(*(even_node.search(70)) == 70);
-        even_leaf_1.erase_all(tree4);
-        even_leaf_2.erase_all(tree4);
-
-        typename csaur::BPlusTree<int,int,5>::node_type odd_leaf_1 (true);
-        odd_leaf_1.emplace(tree5,0,0);
-        odd_leaf_1.emplace(tree5,10,10);
-        odd_leaf_1.emplace(tree5,30,30);
-        typename csaur::BPlusTree<int,int,5>::node_type odd_leaf_2 (true);
-        odd_leaf_2.emplace(tree5,40,40);
-        odd_leaf_2.emplace(tree5,50,50);
-        
-        typename csaur::BPlusTree<int,int,5>::node_type odd_node (false);
-        odd_node.m_key_counter = 2;
-        std::get<1>(odd_node.m_data)[0] = &odd_leaf_1;
-        std::get<1>(odd_node.m_data)[1] = &odd_leaf_2;
-        odd_node.m_keys[0] = odd_leaf_1.m_keys[0];
-        odd_node.m_keys[1] = odd_leaf_2.m_keys[0];
+    std::cout << "INTERNAL NODE TESTS:\n";
 
-        odd_node.emplace(tree5,-10,-10);
-        odd_node.emplace(tree5,20,20);
-        odd_node.emplace(tree5,60,60);
-        odd_node.emplace(tree5,80,80);
-        odd_node.emplace(tree5,70,70);
+    // builds an internal node over leaves holding {0, 10, ...}, {100, 110, ...}, ... with the given sizes
+    auto make_node = [&](even_tree::internal_type& node, std::initializer_list<int> sizes){
+        node.m_key_counter = 0;
+        even_tree::leaf_type* prev = nullptr;
+        int base = 0;
+        for (int size : sizes){
+            even_tree::leaf_type* leaf = std::construct_at(tree4.m_leaf_alloc.allocate());
+            for (int key = base; key < base + 10 * size; key += 10){
+                leaf_insert(*leaf, key, key);
+            }
+            leaf->m_prev = prev;
+            if (prev){
+                prev->m_next = leaf;
+            }
+            prev = leaf;
+            even_tree::node_type::insert_at(node, node.m_key_counter, int(base), leaf);
+            base += 100;
+        }
+    };
+    auto leaf_at = [](even_tree::internal_type& node, std::size_t i){
+        return static_cast<even_tree::leaf_type*>(node.m_data[i]);
+    };
 
-        _ASSERT(odd_node.m_key_counter == 2);
-        _ASSERT(odd_node.m_keys[0] == -10);
-        _ASSERT(odd_node.m_keys[1] == 40);
-        _ASSERT(std::get<1>(odd_node.m_data)[0] == &odd_leaf_1);
-        _ASSERT(std::get<1>(odd_node.m_data)[1] == &odd_leaf_2);
-        _ASSERT(*(odd_node.search(-10)) == -10);
-        _ASSERT(*(odd_node.search(0)) == 0);
-        _ASSERT(*(odd_node.search(10)) == 10);
-        _ASSERT(*(odd_node.search(20)) == 20);
-        _ASSERT(*(odd_node.search(30)) == 30);
-        _ASSERT(*(odd_node.search(40)) == 40);
-        _ASSERT(*(odd_node.search(50)) == 50);
-        _ASSERT(*(odd_node.search(60)) == 60);
-        _ASSERT(*(odd_node.search(70)) == 70);
-        _ASSERT(*(odd_node.search(80)) == 80);
-        odd_leaf_1.erase_all(tree5);
-        odd_leaf_2.erase_all(tree5);
+    tester("1. search", [&]{
+        even_tree::internal_type node;
+        make_node(node, {3, 3, 2});
+        _ASSERT(node.m_key_counter == 3);
+        _ASSERT(node.child_index(-5) == 0);
+        _ASSERT(node.child_index(0) == 0);
+        _ASSERT(node.child_index(99) == 0);
+        _ASSERT(node.child_index(100) == 1);
+        _ASSERT(node.child_index(150) == 1);
+        _ASSERT(node.child_index(200) == 2);
+        _ASSERT(node.child_index(1000) == 2);
+        _ASSERT(*(leaf_at(node, node.child_index(110))->search(110)) == 110);
+        _ASSERT(leaf_at(node, node.child_index(115))->search(115) == nullptr);
+        _ASSERT(leaf_at(node, 0)->m_next == leaf_at(node, 1));
+        _ASSERT(leaf_at(node, 2)->m_prev == leaf_at(node, 1));
+        node.erase_all(tree4, 1);
+        _ASSERT(node.m_key_counter == 0);
         return passed;
     });
 
-    tester("3. emplaceion with subnode splitting", [&]{
-        typename csaur::BPlusTree<int,int,4>::node_type even_leaf_1 (true);
-        even_leaf_1.emplace(tree4,0,0);
-        even_leaf_1.emplace(tree4,10,10);
-        even_leaf_1.emplace(tree4,30,30);
-        even_leaf_1.emplace(tree4,20,20);
-        typename csaur::BPlusTree<int,int,4>::node_type even_leaf_2 (true);
-        even_leaf_2.emplace(tree4,80,80);
-        even_leaf_2.emplace(tree4,50,50);
-        even_leaf_2.emplace(tree4,60,60);
-        even_leaf_2.emplace(tree4,70,70);
-        typename csaur::BPlusTree<int,int,4>::node_type even_node (false);
-        even_node.m_key_counter = 2;
-        std::get<1>(even_node.m_data)[0] = &even_leaf_1;
-        std::get<1>(even_node.m_data)[1] = &even_leaf_2;
-        even_node.m_keys[0] = even_leaf_1.m_keys[0];
-        even_node.m_keys[1] = even_leaf_2.m_keys[0];
-        even_node.emplace(tree4,40,40);
-
-        _ASSERT(even_node.m_key_counter == 3);
-        _ASSERT(even_node.m_keys[0] == 0);
-        _ASSERT(even_node.m_keys[2] == 50);
-        _ASSERT(std::get<1>(even_node.m_data)[0] == &even_leaf_1);
-        _ASSERT(std::get<1>(even_node.m_data)[2] == &even_leaf_2);
-        _ASSERT(*(even_node.search(0)) == 0);
-        _ASSERT(*(even_node.search(10)) == 10);
-        _ASSERT(*(even_node.search(20)) == 20);
-        _ASSERT(*(even_node.search(30)) == 30);
-        _ASSERT(*(even_node.search(40)) == 40);
-        _ASSERT(*(even_node.search(50)) == 50);
-        _ASSERT(*(even_node.search(60)) == 60);
-        _ASSERT(*(even_node.search(70)) == 70);
-        _ASSERT(*(even_node.search(80)) == 80);
-        even_leaf_1.erase_all(tree4);
-        even_leaf_2.erase_all(tree4);
-        std::get<1>(even_node.m_data)[1]->erase_all(tree4);
-        std::destroy_at(std::get<1>(even_node.m_data)[1]);
-        tree4.m_node_alloc.deallocate(std::get<1>(even_node.m_data)[1]);
-
-        typename csaur::BPlusTree<int,int,5>::node_type odd_leaf_1 (true);
-        odd_leaf_1.emplace(tree5,0,0);
-        odd_leaf_1.emplace(tree5,10,10);
-        odd_leaf_1.emplace(tree5,30,30);
-        odd_leaf_1.emplace(tree5,-10,-10);
-        odd_leaf_1.emplace(tree5,20,20);
-        typename csaur::BPlusTree<int,int,5>::node_type odd_leaf_2 (true);
-        odd_leaf_2.emplace(tree5,40,40);
-        odd_leaf_2.emplace(tree5,50,50);
-        odd_leaf_2.emplace(tree5,60,60);
-        odd_leaf_2.emplace(tree5,80,80);
-        odd_leaf_2.emplace(tree5,70,70);
-        typename csaur::BPlusTree<int,int,5>::node_type odd_node (false);
-        odd_node.m_key_counter = 2;
-        std::get<1>(odd_node.m_data)[0] = &odd_leaf_1;
-        std::get<1>(odd_node.m_data)[1] = &odd_leaf_2;
-        odd_node.m_keys[0] = odd_leaf_1.m_keys[0];
-        odd_node.m_keys[1] = odd_leaf_2.m_keys[0];
-
-        odd_node.emplace(tree5,-20,-20);
-        _ASSERT(odd_node.m_key_counter == 3);
-        _ASSERT(odd_node.m_keys[0] == -20);
-        _ASSERT(odd_node.m_keys[2] == 40);
-        _ASSERT(std::get<1>(odd_node.m_data)[0] == &odd_leaf_1);
-        _ASSERT(std::get<1>(odd_node.m_data)[2] == &odd_leaf_2);
-        _ASSERT(*(odd_node.search(-20)) == -20);
-        _ASSERT(*(odd_node.search(-10)) == -10);
-        _ASSERT(*(odd_node.search(0)) == 0);
-        _ASSERT(*(odd_node.search(10)) == 10);
-        _ASSERT(*(odd_node.search(20)) == 20);
-        _ASSERT(*(odd_node.search(30)) == 30);
-        _ASSERT(*(odd_node.search(40)) == 40);
-        _ASSERT(*(odd_node.search(50)) == 50);
-        _ASSERT(*(odd_node.search(60)) == 60);
-        _ASSERT(*(odd_node.search(70)) == 70);
-        _ASSERT(*(odd_node.search(80)) == 80);
-        _ASSERT(odd_node.search(-1) == nullptr);
-        odd_leaf_1.erase_all(tree5);
-        odd_leaf_2.erase_all(tree5);
-        std::get<1>(odd_node.m_data)[1]->erase_all(tree5);
-        std::destroy_at(std::get<1>(odd_node.m_data)[1]);
-        tree5.m_node_alloc.deallocate(std::get<1>(odd_node.m_data)[1]);
+    tester("2. insertion with this splitting", [&]{
+        even_tree::internal_type node, new_node;
+        make_node(node, {2, 2, 2, 2});
+        even_tree::leaf_type* leaf = std::construct_at(tree4.m_leaf_alloc.allocate());
+        leaf_insert(*leaf, 450, 450);
+        even_tree::node_type::split_insert(node, new_node, 4, 450, leaf);
+        _ASSERT(node.m_key_counter == 2);
+        _ASSERT(new_node.m_key_counter == 3);
+        _ASSERT(node.m_keys[0] == 0 && node.m_keys[1] == 100);
+        _ASSERT(new_node.m_keys[0] == 200 && new_node.m_keys[1] == 300 && new_node.m_keys[2] == 450);
+        _ASSERT(new_node.m_data[2] == leaf);
+        _ASSERT(*(static_cast<even_tree::leaf_type*>(new_node.m_data[new_node.child_index(450)])->search(450)) == 450);
+        node.erase_all(tree4, 1);
+        new_node.erase_all(tree4, 1);
         return passed;
     });
 
-    tester("4. emplaceion with this splitting", [&]{
-        typename csaur::BPlusTree<int,int,4>::node_type* even_leaf_1 = std::construct_at(tree4.m_node_alloc.allocate(), true);
-        even_leaf_1->emplace(tree4,0,0);
-        even_leaf_1->emplace(tree4,10,10);
-        typename csaur::BPlusTree<int,int,4>::node_type* even_leaf_2 = std::construct_at(tree4.m_node_alloc.allocate(), true);
-        even_leaf_2->emplace(tree4,30,30);
-        even_leaf_2->emplace(tree4,20,20);
-        even_leaf_2->emplace(tree4,40,40);
-        typename csaur::BPlusTree<int,int,4>::node_type* even_leaf_3 = std::construct_at(tree4.m_node_alloc.allocate(), true);
-        even_leaf_3->emplace(tree4,50,50);
-        even_leaf_3->emplace(tree4,60,60);
-        even_leaf_3->emplace(tree4,70,70);
-        even_leaf_3->emplace(tree4,80,80);
-        typename csaur::BPlusTree<int,int,4>::node_type* even_leaf_4 = std::construct_at(tree4.m_node_alloc.allocate(), true);
-        even_leaf_4->emplace(tree4,120,120);
-        even_leaf_4->emplace(tree4,100,100);
-        even_leaf_4->emplace(tree4,110,110);
-        typename csaur::BPlusTree<int,int,4>::node_type even_node (false);
-        even_node.m_key_counter = 4;
-        std::get<1>(even_node.m_data)[0] = even_leaf_1;
-        std::get<1>(even_node.m_data)[1] = even_leaf_2;
-        std::get<1>(even_node.m_data)[2] = even_leaf_3;
-        std::get<1>(even_node.m_data)[3] = even_leaf_4;
-        even_node.m_keys[0] = even_leaf_1->m_keys[0];
-        even_node.m_keys[1] = even_leaf_2->m_keys[0];
-        even_node.m_keys[2] = even_leaf_3->m_keys[0];
-        even_node.m_keys[3] = even_leaf_4->m_keys[0];
-        auto new_even_node = even_node.emplace(tree4,90,90);
-        csaur::BPlusTree<int,int,4>::node_type::restabilize(&even_node, new_even_node);
-
-        _ASSERT(1 < even_node.m_key_counter && even_node.m_key_counter < 4);
-        _ASSERT(*(even_node.search(0)) == 0);
-        _ASSERT(*(even_node.search(10)) == 10);
-        _ASSERT(*(even_node.search(20)) == 20);
-        _ASSERT(*(even_node.search(30)) == 30);
-        _ASSERT(*(even_node.search(40)) == 40);
-        _ASSERT(((even_node.search(50) != nullptr) && (*(even_node.search(50)) == 50)) || (*(new_even_node->search(50)) == 50));
-        _ASSERT(((even_node.search(60) != nullptr) && (*(even_node.search(60)) == 60)) || (*(new_even_node->search(60)) == 60));
-        _ASSERT(((even_node.search(70) != nullptr) && (*(even_node.search(70)) == 70)) || (*(new_even_node->search(70)) == 70));
-        _ASSERT(*(new_even_node->search(80)) == 80);
-        _ASSERT(*(new_even_node->search(90)) == 90);
-        _ASSERT(*(new_even_node->search(100)) == 100);
-        _ASSERT(*(new_even_node->search(110)) == 110);
-        _ASSERT(*(new_even_node->search(120)) == 120);
-        even_node.erase_all(tree4);
-        new_even_node->erase_all(tree4);
-        std::destroy_at(new_even_node);
-        tree4.m_node_alloc.deallocate(new_even_node);
-
-        typename csaur::BPlusTree<int,int,5>::node_type* odd_leaf_1 = std::construct_at(tree5.m_node_alloc.allocate(), true);
-        odd_leaf_1->emplace(tree5,-20,-20);
-        odd_leaf_1->emplace(tree5,0,0);
-        odd_leaf_1->emplace(tree5,-10,-10);
-        typename csaur::BPlusTree<int,int,5>::node_type* odd_leaf_2 = std::construct_at(tree5.m_node_alloc.allocate(), true);
-        odd_leaf_2->emplace(tree5,30,30);
-        odd_leaf_2->emplace(tree5,20,20);
-        odd_leaf_2->emplace(tree5,10,10);
-        typename csaur::BPlusTree<int,int,5>::node_type* odd_leaf_3 = std::construct_at(tree5.m_node_alloc.allocate(), true);
-        odd_leaf_3->emplace(tree5,50,50);
-        odd_leaf_3->emplace(tree5,40,40);
-        odd_leaf_3->emplace(tree5,60,60);
-        odd_leaf_3->emplace(tree5,70,70);
-        odd_leaf_3->emplace(tree5,80,80);
-        typename csaur::BPlusTree<int,int,5>::node_type* odd_leaf_4 = std::construct_at(tree5.m_node_alloc.allocate(), true);
-        odd_leaf_4->emplace(tree5,120,120);
-        odd_leaf_4->emplace(tree5,100,100);
-        odd_leaf_4->emplace(tree5,110,110);
-        typename csaur::BPlusTree<int,int,5>::node_type* odd_leaf_5 = std::construct_at(tree5.m_node_alloc.allocate(), true);
-        odd_leaf_5->emplace(tree5,130,130);
-        odd_leaf_5->emplace(tree5,140,140);
-        odd_leaf_5->emplace(tree5,150,150);
-        typename csaur::BPlusTree<int,int,5>::node_type odd_node (false);
-        odd_node.m_key_counter = 5;
-        std::get<1>(odd_node.m_data)[0] = odd_leaf_1;
-        std::get<1>(odd_node.m_data)[1] = odd_leaf_2;
-        std::get<1>(odd_node.m_data)[2] = odd_leaf_3;
-        std::get<1>(odd_node.m_data)[3] = odd_leaf_4;
-        std::get<1>(odd_node.m_data)[4] = odd_leaf_5;
-        odd_node.m_keys[0] = odd_leaf_1->m_keys[0];
-        odd_node.m_keys[1] = odd_leaf_2->m_keys[0];
-        odd_node.m_keys[2] = odd_leaf_3->m_keys[0];
-        odd_node.m_keys[3] = odd_leaf_4->m_keys[0];
-        odd_node.m_keys[4] = odd_leaf_5->m_keys[0];
-        auto new_odd_node = odd_node.emplace(tree5,90,90);
-        csaur::BPlusTree<int,int,5>::node_type::restabilize(&odd_node, new_odd_node);
-
-        _ASSERT(1 < odd_node.m_key_counter && odd_node.m_key_counter < 4);
-        _ASSERT(*(odd_node.search(-20)) == -20);
-        _ASSERT(*(odd_node.search(-10)) == -10);
-        _ASSERT(*(odd_node.search(0)) == 0);
-        _ASSERT(*(odd_node.search(10)) == 10);
-        _ASSERT(*(odd_node.search(20)) == 20);
-        _ASSERT(*(odd_node.search(30)) == 30);
-        _ASSERT(*(odd_node.search(40)) == 40);
-        _ASSERT(*(odd_node.search(50)) == 50);
-        _ASSERT(*(odd_node.search(60)) == 60);
-        _ASSERT(*(new_odd_node->search(70)) == 70);
-        _ASSERT(*(new_odd_node->search(80)) == 80);
-        _ASSERT(*(new_odd_node->search(90)) == 90);
-        _ASSERT(*(new_odd_node->search(100)) == 100);
-        _ASSERT(*(new_odd_node->search(110)) == 110);
-        _ASSERT(*(new_odd_node->search(120)) == 120);
-        _ASSERT(*(new_odd_node->search(130)) == 130);
-        _ASSERT(*(new_odd_node->search(140)) == 140);
-        _ASSERT(*(new_odd_node->search(150)) == 150);
-        odd_node.erase_all(tree5);
-        new_odd_node->erase_all(tree5);
-        std::destroy_at(new_odd_node);
-        tree5.m_node_alloc.deallocate(new_odd_node);
+    tester("3. borrowing from the right", [&]{
+        even_tree::internal_type node;
+        make_node(node, {1, 4, 2});
+        node.handle_underflow<false>(tree4, 0);
+        _ASSERT(node.m_key_counter == 3);
+        _ASSERT(leaf_at(node, 0)->m_key_counter == 2);
+        _ASSERT(leaf_at(node, 1)->m_key_counter == 3);
+        _ASSERT(leaf_at(node, 0)->m_keys[1] == 100);
+        _ASSERT(node.m_keys[1] == 110);
+        _ASSERT(*(leaf_at(node, node.child_index(100))->search(100)) == 100);
+        _ASSERT(*(leaf_at(node, node.child_index(110))->search(110)) == 110);
+        node.erase_all(tree4, 1);
         return passed;
     });
 
-    tester("5. basic deletion", [&]{
-        typename csaur::BPlusTree<int,int,4>::node_type* even_leaf_1 = std::construct_at(tree4.m_node_alloc.allocate(), true);
-        even_leaf_1->emplace(tree4,0,0);
-        even_leaf_1->emplace(tree4,10,10);
-        typename csaur::BPlusTree<int,int,4>::node_type* even_leaf_2 = std::construct_at(tree4.m_node_alloc.allocate(), true);
-        even_leaf_2->emplace(tree4,30,30);
-        even_leaf_2->emplace(tree4,20,20);
-        even_leaf_2->emplace(tree4,40,40);
-        typename csaur::BPlusTree<int,int,4>::node_type* even_leaf_3 = std::construct_at(tree4.m_node_alloc.allocate(), true);
-        even_leaf_3->emplace(tree4,50,50);
-        even_leaf_3->emplace(tree4,60,60);
-        even_leaf_3->emplace(tree4,70,70);
-        even_leaf_3->emplace(tree4,80,80);
-        typename csaur::BPlusTree<int,int,4>::node_type* even_leaf_4 = std::construct_at(tree4.m_node_alloc.allocate(), true);
-        even_leaf_4->emplace(tree4,120,120);
-        even_leaf_4->emplace(tree4,100,100);
-        even_leaf_4->emplace(tree4,110,110);
-        typename csaur::BPlusTree<int,int,4>::node_type even_node (false);
-        even_node.m_key_counter = 4;
-        std::get<1>(even_node.m_data)[0] = even_leaf_1;
-        std::get<1>(even_node.m_data)[1] = even_leaf_2;
-        std::get<1>(even_node.m_data)[2] = even_leaf_3;
-        std::get<1>(even_node.m_data)[3] = even_leaf_4;
-        even_node.m_keys[0] = even_leaf_1->m_keys[0];
-        even_node.m_keys[1] = even_leaf_2->m_keys[0];
-        even_node.m_keys[2] = even_leaf_3->m_keys[0];
-        even_node.m_keys[3] = even_leaf_4->m_keys[0];
-
-        _ASSERT(even_node.m_key_counter == 4);
-        _ASSERT(*(even_node.search(0)) == 0);
-        _ASSERT(*(even_node.search(10)) == 10);
-        _ASSERT(*(even_node.search(20)) == 20);
-        _ASSERT(*(even_node.search(30)) == 30);
-        _ASSERT(*(even_node.search(40)) == 40);
-        _ASSERT(*(even_node.search(50)) == 50);
-        _ASSERT(*(even_node.search(60)) == 60);
-        _ASSERT(*(even_node.search(70)) == 70);
-        _ASSERT(*(even_node.search(80)) == 80);
-        _ASSERT(*(even_node.search(100)) == 100);
-        _ASSERT(*(even_node.search(110)) == 110);
-        _ASSERT(*(even_node.search(120)) == 120);
-
-        _ASSERT(even_node.erase(tree4,70) == true);
-        _ASSERT(even_node.m_key_counter == 4);
-        _ASSERT(std::get<1>(even_node.m_data)[2]->m_key_counter == 3);
-        _ASSERT(*(even_node.search(0)) == 0);
-        _ASSERT(*(even_node.search(10)) == 10);
-        _ASSERT(*(even_node.search(20)) == 20);
-        _ASSERT(*(even_node.search(30)) == 30);
-        _ASSERT(*(even_node.search(40)) == 40);
-        _ASSERT(*(even_node.search(50)) == 50);
-        _ASSERT(*(even_node.search(60)) == 60);
-        _ASSERT(even_node.search(70) == nullptr);
-        _ASSERT(*(even_node.search(80)) == 80);
-        _ASSERT(*(even_node.search(100)) == 100);
-        _ASSERT(*(even_node.search(110)) == 110);
-        _ASSERT(*(even_node.search(120)) == 120);
-
-        _ASSERT(even_node.erase(tree4,100) == true);
-        _ASSERT(even_node.m_key_counter == 4);
-        _ASSERT(std::get<1>(even_node.m_data)[3]->m_key_counter == 2);
-        _ASSERT(*(even_node.search(0)) == 0);
-        _ASSERT(*(even_node.search(10)) == 10);
-        _ASSERT(*(even_node.search(20)) == 20);
-        _ASSERT(*(even_node.search(30)) == 30);
-        _ASSERT(*(even_node.search(40)) == 40);
-        _ASSERT(*(even_node.search(50)) == 50);
-        _ASSERT(*(even_node.search(60)) == 60);
-        _ASSERT(even_node.search(70) == nullptr);
-        _ASSERT(*(even_node.search(80)) == 80);
-        _ASSERT(even_node.search(100) == nullptr);
-        _ASSERT(*(even_node.search(110)) == 110);
-        _ASSERT(*(even_node.search(120)) == 120);
-
-        _ASSERT(even_node.erase(tree4,100) == false); // already erased from the subtree4,
-        _ASSERT(even_node.m_key_counter == 4);
-        _ASSERT(std::get<1>(even_node.m_data)[3]->m_key_counter == 2);
-        _ASSERT(*(even_node.search(0)) == 0);
-        _ASSERT(*(even_node.search(10)) == 10);
-        _ASSERT(*(even_node.search(20)) == 20);
-        _ASSERT(*(even_node.search(30)) == 30);
-        _ASSERT(*(even_node.search(40)) == 40);
-        _ASSERT(*(even_node.search(50)) == 50);
-        _ASSERT(*(even_node.search(60)) == 60);
-        _ASSERT(even_node.search(70) == nullptr);
-        _ASSERT(*(even_node.search(80)) == 80);
-        _ASSERT(even_node.search(100) == nullptr);
-        _ASSERT(*(even_node.search(110)) == 110);
-        _ASSERT(*(even_node.search(120)) == 120);
+    tester("4. borrowing from the left", [&]{
+        even_tree::internal_type node;
+        make_node(node, {2, 4, 1});
+        node.handle_underflow<false>(tree4, 2);
+        _ASSERT(node.m_key_counter == 3);
+        _ASSERT(leaf_at(node, 1)->m_key_counter == 3);
+        _ASSERT(leaf_at(node, 2)->m_key_counter == 2);
+        _ASSERT(node.m_keys[2] == 130);
+        _ASSERT(*(leaf_at(node, node.child_index(130))->search(130)) == 130);
+        _ASSERT(*(leaf_at(node, node.child_index(200))->search(200)) == 200);
+        node.erase_all(tree4, 1);
+        return passed;
+    });
 
-        _ASSERT(even_node.erase(tree4,200) == false); // never was in the subtree4,
-        _ASSERT(even_node.m_key_counter == 4);
-        _ASSERT(std::get<1>(even_node.m_data)[3]->m_key_counter == 2);
-        _ASSERT(*(even_node.search(0)) == 0);
-        _ASSERT(*(even_node.search(10)) == 10);
-        _ASSERT(*(even_node.search(20)) == 20);
-        _ASSERT(*(even_node.search(30)) == 30);
-        _ASSERT(*(even_node.search(40)) == 40);
-        _ASSERT(*(even_node.search(50)) == 50);
-        _ASSERT(*(even_node.search(60)) == 60);
-        _ASSERT(even_node.search(70) == nullptr);
-        _ASSERT(*(even_node.search(80)) == 80);
-        _ASSERT(even_node.search(100) == nullptr);
-        _ASSERT(*(even_node.search(110)) == 110);
-        _ASSERT(*(even_node.search(120)) == 120);
-        even_node.erase_all(tree4);
+    tester("5. merging with the right", [&]{
+        even_tree::internal_type node;
+        make_node(node, {1, 2, 4});
+        even_tree::leaf_type* last = leaf_at(node, 2);
+        node.handle_underflow<false>(tree4, 0);
+        _ASSERT(node.m_key_counter == 2);
+        _ASSERT(leaf_at(node, 0)->m_key_counter == 3);
+        _ASSERT(leaf_at(node, 0)->m_next == last);
+        _ASSERT(last->m_prev == leaf_at(node, 0));
+        _ASSERT(node.m_keys[1] == 200);
+        for (int key : {0, 100, 110, 200, 230}){
+            _ASSERT(*(leaf_at(node, node.child_index(key))->search(key)) == key);
+        }
+        node.erase_all(tree4, 1);
+        return passed;
+    });
 
-        _ASSERT(even_node.m_key_counter == 0);
-        _ASSERT(even_node.search(-20) == nullptr);
-        _ASSERT(even_node.search(-10) == nullptr);
-        _ASSERT(even_node.search(0) == nullptr);
-        _ASSERT(even_node.search(10) == nullptr);
-        _ASSERT(even_node.search(20) == nullptr);
-        _ASSERT(even_node.search(30) == nullptr);
-        _ASSERT(even_node.search(40) == nullptr);
-        _ASSERT(even_node.search(50) == nullptr);
-        _ASSERT(even_node.search(60) == nullptr);
-        _ASSERT(even_node.search(70) == nullptr);
-        _ASSERT(even_node.search(80) == nullptr);
-        _ASSERT(even_node.search(90) == nullptr);
-        _ASSERT(even_node.search(100) == nullptr);
-        _ASSERT(even_node.search(110) == nullptr);
-        _ASSERT(even_node.search(120) == nullptr);
-        _ASSERT(even_node.search(130) == nullptr);
-        _ASSERT(even_node.search(140) == nullptr);
+    tester("6. merging with the left", [&]{
+        even_tree::internal_type node;
+        make_node(node, {4, 2, 1});
+        node.handle_underflow<false>(tree4, 2);
+        _ASSERT(node.m_key_counter == 2);
+        _ASSERT(leaf_at(node, 1)->m_key_counter == 3);
+        _ASSERT(leaf_at(node, 1)->m_next == nullptr);
+        for (int key : {0, 30, 100, 110, 200}){
+            _ASSERT(*(leaf_at(node, node.child_index(key))->search(key)) == key);
+        }
+        node.erase_all(tree4, 1);
+        return passed;
+    });
 
-        typename csaur::BPlusTree<int,int,5>::node_type* odd_leaf_1 = std::construct_at(tree5.m_node_alloc.allocate(), true);
-        odd_leaf_1->emplace(tree5,-20,-20);
-        odd_leaf_1->emplace(tree5,0,0);
-        odd_leaf_1->emplace(tree5,-10,-10);
-        typename csaur::BPlusTree<int,int,5>::node_type* odd_leaf_2 = std::construct_at(tree5.m_node_alloc.allocate(), true);
-        odd_leaf_2->emplace(tree5,30,30);
-        odd_leaf_2->emplace(tree5,20,20);
-        odd_leaf_2->emplace(tree5,10,10);
-        typename csaur::BPlusTree<int,int,5>::node_type* odd_leaf_3 = std::construct_at(tree5.m_node_alloc.allocate(), true);
-        odd_leaf_3->emplace(tree5,50,50);
-        odd_leaf_3->emplace(tree5,40,40);
-        odd_leaf_3->emplace(tree5,60,60);
-        odd_leaf_3->emplace(tree5,70,70);
-        odd_leaf_3->emplace(tree5,80,80);
-        typename csaur::BPlusTree<int,int,5>::node_type* odd_leaf_4 = std::construct_at(tree5.m_node_alloc.allocate(), true);
-        odd_leaf_4->emplace(tree5,120,120);
-        odd_leaf_4->emplace(tree5,100,100);
-        odd_leaf_4->emplace(tree5,110,110);
-        typename csaur::BPlusTree<int,int,5>::node_type* odd_leaf_5 = std::construct_at(tree5.m_node_alloc.allocate(), true);
-        odd_leaf_5->emplace(tree5,130,130);
-        odd_leaf_5->emplace(tree5,140,140);
-        odd_leaf_5->emplace(tree5,150,150);
-        typename csaur::BPlusTree<int,int,5>::node_type odd_node (false);
-        odd_node.m_key_counter = 5;
-        std::get<1>(odd_node.m_data)[0] = odd_leaf_1;
-        std::get<1>(odd_node.m_data)[1] = odd_leaf_2;
-        std::get<1>(odd_node.m_data)[2] = odd_leaf_3;
-        std::get<1>(odd_node.m_data)[3] = odd_leaf_4;
-        std::get<1>(odd_node.m_data)[4] = odd_leaf_5;
-        odd_node.m_keys[0] = odd_leaf_1->m_keys[0];
-        odd_node.m_keys[1] = odd_leaf_2->m_keys[0];
-        odd_node.m_keys[2] = odd_leaf_3->m_keys[0];
-        odd_node.m_keys[3] = odd_leaf_4->m_keys[0];
-        odd_node.m_keys[4] = odd_leaf_5->m_keys[0];
+    std::cout << "KEY SEARCH TESTS:\n";
+
+    auto key_search_tester = [&]<class Key, class Search = csaur::DefaultSearch>(Key step, Search = {})->const char* {
+        csaur::BPlusLeaf<Key,int,37,Search> leaf;
+        for (int count = 0; count <= 37; ++count){
+            leaf.m_key_counter = count;
+            for (int i = 0; i < count; ++i){
+                leaf.m_keys[i] = Key(i * 2) * step;
+            }
+            leaf.update_layout();
+            for (int probe = -2; probe <= 2 * count + 1; ++probe){
+                Key key = Key(probe) * step;
+                if (std::is_unsigned_v<Key> && probe < 0) continue;
+                auto expected = std::upper_bound(leaf.m_keys.begin(), leaf.m_keys.begin() + count, key) - leaf.m_keys.begin();
+                _ASSERT(leaf.find_smallest_bigger_key_index(key) == (std::size_t)expected);
+            }
+        }
+        return passed;
+    };
 
-        _ASSERT(odd_node.m_key_counter == 5);
-        _ASSERT(*(odd_node.search(-20)) == -20);
-        _ASSERT(*(odd_node.search(-10)) == -10);
-        _ASSERT(*(odd_node.search(0)) == 0);
-        _ASSERT(*(odd_node.search(10)) == 10);
-        _ASSERT(*(odd_node.search(20)) == 20);
-        _ASSERT(*(odd_node.search(30)) == 30);
-        _ASSERT(*(odd_node.search(40)) == 40);
-        _ASSERT(*(odd_node.search(50)) == 50);
-        _ASSERT(*(odd_node.search(60)) == 60);
-        _ASSERT(*(odd_node.search(70)) == 70);
-        _ASSERT(*(odd_node.search(80)) == 80);
-        _ASSERT(*(odd_node.search(100)) == 100);
-        _ASSERT(*(odd_node.search(110)) == 110);
-        _ASSERT(*(odd_node.search(120)) == 120);
-        _ASSERT(*(odd_node.search(130)) == 130);
-        _ASSERT(*(odd_node.search(140)) == 140);
-        _ASSERT(*(odd_node.search(150)) == 150);
+    tester("1. int keys", [&]{return key_search_tester(int(1));});
 
-        _ASSERT(odd_node.erase(tree5,60) == true);
-        _ASSERT(odd_node.m_key_counter == 5);
-        _ASSERT(*(odd_node.search(-20)) == -20);
-        _ASSERT(*(odd_node.search(-10)) == -10);
-        _ASSERT(*(odd_node.search(0)) == 0);
-        _ASSERT(*(odd_node.search(10)) == 10);
-        _ASSERT(*(odd_node.search(20)) == 20);
-        _ASSERT(*(odd_node.search(30)) == 30);
-        _ASSERT(*(odd_node.search(40)) == 40);
-        _ASSERT(*(odd_node.search(50)) == 50);
-        _ASSERT(odd_node.search(60) == nullptr);
-        _ASSERT(*(odd_node.search(70)) == 70);
-        _ASSERT(*(odd_node.search(80)) == 80);
-        _ASSERT(*(odd_node.search(100)) == 100);
-        _ASSERT(*(odd_node.search(110)) == 110);
-        _ASSERT(*(odd_node.search(120)) == 120);
-        _ASSERT(*(odd_node.search(130)) == 130);
-        _ASSERT(*(odd_node.search(140)) == 140);
-        _ASSERT(*(odd_node.search(150)) == 150);
+    tester("2. int64_t keys", [&]{return key_search_tester(std::int64_t(1) << 40);});
 
-        _ASSERT(odd_node.erase(tree5,70) == true);
-        _ASSERT(odd_node.m_key_counter == 5);
-        _ASSERT(*(odd_node.search(-20)) == -20);
-        _ASSERT(*(odd_node.search(-10)) == -10);
-        _ASSERT(*(odd_node.search(0)) == 0);
-        _ASSERT(*(odd_node.search(10)) == 10);
-        _ASSERT(*(odd_node.search(20)) == 20);
-        _ASSERT(*(odd_node.search(30)) == 30);
-        _ASSERT(*(odd_node.search(40)) == 40);
-        _ASSERT(*(odd_node.search(50)) == 50);
-        _ASSERT(odd_node.search(60) == nullptr);
-        _ASSERT(odd_node.search(70) == nullptr);
-        _ASSERT(*(odd_node.search(80)) == 80);
-        _ASSERT(*(odd_node.search(100)) == 100);
-        _ASSERT(*(odd_node.search(110)) == 110);
-        _ASSERT(*(odd_node.search(120)) == 120);
-        _ASSERT(*(odd_node.search(130)) == 130);
-        _ASSERT(*(odd_node.search(140)) == 140);
-        _ASSERT(*(odd_node.search(150)) == 150);
+    tester("3. uint32_t keys", [&]{return key_search_tester(std::uint32_t(1) << 25);});
 
-        _ASSERT(odd_node.erase(tree5,70) == false);
-        _ASSERT(odd_node.m_key_counter == 5);
-        _ASSERT(*(odd_node.search(-20)) == -20);
-        _ASSERT(*(odd_node.search(-10)) == -10);
-        _ASSERT(*(odd_node.search(0)) == 0);
-        _ASSERT(*(odd_node.search(10)) == 10);
-        _ASSERT(*(odd_node.search(20)) == 20);
-        _ASSERT(*(odd_node.search(30)) == 30);
-        _ASSERT(*(odd_node.search(40)) == 40);
-        _ASSERT(*(odd_node.search(50)) == 50);
-        _ASSERT(odd_node.search(60) == nullptr);
-        _ASSERT(odd_node.search(70) == nullptr);
-        _ASSERT(*(odd_node.search(80)) == 80);
-        _ASSERT(*(odd_node.search(100)) == 100);
-        _ASSERT(*(odd_node.search(110)) == 110);
-        _ASSERT(*(odd_node.search(120)) == 120);
-        _ASSERT(*(odd_node.search(130)) == 130);
-        _ASSERT(*(odd_node.search(140)) == 140);
-        _ASSERT(*(odd_node.search(150)) == 150);
+    tester("4. float keys", [&]{return key_search_tester(0.5f);});
 
-        _ASSERT(odd_node.erase(tree5,470) == false);
-        _ASSERT(odd_node.m_key_counter == 5);
-        _ASSERT(*(odd_node.search(-20)) == -20);
-        _ASSERT(*(odd_node.search(-10)) == -10);
-        _ASSERT(*(odd_node.search(0)) == 0);
-        _ASSERT(*(odd_node.search(10)) == 10);
-        _ASSERT(*(odd_node.search(20)) == 20);
-        _ASSERT(*(odd_node.search(30)) == 30);
-        _ASSERT(*(odd_node.search(40)) == 40);
-        _ASSERT(*(odd_node.search(50)) == 50);
-        _ASSERT(odd_node.search(60) == nullptr);
-        _ASSERT(odd_node.search(70) == nullptr);
-        _ASSERT(*(odd_node.search(80)) == 80);
-        _ASSERT(*(odd_node.search(100)) == 100);
-        _ASSERT(*(odd_node.search(110)) == 110);
-        _ASSERT(*(odd_node.search(120)) == 120);
-        _ASSERT(*(odd_node.search(130)) == 130);
-        _ASSERT(*(odd_node.search(140)) == 140);
-        _ASSERT(*(odd_node.search(150)) == 150);
-        odd_node.erase_all(tree5);
+    tester("5. double keys", [&]{return key_search_tester(0.25);});
 
-        _ASSERT(odd_node.m_key_counter == 0);
-        _ASSERT(odd_node.search(-20) == nullptr);
-        _ASSERT(odd_node.search(-10) == nullptr);
-        _ASSERT(odd_node.search(0) == nullptr);
-        _ASSERT(odd_node.search(10) == nullptr);
-        _ASSERT(odd_node.search(20) == nullptr);
-        _ASSERT(odd_node.search(30) == nullptr);
-        _ASSERT(odd_node.search(40) == nullptr);
-        _ASSERT(odd_node.search(50) == nullptr);
-        _ASSERT(odd_node.search(60) == nullptr);
-        _ASSERT(odd_node.search(70) == nullptr);
-        _ASSERT(odd_node.search(80) == nullptr);
-        _ASSERT(odd_node.search(90) == nullptr);
-        _ASSERT(odd_node.search(100) == nullptr);
-        _ASSERT(odd_node.search(110) == nullptr);
-        _ASSERT(odd_node.search(120) == nullptr);
-        _ASSERT(odd_node.search(130) == nullptr);
-        _ASSERT(odd_node.search(140) == nullptr);
+    tester("6. string keys", [&]{
+        csaur::BPlusTree<std::string,int,5> tree;
+        _ASSERT(!csaur::simd_searchable<std::string>);
+        for (int i = 0; i < BPlusTest::num_inserted; ++i){
+            tree.insert(std::to_string(i), i);
+        }
+        for (int i = 0; i < BPlusTest::num_inserted; ++i){
+            _ASSERT(tree.at(std::to_string(i)) == i);
+        }
         return passed;
     });
 
-    tester("6. burrowing from the right", [&]{
-        typename csaur::BPlusTree<int,int,4>::node_type* even_leaf_1 = std::construct_at(tree4.m_node_alloc.allocate(), true);
-        even_leaf_1->emplace(tree4,0,0);
-        even_leaf_1->emplace(tree4,10,10);
-        typename csaur::BPlusTree<int,int,4>::node_type* even_leaf_2 = std::construct_at(tree4.m_node_alloc.allocate(), true);
-        even_leaf_2->emplace(tree4,30,30);
-        even_leaf_2->emplace(tree4,20,20);
-        even_leaf_2->emplace(tree4,40,40);
-        even_leaf_2->emplace(tree4,50,50);
-        typename csaur::BPlusTree<int,int,4>::node_type even_node (false);
-        even_node.m_key_counter = 2;
-        std::get<1>(even_node.m_data)[0] = even_leaf_1;
-        std::get<1>(even_node.m_data)[1] = even_leaf_2;
-        even_node.m_keys[0] = even_leaf_1->m_keys[0];
-        even_node.m_keys[1] = even_leaf_2->m_keys[0];
-
-        _ASSERT(even_node.erase(tree4,10) == true);
-        _ASSERT(even_node.m_key_counter == 2);
-        _ASSERT(even_leaf_1->m_key_counter == 2);
-        _ASSERT(*(std::get<0>(even_leaf_1->m_data)[0]) == 0);
-        _ASSERT(*(std::get<0>(even_leaf_1->m_data)[1]) == 20);
-        _ASSERT(even_leaf_2->m_key_counter == 3);
-        _ASSERT(*(std::get<0>(even_leaf_2->m_data)[0]) == 30);
-        _ASSERT(*(std::get<0>(even_leaf_2->m_data)[1]) == 40);
-        _ASSERT(*(std::get<0>(even_leaf_2->m_data)[2]) == 50);
-        _ASSERT(*(even_node.search(0)) == 0);
-        _ASSERT(even_node.search(10) == nullptr);
-        _ASSERT(*(even_node.search(20)) == 20);
-        _ASSERT(*(even_node.search(30)) == 30);
-        _ASSERT(*(even_node.search(40)) == 40);
-        _ASSERT(*(even_node.search(50)) == 50);
-        even_node.erase_all(tree4);
-
-        typename csaur::BPlusTree<int,int,5>::node_type* odd_leaf_1 = std::construct_at(tree5.m_node_alloc.allocate(), true);
-        odd_leaf_1->emplace(tree5,0,0);
-        odd_leaf_1->emplace(tree5,10,10);
-        odd_leaf_1->emplace(tree5,-10,-10);
-        typename csaur::BPlusTree<int,int,5>::node_type* odd_leaf_2 = std::construct_at(tree5.m_node_alloc.allocate(), true);
-        odd_leaf_2->emplace(tree5,30,30);
-        odd_leaf_2->emplace(tree5,20,20);
-        odd_leaf_2->emplace(tree5,40,40);
-        odd_leaf_2->emplace(tree5,50,50);
-        typename csaur::BPlusTree<int,int,5>::node_type odd_node (false);
-        odd_node.m_key_counter = 2;
-        std::get<1>(odd_node.m_data)[0] = odd_leaf_1;
-        std::get<1>(odd_node.m_data)[1] = odd_leaf_2;
-        odd_node.m_keys[0] = odd_leaf_1->m_keys[0];
-        odd_node.m_keys[1] = odd_leaf_2->m_keys[0];
-
-        _ASSERT(odd_node.erase(tree5,10) == true);
-        _ASSERT(odd_node.m_key_counter == 2);
-        _ASSERT(odd_leaf_1->m_key_counter == 3);
-        _ASSERT(*(std::get<0>(odd_leaf_1->m_data)[0]) == -10);
-        _ASSERT(*(std::get<0>(odd_leaf_1->m_data)[1]) == 0);
-        _ASSERT(*(std::get<0>(odd_leaf_1->m_data)[2]) == 20);
-        _ASSERT(odd_leaf_2->m_key_counter == 3);
-        _ASSERT(*(std::get<0>(odd_leaf_2->m_data)[0]) == 30);
-        _ASSERT(*(std::get<0>(odd_leaf_2->m_data)[1]) == 40);
-        _ASSERT(*(std::get<0>(odd_leaf_2->m_data)[2]) == 50);
-        _ASSERT(*(odd_node.search(-10)) == -10);
-        _ASSERT(*(odd_node.search(0)) == 0);
-        _ASSERT(odd_node.search(10) == nullptr);
-        _ASSERT(*(odd_node.search(20)) == 20);
-        _ASSERT(*(odd_node.search(30)) == 30);
-        _ASSERT(*(odd_node.search(40)) == 40);
-        _ASSERT(*(odd_node.search(50)) == 50);
-        odd_node.erase_all(tree5);
-
+    auto search_policy_tester = [&]<class Search>(Search policy)->const char* {
+        if (key_search_tester(int(1), policy) == failed) return failed;
+        if (key_search_tester(0.25, policy) == failed) return failed;
+        csaur::BPlusTree<std::string,int,5,csaur::DefaultAllocator<int>,csaur::DefaultAllocator<int>,csaur::DefaultAllocator<int>,Search> tree;
+        for (int i = 0; i < BPlusTest::num_inserted; ++i){
+            tree.insert(std::to_string(i), i);
+        }
+        for (int i = 0; i < BPlusTest::num_inserted; i += 2){
+            tree.erase(std::to_string(i));
+        }
+        for (int i = 0; i < BPlusTest::num_inserted; ++i){
+            _ASSERT(tree.contains(std::to_string(i)) == (i % 2 == 1));
+        }
+        auto copied = tree;
+        for (int i = 1; i < BPlusTest::num_inserted; i += 2){
+            _ASSERT(copied.at(std::to_string(i)) == i);
+        }
         return passed;
-    });
-
-    tester("7. burrowing from the left", [&]{
-        typename csaur::BPlusTree<int,int,4>::node_type* even_leaf_1 = std::construct_at(tree4.m_node_alloc.allocate(), true);
-        even_leaf_1->emplace(tree4,0,0);
-        even_leaf_1->emplace(tree4,10,10);
-        even_leaf_1->emplace(tree4,30,30);
-        even_leaf_1->emplace(tree4,20,20);
-        typename csaur::BPlusTree<int,int,4>::node_type* even_leaf_2 = std::construct_at(tree4.m_node_alloc.allocate(), true);
-        even_leaf_2->emplace(tree4,40,40);
-        even_leaf_2->emplace(tree4,50,50);
-        typename csaur::BPlusTree<int,int,4>::node_type* even_leaf_3 = std::construct_at(tree4.m_node_alloc.allocate(), true);
-        even_leaf_3->emplace(tree4,60,60);
-        even_leaf_3->emplace(tree4,70,70);
-        even_leaf_3->emplace(tree4,80,80);
-        typename csaur::BPlusTree<int,int,4>::node_type even_node (false);
-        even_node.m_key_counter = 3;
-        std::get<1>(even_node.m_data)[0] = even_leaf_1;
-        std::get<1>(even_node.m_data)[1] = even_leaf_2;
-        std::get<1>(even_node.m_data)[2] = even_leaf_3;
-        even_node.m_keys[2] = even_leaf_3->m_keys[0];
-        even_node.m_keys[0] = even_leaf_1->m_keys[0];
-        even_node.m_keys[1] = even_leaf_2->m_keys[0];
-
-        _ASSERT(even_node.erase(tree4,40) == true);
-        _ASSERT(even_node.m_key_counter == 3);
-        _ASSERT(even_leaf_1->m_key_counter == 3);
-        _ASSERT(*(std::get<0>(even_leaf_1->m_data)[0]) == 0);
-        _ASSERT(*(std::get<0>(even_leaf_1->m_data)[1]) == 10);
-        _ASSERT(*(std::get<0>(even_leaf_1->m_data)[2]) == 20);
-        _ASSERT(even_leaf_2->m_key_counter == 2);
-        _ASSERT(*(std::get<0>(even_leaf_2->m_data)[0]) == 30);
-        _ASSERT(*(std::get<0>(even_leaf_2->m_data)[1]) == 50);
-        _ASSERT(*(even_node.search(0)) == 0);
-        _ASSERT(*(even_node.search(10)) == 10);
-        _ASSERT(*(even_node.search(20)) == 20);
-        _ASSERT(*(even_node.search(30)) == 30);
-        _ASSERT(even_node.search(40) == nullptr);
-        _ASSERT(*(even_node.search(50)) == 50);
-        even_node.erase_all(tree4);
-
-        typename csaur::BPlusTree<int,int,5>::node_type* odd_leaf_1 = std::construct_at(tree5.m_node_alloc.allocate(), true);
-        odd_leaf_1->emplace(tree5,0,0);
-        odd_leaf_1->emplace(tree5,10,10);
-        odd_leaf_1->emplace(tree5,-10,-10);
-        odd_leaf_1->emplace(tree5,20,20);
-        typename csaur::BPlusTree<int,int,5>::node_type* odd_leaf_2 = std::construct_at(tree5.m_node_alloc.allocate(), true);
-        odd_leaf_2->emplace(tree5,30,30);
-        odd_leaf_2->emplace(tree5,40,40);
-        odd_leaf_2->emplace(tree5,50,50);
-        typename csaur::BPlusTree<int,int,5>::node_type* odd_leaf_3 = std::construct_at(tree5.m_node_alloc.allocate(), true);
-        odd_leaf_3->emplace(tree5,60,60);
-        odd_leaf_3->emplace(tree5,70,70);
-        odd_leaf_3->emplace(tree5,80,80);
-        typename csaur::BPlusTree<int,int,5>::node_type odd_node (false);
-        odd_node.m_key_counter = 3;
-        std::get<1>(odd_node.m_data)[0] = odd_leaf_1;
-        std::get<1>(odd_node.m_data)[1] = odd_leaf_2;
-        std::get<1>(odd_node.m_data)[2] = odd_leaf_3;
-        odd_node.m_keys[2] = odd_leaf_3->m_keys[0];
-        odd_node.m_keys[0] = odd_leaf_1->m_keys[0];
-        odd_node.m_keys[1] = odd_leaf_2->m_keys[0];
-
-        _ASSERT(odd_node.erase(tree5,40) == true);
-        _ASSERT(odd_node.m_key_counter == 3);
-        _ASSERT(odd_leaf_1->m_key_counter == 3);
-        _ASSERT(*(std::get<0>(odd_leaf_1->m_data)[0]) == -10);
-        _ASSERT(*(std::get<0>(odd_leaf_1->m_data)[1]) == 0);
-        _ASSERT(*(std::get<0>(odd_leaf_1->m_data)[2]) == 10);
-        _ASSERT(odd_leaf_2->m_key_counter == 3);
-        _ASSERT(*(std::get<0>(odd_leaf_2->m_data)[0]) == 20);
-        _ASSERT(*(std::get<0>(odd_leaf_2->m_data)[1]) == 30);
-        _ASSERT(*(std::get<0>(odd_leaf_2->m_data)[2]) == 50);
-        _ASSERT(*(odd_node.search(-10)) == -10);
-        _ASSERT(*(odd_node.search(0)) == 0);
-        _ASSERT(*(odd_node.search(10)) == 10);
-        _ASSERT(*(odd_node.search(20)) == 20);
-        _ASSERT(*(odd_node.search(30)) == 30);
-        _ASSERT(odd_node.search(40) == nullptr);
-        _ASSERT(*(odd_node.search(50)) == 50);
-        odd_node.erase_all(tree5);
-
+    };
+
+    tester("7. binary search policy", [&]{return search_policy_tester(csaur::BinarySearch{});});
+
+    tester("8. branchless search policy", [&]{return search_policy_tester(csaur::BranchlessSearch{});});
+
+    tester("9. eytzinger search policy", [&]{return search_policy_tester(csaur::EytzingerSearch{});});
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+    auto simd_search_tester = []<class Key>(Key)->const char* {
+        using limits = std::numeric_limits<Key>;
+        std::vector<Key> values = {limits::lowest(), Key(limits::lowest() + Key(1)), Key(-1), Key(0), Key(1),
+                                   Key(limits::max() / Key(2)), Key(limits::max() / Key(2) + Key(1)), Key(limits::max() - Key(1)), limits::max()};
+        if constexpr(std::is_integral_v<Key>){ // both sides of the sign bit, which the unsigned bias flips
+            values.push_back(Key(std::make_unsigned_t<Key>(1) << (8 * sizeof(Key) - 1)));
+            values.push_back(Key((std::make_unsigned_t<Key>(1) << (8 * sizeof(Key) - 1)) - 1));
+        }
+        else{
+            values.push_back(limits::infinity());
+            values.push_back(-limits::infinity());
+            values.push_back(limits::denorm_min());
+            values.push_back(Key(-0.0));
+        }
+        std::sort(values.begin(), values.end());
+        std::vector<Key> keys;
+        for (Key value : values){ // every value twice, so that runs of equal keys cross vector boundaries
+            keys.push_back(value);
+            keys.push_back(value);
+        }
+        for (std::size_t count = 0; count <= keys.size(); ++count){
+            for (Key probe : values){
+                auto expected = std::upper_bound(keys.begin(), keys.begin() + count, probe) - keys.begin();
+                _ASSERT(csaur::simd_upper_bound(keys.data(), count, probe) == (std::size_t)expected);
+            }
+        }
         return passed;
+    };
+
+    tester("10. vectorized search at the limits of every key type", [&]{
+        _ASSERT(csaur::simd_searchable<int> && csaur::simd_searchable<double>);
+        if (simd_search_tester(int()) == failed) return failed;
+        if (simd_search_tester(unsigned()) == failed) return failed;
+        if (simd_search_tester(std::int64_t()) == failed) return failed;
+        if (simd_search_tester(std::uint64_t()) == failed) return failed;
+        if (simd_search_tester(float()) == failed) return failed;
+        return simd_search_tester(double());
     });
-
-    tester("8. merging with the right", [&]{
-        typename csaur::BPlusTree<int,int,4>::node_type* even_leaf_1 = std::construct_at(tree4.m_node_alloc.allocate(), true);
-        even_leaf_1->emplace(tree4,0,0);
-        even_leaf_1->emplace(tree4,10,10);
-        typename csaur::BPlusTree<int,int,4>::node_type* even_leaf_2 = std::construct_at(tree4.m_node_alloc.allocate(), true);
-        even_leaf_2->emplace(tree4,30,30);
-        even_leaf_2->emplace(tree4,20,20);
-        typename csaur::BPlusTree<int,int,4>::node_type even_node (false);
-        even_node.m_key_counter = 2;
-        std::get<1>(even_node.m_data)[0] = even_leaf_1;
-        std::get<1>(even_node.m_data)[1] = even_leaf_2;
-        even_node.m_keys[0] = even_leaf_1->m_keys[0];
-        even_node.m_keys[1] = even_leaf_2->m_keys[0];
-
-        _ASSERT(even_node.erase(tree4,10) == true);
-        _ASSERT(even_node.m_key_counter == 1);
-        _ASSERT(even_leaf_1->m_key_counter == 3);
-        _ASSERT(*(std::get<0>(even_leaf_1->m_data)[0]) == 0);
-        _ASSERT(*(std::get<0>(even_leaf_1->m_data)[1]) == 20);
-        _ASSERT(*(std::get<0>(even_leaf_1->m_data)[2]) == 30);
-        _ASSERT(*(even_node.search(0)) == 0);
-        _ASSERT(even_node.search(10) == nullptr);
-        _ASSERT(*(even_node.search(20)) == 20);
-        _ASSERT(*(even_node.search(30)) == 30);
-        even_node.erase_all(tree4);
-
-        typename csaur::BPlusTree<int,int,5>::node_type* odd_leaf_1 = std::construct_at(tree5.m_node_alloc.allocate(), true);
-        odd_leaf_1->emplace(tree5,0,0);
-        odd_leaf_1->emplace(tree5,10,10);
-        odd_leaf_1->emplace(tree5,-10,-10);
-        typename csaur::BPlusTree<int,int,5>::node_type* odd_leaf_2 = std::construct_at(tree5.m_node_alloc.allocate(), true);
-        odd_leaf_2->emplace(tree5,30,30);
-        odd_leaf_2->emplace(tree5,20,20);
-        odd_leaf_2->emplace(tree5,40,40);
-        typename csaur::BPlusTree<int,int,5>::node_type odd_node (false);
-        odd_node.m_key_counter = 2;
-        std::get<1>(odd_node.m_data)[0] = odd_leaf_1;
-        std::get<1>(odd_node.m_data)[1] = odd_leaf_2;
-        odd_node.m_keys[0] = odd_leaf_1->m_keys[0];
-        odd_node.m_keys[1] = odd_leaf_2->m_keys[0];
-
-        _ASSERT(odd_node.erase(tree5,10) == true);
-        _ASSERT(odd_node.m_key_counter == 1);
-        _ASSERT(odd_leaf_1->m_key_counter == 5);
-        _ASSERT(*(std::get<0>(odd_leaf_1->m_data)[0]) == -10);
-        _ASSERT(*(std::get<0>(odd_leaf_1->m_data)[1]) == 0);
-        _ASSERT(*(std::get<0>(odd_leaf_1->m_data)[2]) == 20);
-        _ASSERT(*(std::get<0>(odd_leaf_1->m_data)[3]) == 30);
-        _ASSERT(*(std::get<0>(odd_leaf_1->m_data)[4]) == 40);
-        _ASSERT(*(odd_node.search(-10)) == -10);
-        _ASSERT(*(odd_node.search(0)) == 0);
-        _ASSERT(odd_node.search(10) == nullptr);
-        _ASSERT(*(odd_node.search(20)) == 20);
-        _ASSERT(*(odd_node.search(30)) == 30);
-        _ASSERT(*(odd_node.search(40)) == 40);
-        odd_node.erase_all(tree5);
-
+#endif
+
+    std::cout << "TREE SHAPE TESTS:\n";
+
+    tester("1. height and leaf chain", [&]{
+        csaur::BPlusTree<int,int,3> tree;
+        _ASSERT(tree.m_height == 0);
+        for (int i = 0; i < BPlusTest::num_inserted; ++i){
+            tree.insert(i, i);
+        }
+        _ASSERT(tree.m_height > 1);
+        int expected = 0;
+        for (auto leaf = tree.m_min; leaf != nullptr; leaf = leaf->m_next){
+            _ASSERT(leaf == tree.m_max || leaf->m_key_counter >= decltype(tree)::node_type::min_keys);
+            for (std::size_t i = 0; i < leaf->m_key_counter; ++i){
+                _ASSERT(leaf->m_keys[i] == expected++);
+            }
+            _ASSERT(leaf->m_next != nullptr || leaf == tree.m_max);
+        }
+        _ASSERT(expected == BPlusTest::num_inserted);
+        for (int i = 0; i < BPlusTest::num_inserted; ++i){
+            tree.erase(i);
+        }
+        _ASSERT(tree.m_height == 0);
+        _ASSERT(tree.m_root == tree.m_min && tree.m_root == tree.m_max);
         return passed;
     });
 
-    tester("9. merging with the left", [&]{
-        typename csaur::BPlusTree<int,int,4>::node_type* even_leaf_1 = std::construct_at(tree4.m_node_alloc.allocate(), true);
-        even_leaf_1->emplace(tree4,0,0);
-        even_leaf_1->emplace(tree4,10,10);
-        even_leaf_1->emplace(tree4,30,30);
-        typename csaur::BPlusTree<int,int,4>::node_type* even_leaf_2 = std::construct_at(tree4.m_node_alloc.allocate(), true);
-        even_leaf_2->emplace(tree4,40,40);
-        even_leaf_2->emplace(tree4,50,50);
-        typename csaur::BPlusTree<int,int,4>::node_type* even_leaf_3 = std::construct_at(tree4.m_node_alloc.allocate(), true);
-        even_leaf_3->emplace(tree4,60,60);
-        even_leaf_3->emplace(tree4,70,70);
-        even_leaf_3->emplace(tree4,80,80);
-        typename csaur::BPlusTree<int,int,4>::node_type even_node (false);
-        even_node.m_key_counter = 3;
-        std::get<1>(even_node.m_data)[0] = even_leaf_1;
-        std::get<1>(even_node.m_data)[1] = even_leaf_2;
-        std::get<1>(even_node.m_data)[2] = even_leaf_3;
-        even_node.m_keys[2] = even_leaf_3->m_keys[0];
-        even_node.m_keys[0] = even_leaf_1->m_keys[0];
-        even_node.m_keys[1] = even_leaf_2->m_keys[0];
-
-        _ASSERT(even_node.erase(tree4,40) == true);
-        _ASSERT(even_node.m_key_counter == 2);
-        _ASSERT(std::get<1>(even_node.m_data)[0] == even_leaf_1);
-        _ASSERT(std::get<1>(even_node.m_data)[1] == even_leaf_3);
-        _ASSERT(even_leaf_1->m_key_counter == 4);
-        _ASSERT(*(std::get<0>(even_leaf_1->m_data)[0]) == 0);
-        _ASSERT(*(std::get<0>(even_leaf_1->m_data)[1]) == 10);
-        _ASSERT(*(std::get<0>(even_leaf_1->m_data)[2]) == 30);
-        _ASSERT(*(std::get<0>(even_leaf_1->m_data)[3]) == 50);
-        _ASSERT(even_leaf_3->m_key_counter == 3);
-        _ASSERT(*(std::get<0>(even_leaf_3->m_data)[0]) == 60);
-        _ASSERT(*(std::get<0>(even_leaf_3->m_data)[1]) == 70);
-        _ASSERT(*(std::get<0>(even_leaf_3->m_data)[2]) == 80);
-        _ASSERT(*(even_node.search(0)) == 0);
-        _ASSERT(*(even_node.search(10)) == 10);
-        _ASSERT(*(even_node.search(30)) == 30);
-        _ASSERT(even_node.search(40) == nullptr);
-        _ASSERT(*(even_node.search(50)) == 50);
-        even_node.erase_all(tree4);
-
-        typename csaur::BPlusTree<int,int,5>::node_type* odd_leaf_1 = std::construct_at(tree5.m_node_alloc.allocate(), true);
-        odd_leaf_1->emplace(tree5,0,0);
-        odd_leaf_1->emplace(tree5,10,10);
-        odd_leaf_1->emplace(tree5,20,20);
-        typename csaur::BPlusTree<int,int,5>::node_type* odd_leaf_2 = std::construct_at(tree5.m_node_alloc.allocate(), true);
-        odd_leaf_2->emplace(tree5,30,30);
-        odd_leaf_2->emplace(tree5,40,40);
-        odd_leaf_2->emplace(tree5,50,50);
-        typename csaur::BPlusTree<int,int,5>::node_type* odd_leaf_3 = std::construct_at(tree5.m_node_alloc.allocate(), true);
-        odd_leaf_3->emplace(tree5,60,60);
-        odd_leaf_3->emplace(tree5,70,70);
-        odd_leaf_3->emplace(tree5,80,80);
-        typename csaur::BPlusTree<int,int,5>::node_type odd_node (false);
-        odd_node.m_key_counter = 3;
-        std::get<1>(odd_node.m_data)[0] = odd_leaf_1;
-        std::get<1>(odd_node.m_data)[1] = odd_leaf_2;
-        std::get<1>(odd_node.m_data)[2] = odd_leaf_3;
-        odd_node.m_keys[2] = odd_leaf_3->m_keys[0];
-        odd_node.m_keys[0] = odd_leaf_1->m_keys[0];
-        odd_node.m_keys[1] = odd_leaf_2->m_keys[0];
-
-        _ASSERT(odd_node.erase(tree5,50) == true);
-        _ASSERT(odd_node.m_key_counter == 2);
-        _ASSERT(std::get<1>(odd_node.m_data)[0] == odd_leaf_1);
-        _ASSERT(std::get<1>(odd_node.m_data)[1] == odd_leaf_3);
-        _ASSERT(odd_leaf_1->m_key_counter == 5);
-        _ASSERT(*(std::get<0>(odd_leaf_1->m_data)[0]) == 0);
-        _ASSERT(*(std::get<0>(odd_leaf_1->m_data)[1]) == 10);
-        _ASSERT(*(std::get<0>(odd_leaf_1->m_data)[2]) == 20);
-        _ASSERT(*(std::get<0>(odd_leaf_1->m_data)[3]) == 30);
-        _ASSERT(*(std::get<0>(odd_leaf_1->m_data)[4]) == 40);
-        _ASSERT(odd_leaf_3->m_key_counter == 3);
-        _ASSERT(*(std::get<0>(odd_leaf_3->m_data)[0]) == 60);
-        _ASSERT(*(std::get<0>(odd_leaf_3->m_data)[1]) == 70);
-        _ASSERT(*(std::get<0>(odd_leaf_3->m_data)[2]) == 80);
-        _ASSERT(*(odd_node.search(0)) == 0);
-        _ASSERT(*(odd_node.search(10)) == 10);
-        _ASSERT(*(odd_node.search(20)) == 20);
-        _ASSERT(*(odd_node.search(30)) == 30);
-        _ASSERT(*(odd_node.search(40)) == 40);
-        _ASSERT(odd_node.search(50) == nullptr);
-        odd_node.erase_all(tree5);
-
+    tester("2. copies", [&]{
+        csaur::BPlusTree<int,std::string,3> tree;
+        for (int i = 0; i < BPlusTest::num_inserted; ++i){
+            tree.insert(i, std::to_string(i));
+        }
+        csaur::BPlusTree<int,std::string,3> copied(tree), assigned;
+        assigned = copied;
+        tree.erase_all();
+        for (int i = 0; i < BPlusTest::num_inserted; ++i){
+            _ASSERT(copied.at(i) == std::to_string(i));
+            _ASSERT(assigned.at(i) == std::to_string(i));
+        }
+        _ASSERT(copied.min_key() == 0 && copied.max_key() == BPlusTest::num_inserted - 1);
+        _ASSERT(assigned.size() == (std::size_t)BPlusTest::num_inserted);
+        csaur::BPlusTree<int,std::string,3> moved(std::move(copied));
+        _ASSERT(copied.is_empty());
+        _ASSERT(moved.at(7) == "7");
         return passed;
     });
 }
@@ -0,0 +1,181 @@
+#include "BPlusTest.hpp"
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+void BPlusTest::test_shards()
+{
+    using entries_type = std::vector<std::pair<int,std::string>>;
+
+    // checks that every shard only holds keys of its range
+    auto shards_valid = [&]<class Tree>(const Tree& tree)->bool {
+        for (std::size_t s = 0; s < tree.m_shards.size(); ++s){
+            const auto& shard = tree.m_shards[s]->m_tree;
+            if (!shard.is_empty() && ((s > 0 && shard.min_key() < tree.m_bounds[s - 1]) || (s < tree.m_bounds.size() && !(shard.max_key() < tree.m_bounds[s])))){
+                return false;
+            }
+        }
+        return tree.m_shards.size() == tree.m_bounds.size() + 1 && std::is_sorted(tree.m_bounds.begin(), tree.m_bounds.end());
+    };
+
+    tester("1. single and batch operations see the shards as one map", [&](){
+        csaur::ShardedBPlusTree<int,std::string,4> tree({100, 200, 300}, 2);
+        std::map<int,std::string> model;
+        _ASSERT(matches_model({
+            .insert = [&](int key, std::size_t step){ return tree.insert(int(key), std::to_string(step)); },
+            .assign = {},
+            .erase = [&](int key, std::size_t){ return tree.erase(key); },
+            .get = [&](int key){ return tree.get(key); },
+            .size = [&](){ return tree.size(); }
+        }, model, 26, 2000, 400));
+        // batches spread over every shard, and may repeat keys
+        std::mt19937 random(26);
+        for (int i = 0; i < 200; ++i){
+            std::vector<std::pair<int,std::string>> batch;
+            std::vector<int> keys;
+            std::size_t expected = 0;
+            for (int j = 0; j < 20; ++j){
+                int key = random() % 400;
+                batch.emplace_back(key, std::to_string(i));
+                expected += model.emplace(key, std::to_string(i)).second;
+                keys.push_back(random() % 400);
+            }
+            _ASSERT(tree.multi_insert(batch) == expected && tree.size() == model.size());
+            std::vector<std::optional<std::string>> results(keys.size(), "stale");
+            std::size_t found = tree.multi_get(keys, results);
+            expected = 0;
+            for (std::size_t j = 0; j < keys.size(); ++j){
+                expected += model.contains(keys[j]);
+                _ASSERT(results[j] == (model.contains(keys[j]) ? std::optional<std::string>(model[keys[j]]) : std::nullopt));
+                _ASSERT(tree.contains(keys[j]) == results[j].has_value());
+            }
+            _ASSERT(found == expected);
+            for (int j = 0; j < 10; ++j){
+                int key = random() % 400;
+                _ASSERT(tree.erase(key) == (model.erase(key) == 1));
+            }
+        }
+        entries_type entries;
+        tree.for_each([&](const int& key, const std::string& mapped){ entries.emplace_back(key, mapped); });
+        _ASSERT(entries == entries_type(model.begin(), model.end()) && shards_valid(tree));
+        bool thrown = false;
+        try{
+            csaur::ShardedBPlusTree<int,int,4> unordered({5, 5});
+        }
+        catch(const std::invalid_argument&){
+            thrown = true;
+        }
+        _ASSERT(thrown);
+        return passed;
+    });
+
+    tester("2. a hot shard hands half of its keys to its quieter neighbour", [&](){
+        csaur::ShardedBPlusTree<int,int,4> tree({1000, 2000}, 1);
+        for (int key = 0; key < 3000; ++key){
+            tree.insert(int(key), int(key));
+        }
+        _ASSERT(!tree.rebalance());                         // the load was even
+        for (int round = 0; round < 3; ++round){
+            for (int i = 0; i < 5000; ++i){
+                tree.get(2990 + i % 10);
+            }
+            _ASSERT(tree.rebalance());
+            _ASSERT(tree.shard_count() == 3 && shards_valid(tree) && tree.size() == 3000);
+        }
+        // the last shard kept moving its lower half to the middle one, split at its median
+        auto bounds = tree.bounds();
+        _ASSERT(bounds[0] == 1000 && bounds[1] == 2875 && tree.m_shards[2]->m_tree.size() == 125);
+        // the first shard has a single neighbour, and an empty one takes half of it just as well
+        csaur::ShardedBPlusTree<int,int,4> edges({-1});
+        for (int key = 0; key < 100; ++key){
+            edges.insert(int(key), int(key));
+        }
+        _ASSERT(edges.rebalance() && edges.bounds()[0] > 0 && edges.m_shards[0]->m_tree.size() > 0 && shards_valid(edges));
+        for (int key = 0; key < 100; ++key){
+            _ASSERT(edges.get(key) == key);
+        }
+        return passed;
+    });
+
+    tester("3. threads write through single and batch operations while the shards are rebalanced", [&](){
+        constexpr int threads_count = 4, per_thread = 20000;
+        csaur::ShardedBPlusTree<int,int,8> tree({20000, 40000, 60000}, 3);
+        std::atomic<bool> valid = true, done = false;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threads_count; ++t){
+            threads.emplace_back([&, t](){
+                std::vector<std::pair<int,int>> batch;
+                // each thread owns the keys equal to it modulo threads_count, and writes them in ascending order, so
+                // the shard every thread is busy with moves from the first to the last
+                for (int i = 0; i < per_thread; ++i){
+                    int key = i * threads_count + t;
+                    if (i % 2 == 0){
+                        valid = valid && tree.insert(int(key), int(key));
+                    }
+                    else{
+                        batch.emplace_back(key, key);
+                    }
+                    if (batch.size() == 64 || i + 1 == per_thread){
+                        valid = valid && tree.multi_insert(batch) == batch.size();
+                        batch.clear();
+                    }
+                }
+            });
+        }
+        threads.emplace_back([&](){
+            while (!done){
+                tree.rebalance();
+                std::this_thread::yield();
+            }
+        });
+        for (int t = 0; t < threads_count; ++t){
+            threads[t].join();
+        }
+        done = true;
+        threads.back().join();
+        _ASSERT(valid && tree.size() == (std::size_t)threads_count * per_thread && shards_valid(tree) && tree.shard_count() == 4);
+        std::vector<int> keys;
+        for (int t = 0; t < threads_count; ++t){
+            for (int i = 0; i < per_thread; ++i){
+                keys.push_back(i * threads_count + t);
+            }
+        }
+        std::vector<std::optional<int>> results(keys.size());
+        _ASSERT(tree.multi_get(keys, results) == keys.size());
+        for (std::size_t i = 0; i < keys.size(); ++i){
+            _ASSERT(results[i] == keys[i]);
+        }
+        return passed;
+    });
+
+    tester("4. a batch submitted while the workers are busy runs on its submitter instead of waiting", [&](){
+        csaur::ThreadPool pool(1);
+        std::atomic<bool> started = false, finished = false;
+        std::thread busy([&](){
+            pool.for_each_task(2, [&](std::size_t){
+                started = true;
+                // holds the batch until the other one is done, or long enough to tell that it waited
+                for (int i = 0; i < 10000 && !finished; ++i){
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            });
+        });
+        while (!started){
+            std::this_thread::yield();
+        }
+        std::thread::id runner;
+        std::size_t ran = 0;
+        pool.for_each_task(3, [&](std::size_t){
+            runner = std::this_thread::get_id();
+            ++ran;
+        });
+        finished = true;
+        busy.join();
+        _ASSERT(ran == 3 && runner == std::this_thread::get_id());
+        return passed;
+    });
+}
@@ -0,0 +1,194 @@
+#include "BPlusTest.hpp"
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+void BPlusTest::test_snapshots()
+{
+    using entries_type = std::vector<std::pair<int,std::string>>;
+
+    // checks that keys are sorted in every node, that every key lies between the separators above it, and that
+    // every node but the root holds at least min_keys entries
+    auto structure_valid = [&]<class Tree>(const Tree& tree)->bool {
+        std::size_t entries = 0;
+        auto check = [&](auto& self, const typename Tree::node_type* node, std::size_t height, const int* lo, const int* hi, bool is_root)->bool {
+            if ((!is_root && node->m_key_counter < Tree::node_type::min_keys) || node->m_references.load() == 0
+                || !std::is_sorted(node->m_keys.begin(), node->m_keys.begin() + node->m_key_counter)){
+                return false;
+            }
+            if (height == 0){
+                entries += node->m_key_counter;
+                for (std::size_t i = 0; i < node->m_key_counter; ++i){
+                    if ((lo && node->m_keys[i] < *lo) || (hi && !(node->m_keys[i] < *hi))){
+                        return false;
+                    }
+                }
+                return true;
+            }
+            auto internal = static_cast<const typename Tree::internal_type*>(node);
+            for (std::size_t i = 0; i < internal->m_key_counter; ++i){
+                const int* sub_hi = (i + 1 == internal->m_key_counter) ? hi : &internal->m_keys[i + 1];
+                if (!self(self, internal->m_data[i], height - 1, &internal->m_keys[i], sub_hi, false)){
+                    return false;
+                }
+            }
+            return true;
+        };
+        return check(check, tree.m_root, tree.m_height, nullptr, nullptr, true) && entries == tree.size();
+    };
+
+    // collects the nodes of a tree
+    auto nodes_of = [&]<class Tree>(const Tree& tree){
+        std::set<const void*> nodes;
+        auto collect = [&](auto& self, const typename Tree::node_type* node, std::size_t height)->void {
+            nodes.insert(node);
+            if (height != 0){
+                auto internal = static_cast<const typename Tree::internal_type*>(node);
+                for (std::size_t i = 0; i < internal->m_key_counter; ++i){
+                    self(self, internal->m_data[i], height - 1);
+                }
+            }
+        };
+        collect(collect, tree.m_root, tree.m_height);
+        return nodes;
+    };
+
+    tester("1. the tree behaves as a map", [&](){
+        csaur::SnapshotBPlusTree<int,std::string,3> tree;
+        std::map<int,std::string> model;
+        _ASSERT(matches_model({
+            .insert = [&](int key, std::size_t step){ return tree.insert(int(key), std::to_string(step)); },
+            .assign = [&](int key, std::size_t step){ return tree.insert_or_assign(int(key), std::to_string(step)); },
+            .erase = [&](int key, std::size_t){ return tree.erase(key); },
+            .get = [&](int key){ return tree.contains(key) ? std::optional<std::string>(*tree.find(key)) : std::nullopt; },
+            .size = [&](){ return tree.size(); }
+        }, model, 23, 20000, 300));
+        _ASSERT(structure_valid(tree));
+        entries_type entries;
+        tree.for_each([&](const int& key, const std::string& mapped){ entries.emplace_back(key, mapped); });
+        _ASSERT(entries == entries_type(model.begin(), model.end()));
+        for (int key = 0; key < 300; ++key){
+            tree.erase(key);
+        }
+        _ASSERT(tree.is_empty() && tree.m_height == 0);
+        return passed;
+    });
+
+    tester("2. snapshots keep the entries the tree had when they were taken", [&](){
+        csaur::SnapshotBPlusTree<int,std::string,4> tree;
+        std::map<int,std::string> model;
+        std::vector<std::pair<decltype(tree.snapshot()), std::map<int,std::string>>> snapshots;
+        std::mt19937 random(11);
+        for (int i = 0; i < 30000; ++i){
+            int key = random() % 1000;
+            if (random() % 3 == 0){
+                tree.erase(key);
+                model.erase(key);
+            }
+            else{
+                tree.insert_or_assign(int(key), std::to_string(i));
+                model[key] = std::to_string(i);
+            }
+            if (i % 3000 == 0){
+                snapshots.emplace_back(tree.snapshot(), model);
+            }
+        }
+        snapshots.erase(snapshots.begin(), snapshots.begin() + 4);      // releasing some of them on the way
+        for (auto& [snapshot, expected] : snapshots){
+            entries_type entries;
+            snapshot.for_each([&](const int& key, const std::string& mapped){ entries.emplace_back(key, mapped); });
+            _ASSERT(snapshot.size() == expected.size() && entries == entries_type(expected.begin(), expected.end()));
+            std::vector<int> keys;
+            snapshot.for_each_in_range(250, 500, [&](const int& key, const std::string&){ keys.push_back(key); });
+            _ASSERT((int)keys.size() == std::distance(expected.lower_bound(250), expected.lower_bound(500)));
+            for (int key = 0; key < 1000; key += 7){
+                _ASSERT(expected.contains(key) ? (snapshot.find(key) && *snapshot.find(key) == expected[key]) : !snapshot.contains(key));
+            }
+        }
+        _ASSERT(structure_valid(tree));
+        return passed;
+    });
+
+    tester("3. a write after a snapshot copies only the nodes on its path", [&](){
+        csaur::SnapshotBPlusTree<int,std::string,4> tree;
+        for (int i = 0; i < 5000; ++i){
+            tree.insert(int(i), std::to_string(i));
+        }
+        auto snapshot = tree.snapshot();
+        auto shared = nodes_of(tree);
+        _ASSERT(snapshot.m_root == tree.m_root && tree.m_root->m_references == 2);
+        tree.insert_or_assign(2500, "changed");
+        tree.erase(100);
+        tree.insert(5000, "new");
+        std::size_t copied = 0;
+        for (const void* node : nodes_of(tree)){
+            copied += !shared.contains(node);
+        }
+        _ASSERT(copied > 0 && copied <= 3 * (tree.m_height + 2));
+        _ASSERT(*snapshot.find(2500) == "2500" && snapshot.contains(100) && !snapshot.contains(5000));
+        _ASSERT(*tree.find(2500) == "changed" && !tree.contains(100) && tree.contains(5000));
+        _ASSERT(snapshot.size() == 5000 && tree.size() == 5000 && structure_valid(tree));
+        // searches and failed writes copy nothing
+        auto before = nodes_of(tree);
+        auto again = tree.snapshot();
+        _ASSERT(!tree.insert(0, "0") && !tree.erase(-1) && tree.contains(0) && nodes_of(tree) == before);
+        return passed;
+    });
+
+    tester("4. snapshots are read and released by other threads while the tree is written to", [&](){
+        constexpr int readers = 3, keys = 2000;
+        csaur::SnapshotBPlusTree<int,std::string,8> tree;
+        for (int i = 0; i < keys; ++i){
+            tree.insert(int(i), "0");
+        }
+        // every round maps every key to the same value before a snapshot is taken, so a snapshot holds a single value
+        std::vector<decltype(tree.snapshot())> mailbox;
+        std::mutex mutex;
+        std::atomic<bool> valid = true, done = false;
+        std::vector<std::thread> threads;
+        for (int r = 0; r < readers; ++r){
+            threads.emplace_back([&](){
+                for (;;){
+                    std::unique_lock lock(mutex);
+                    if (mailbox.empty()){
+                        lock.unlock();
+                        if (done){
+                            return;
+                        }
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    auto snapshot = std::move(mailbox.back());
+                    mailbox.pop_back();
+                    lock.unlock();
+                    std::set<std::string> values;
+                    std::size_t count = 0;
+                    snapshot.for_each([&](const int&, const std::string& mapped){ values.insert(mapped); ++count; });
+                    valid = valid && values.size() == 1 && count == snapshot.size() && snapshot.size() == keys;
+                }                                   // the snapshot is released here, while the tree is written to
+            });
+        }
+        for (int i = 1; i <= 200; ++i){
+            for (int key = 0; key < keys; ++key){
+                tree.insert_or_assign(int(key), std::to_string(i));
+            }
+            tree.erase(i);
+            tree.insert(int(i), std::to_string(i));
+            std::lock_guard lock(mutex);
+            if (mailbox.size() < readers){
+                mailbox.push_back(tree.snapshot());
+            }
+        }
+        done = true;
+        for (auto& thread : threads){
+            thread.join();
+        }
+        _ASSERT(valid && mailbox.empty() && tree.size() == keys && structure_valid(tree) && tree.m_root->m_references == 1);
+        return passed;
+    });
+}
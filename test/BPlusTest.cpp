@@ -1,9 +1,48 @@
 #include "BPlusTest.hpp"
+#include <random>
+#include <vector>
 
 void BPlusTest::tester(const char* const name, std::function<const char* const ()> func) {
     std::cout << name << func();
 }
 
+bool BPlusTest::matches_model(const MapOperations& ops, std::map<int,std::string>& model, unsigned seed, std::size_t steps, int key_range)
+{
+    using operation_type = bool (*)(const MapOperations&, std::map<int,std::string>&, int, std::size_t);
+    std::vector<operation_type> operations;
+    if (ops.insert){
+        operations.push_back([](const MapOperations& ops, std::map<int,std::string>& model, int key, std::size_t step){
+            return ops.insert(key, step) == model.emplace(key, std::to_string(step)).second;
+        });
+    }
+    if (ops.assign){
+        operations.push_back([](const MapOperations& ops, std::map<int,std::string>& model, int key, std::size_t step){
+            bool added = !model.contains(key);
+            model[key] = std::to_string(step);
+            return ops.assign(key, step) == added;
+        });
+    }
+    if (ops.erase){
+        operations.push_back([](const MapOperations& ops, std::map<int,std::string>& model, int key, std::size_t step){
+            return ops.erase(key, step) == (model.erase(key) == 1);
+        });
+    }
+    if (ops.get){
+        operations.push_back([](const MapOperations& ops, std::map<int,std::string>& model, int key, std::size_t){
+            auto found = model.find(key);
+            return ops.get(key) == (found != model.end() ? std::optional<std::string>(found->second) : std::nullopt);
+        });
+    }
+    std::mt19937 random(seed);
+    for (std::size_t step = 1; step <= steps; ++step){
+        int key = random() % key_range;
+        if (!operations[random() % operations.size()](ops, model, key, step) || ops.size() != model.size()){
+            return false;
+        }
+    }
+    return true;
+}
+
 void BPlusTest::operator()()
 {
     std::cout << "TESTING INTERNAL NODE STRUCTURE\n";
@@ -12,4 +51,18 @@ void BPlusTest::operator()()
     test_crud();
     std::cout << "TESTING OBSERVERS\n";
     test_observers();
+    std::cout << "TESTING ITERATORS\n";
+    test_iterators();
+    std::cout << "TESTING AUGMENTATIONS\n";
+    test_augmentations();
+    std::cout << "TESTING MULTIMAPS\n";
+    test_multimap();
+    std::cout << "TESTING CONCURRENCY\n";
+    test_concurrency();
+    std::cout << "TESTING SNAPSHOTS\n";
+    test_snapshots();
+    std::cout << "TESTING VERSIONS\n";
+    test_versions();
+    std::cout << "TESTING SHARDS\n";
+    test_shards();
 }
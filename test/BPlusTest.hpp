@@ -5,9 +5,17 @@
 class BPlusTest;
 
 #include "../src/BPlusTree.hpp"
+#include "../src/BPlusMultiTree.hpp"
+#include "../src/ConcurrentBPlusTree.hpp"
+#include "../src/SnapshotBPlusTree.hpp"
+#include "../src/VersionedBPlusTree.hpp"
+#include "../src/ShardedBPlusTree.hpp"
 #include <cassert>
 #include <iostream>
 #include <functional>
+#include <map>
+#include <optional>
+#include <string>
 
 const char* const failed = " - FAILED\n";
 const char* const passed = " - PASSED\n";
@@ -58,6 +66,44 @@ class BPlusTest{
     /// @brief Tests the correctness of behaviour of size and is_empty
     void test_observers();
 
+    /// @brief Tests the correctness of behaviour of iterators and range queries.
+    void test_iterators();
+
+    /// @brief Tests the correctness of behaviour of subtree augmentations and the queries they enable.
+    void test_augmentations();
+
+    /// @brief Tests the correctness of behaviour of trees whose keys may repeat.
+    void test_multimap();
+
+    /// @brief Tests the correctness of behaviour of concurrent trees, from one thread and from many.
+    void test_concurrency();
+
+    /// @brief Tests the correctness of behaviour of copy-on-write trees and their snapshots.
+    void test_snapshots();
+
+    /// @brief Tests the correctness of behaviour of multiversioned trees, their views and their garbage collection.
+    void test_versions();
+
+    /// @brief Tests the correctness of behaviour of sharded trees, from one thread and from many, and their rebalancing.
+    void test_shards();
+
+    /// @brief The operations of a map from int to std::string that a model check runs. Each takes the key and the
+    ///        step it runs at, which the check maps to `std::to_string(step)`, and which trees that stamp their writes
+    ///        take as the timestamp. Writes return whether the key was new, and erase whether it was there. An empty
+    ///        operation is left out of the check.
+    struct MapOperations{
+        std::function<bool (int key, std::size_t step)> insert;
+        std::function<bool (int key, std::size_t step)> assign;
+        std::function<bool (int key, std::size_t step)> erase;
+        std::function<std::optional<std::string> (int key)> get;
+        std::function<std::size_t ()> size;
+    };
+
+    /// @brief Auxiliary testing function, runs random operations on the keys in [0, key_range) on a tree and on a
+    ///        std::map model of it, one per step, counting from 1.
+    /// @return Whether every result and the size after every step matched the model.
+    static bool matches_model(const MapOperations& ops, std::map<int,std::string>& model, unsigned seed, std::size_t steps, int key_range);
+
     /// @brief Auxiliary testing function, prints the name and the output of the function.
     /// @param name The name of the test.
     /// @param func The test itself, returns a c-string.
@@ -0,0 +1,172 @@
+#include "BPlusTest.hpp"
+#include <climits>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+void BPlusTest::test_versions()
+{
+    using entries_type = std::vector<std::pair<int,std::string>>;
+    using history_type = std::map<std::uint64_t, std::map<int,std::string>>;
+
+    // collects the entries a tree had at a timestamp
+    auto entries_at = [&](const auto& tree, std::uint64_t read_ts){
+        entries_type entries;
+        tree.for_each_in_range(INT_MIN, INT_MAX, read_ts, [&](const int& key, const std::string& mapped){ entries.emplace_back(key, mapped); });
+        return entries;
+    };
+
+    tester("1. reads at the latest commit see the tree as a map", [&](){
+        csaur::VersionedBPlusTree<int,std::string,4> tree;
+        std::map<int,std::string> model;
+        _ASSERT(matches_model({
+            .insert = {},
+            .assign = [&](int key, std::size_t step){ return tree.insert_or_assign(int(key), std::to_string(step), step); },
+            .erase = [&](int key, std::size_t step){ return tree.erase(key, step); },
+            .get = [&](int key){ return tree.contains(key) ? std::optional<std::string>(*tree.get(key)) : std::nullopt; },
+            .size = [&](){ return tree.size(); }
+        }, model, 25, 20000, 300));
+        // without views open, every chain is cut down to one version, and erased keys leave the tree
+        _ASSERT(tree.version_count() == model.size() && tree.m_tree.size() == model.size());
+        _ASSERT(entries_at(tree, tree.now()) == entries_type(model.begin(), model.end()));
+        _ASSERT(tree.horizon() == tree.now());
+        return passed;
+    });
+
+    tester("2. views read the tree as it was at their timestamp", [&](){
+        csaur::VersionedBPlusTree<int,std::string,5> tree;
+        std::map<int,std::string> model;
+        history_type history;
+        std::vector<decltype(tree.read_view(0))> views;
+        std::mt19937 random(7);
+        for (std::uint64_t ts = 1; ts <= 30000; ++ts){
+            // a few writes share a timestamp, as those of one transaction would
+            std::uint64_t commit = ts - ts % 3;
+            int key = random() % 500;
+            if (random() % 4 == 0){
+                tree.erase(key, commit);
+                model.erase(key);
+            }
+            else{
+                tree.insert_or_assign(int(key), std::to_string(ts), commit);
+                model[key] = std::to_string(ts);
+            }
+            if (ts % 3 == 2 && commit % 300 == 0){
+                history[commit] = model;
+            }
+            if (ts % 3 == 2 && commit % 2400 == 0){
+                views.push_back(tree.read_view(commit));
+            }
+        }
+        views.erase(views.begin(), views.begin() + 4);          // closing the oldest ones on the way
+        tree.collect_garbage();
+        _ASSERT(tree.horizon() == views.front().timestamp());
+        for (auto& view : views){
+            auto& expected = history[view.timestamp()];
+            _ASSERT(entries_at(tree, view.timestamp()) == entries_type(expected.begin(), expected.end()));
+            std::vector<int> keys;
+            view.for_each_in_range(100, 200, [&](const int& key, const std::string&){ keys.push_back(key); });
+            _ASSERT((int)keys.size() == std::distance(expected.lower_bound(100), expected.lower_bound(200)));
+            for (int key = 0; key < 500; key += 3){
+                _ASSERT(expected.contains(key) ? (view.get(key) && *view.get(key) == expected[key]) : !view.get(key));
+            }
+        }
+        // reads between the views are served too, as long as they are not before the horizon
+        auto middle = history.lower_bound(views.back().timestamp() - 1000);
+        _ASSERT(entries_at(tree, middle->first) == entries_type(middle->second.begin(), middle->second.end()));
+        bool thrown = false;
+        try{
+            tree.get(0, tree.horizon() - 1);
+        }
+        catch(const std::out_of_range&){
+            thrown = true;
+        }
+        _ASSERT(thrown);
+        return passed;
+    });
+
+    tester("3. versions no view can read are collected", [&](){
+        csaur::VersionedBPlusTree<int,std::string,4> tree;
+        for (int key = 0; key < 1000; ++key){
+            tree.insert_or_assign(int(key), "0", 1);
+        }
+        std::uint64_t ts = 1;
+        {
+            auto view = tree.read_view(ts);
+            for (int round = 1; round <= 5; ++round){
+                ++ts;
+                for (int key = 0; key < 1000; ++key){
+                    if (key % 2 == 0){
+                        tree.insert_or_assign(int(key), std::to_string(round), ts);
+                    }
+                    else{
+                        if (!tree.erase(key, ts)){
+                            tree.insert_or_assign(int(key), std::to_string(round), ts);
+                        }
+                    }
+                }
+            }
+            // the view keeps the version at its timestamp, and every later one
+            _ASSERT(tree.version_count() == 6000 && tree.collect_garbage() == 0 && tree.horizon() == 1);
+            _ASSERT(entries_at(tree, 1).size() == 1000 && *view.get(999) == "0" && !tree.contains(999));
+        }
+        // a bounded sweep frees the chains of as many keys as it is given, and resumes where it stopped
+        _ASSERT(tree.collect_garbage(100) == 50 * 5 + 50 * 6 && tree.horizon() == ts);
+        std::size_t released = 50 * 5 + 50 * 6;
+        while (tree.version_count() != tree.size()){
+            released += tree.collect_garbage(64);
+        }
+        _ASSERT(released == 5500 && tree.size() == 500 && tree.m_tree.size() == 500);
+        _ASSERT(entries_at(tree, ts).size() == 500 && *tree.get(998) == "5");
+        return passed;
+    });
+
+    tester("4. writes out of order and views of the future are rejected", [&](){
+        csaur::VersionedBPlusTree<int,int,4> tree;
+        tree.insert_or_assign(1, 1, 10);
+        bool write_thrown = false, view_thrown = false;
+        try{
+            tree.insert_or_assign(2, 2, 9);
+        }
+        catch(const std::invalid_argument&){
+            write_thrown = true;
+        }
+        try{
+            tree.read_view(11);
+        }
+        catch(const std::invalid_argument&){
+            view_thrown = true;
+        }
+        _ASSERT(write_thrown && view_thrown && tree.now() == 10 && tree.size() == 1 && !tree.contains(2));
+        _ASSERT(!tree.erase(2, 10) && tree.erase(1, 10) && tree.is_empty() && tree.version_count() == 0);
+        return passed;
+    });
+
+    tester("5. writes at the timestamp of an open view are rejected", [&](){
+        csaur::VersionedBPlusTree<int,std::string,4> tree;
+        tree.insert_or_assign(1, "a", 5);
+        int rejected = 0;
+        {
+            auto view = tree.read_view(tree.now());
+            const std::string* read = view.get(1);
+            for (auto write : {std::function<void ()>([&](){ tree.insert_or_assign(1, "b", 5); }),
+                               std::function<void ()>([&](){ tree.insert_or_assign(2, "c", 5); }),
+                               std::function<void ()>([&](){ tree.erase(1, 5); })}){
+                try{
+                    write();
+                }
+                catch(const std::invalid_argument&){
+                    ++rejected;
+                }
+            }
+            _ASSERT(rejected == 3 && view.get(1) == read && *read == "a" && view.get(2) == nullptr);
+            _ASSERT(tree.erase(1, 6) && *view.get(1) == "a" && tree.get(1) == nullptr);
+        }
+        // once the view is closed, writes of one transaction may share a timestamp again
+        tree.insert_or_assign(1, "d", 7);
+        tree.insert_or_assign(1, "e", 7);
+        _ASSERT(*tree.get(1) == "e" && tree.version_count() == 1);
+        return passed;
+    });
+}